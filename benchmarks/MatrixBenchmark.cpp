@@ -0,0 +1,175 @@
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "fmt/core.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/type_ptr.hpp"
+#include "math/MatrixBatch.hpp"
+
+namespace {
+    constexpr std::size_t batch_size = 4096;
+    constexpr std::size_t repetitions = 2000;
+
+    // keeps the optimizer from discarding results nobody reads
+    template <typename T>
+    void doNotOptimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const T *sink = &value;
+        (void)sink;
+#endif
+    }
+
+    template <typename Function>
+    double measure(Function &&function) {
+        // best of several runs, the minimum is the least noisy estimate on a busy machine
+        double best = std::numeric_limits<double>::max();
+
+        for (int run = 0; run < 5; ++run) {
+            const auto start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < repetitions; ++i) {
+                function();
+            }
+            const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            best = std::min(best, elapsed / static_cast<double>(repetitions * batch_size));
+        }
+
+        return best;
+    }
+
+    void report(const char *name, double math_ns, double glm_ns) { fmt::print("{:<24} math {:>7.2f} ns   glm {:>7.2f} ns   x{:.2f}\n", name, math_ns, glm_ns, glm_ns / math_ns); }
+
+    // glm is column-major and math::Matrix row-major, the same transform has transposed storage
+    math::Matrix4f fromGlm(const glm::mat4 &matrix) {
+        math::Matrix4f result;
+        for (std::size_t row = 0; row < 4; ++row) {
+            for (std::size_t col = 0; col < 4; ++col) {
+                result(row, col) = matrix[static_cast<glm::length_t>(col)][static_cast<glm::length_t>(row)];
+            }
+        }
+        return result;
+    }
+
+    bool agrees(const math::Matrix4f &lhs, const glm::mat4 &rhs) {
+        const auto converted = fromGlm(rhs);
+        for (std::size_t i = 0; i < math::Matrix4f::size(); ++i) {
+            if (std::abs(lhs.first()[i] - converted.first()[i]) > 1e-3f * (1.0f + std::abs(converted.first()[i]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+}  // namespace
+
+int main() {
+    fmt::print("instruction set: {}, {} elements per batch\n\n", math::simd::instruction_set, batch_size);
+
+    auto rng = std::mt19937(42);
+    auto distribution = std::uniform_real_distribution<float>(-1.0f, 1.0f);
+
+    std::vector<glm::mat4> glm_lhs(batch_size), glm_rhs(batch_size), glm_out(batch_size);
+    std::vector<glm::vec4> glm_points(batch_size), glm_points_out(batch_size);
+
+    for (std::size_t i = 0; i < batch_size; ++i) {
+        for (glm::length_t col = 0; col < 4; ++col) {
+            for (glm::length_t row = 0; row < 4; ++row) {
+                glm_lhs[i][col][row] = distribution(rng);
+                glm_rhs[i][col][row] = distribution(rng);
+            }
+            glm_points[i][col] = distribution(rng);
+        }
+        // keeps every matrix comfortably invertible
+        glm_lhs[i] += glm::mat4(4.0f);
+    }
+
+    std::vector<math::Matrix4f> lhs(batch_size), rhs(batch_size), out(batch_size);
+    std::vector<math::Vector4f> points(batch_size), points_out(batch_size);
+
+    for (std::size_t i = 0; i < batch_size; ++i) {
+        lhs[i] = fromGlm(glm_lhs[i]);
+        rhs[i] = fromGlm(glm_rhs[i]);
+        points[i] = math::Vector4f({glm_points[i].x, glm_points[i].y, glm_points[i].z, glm_points[i].w});
+    }
+
+    if (!agrees(lhs[0] * rhs[0], glm_lhs[0] * glm_rhs[0]) || !agrees(math::inverse(lhs[0]), glm::inverse(glm_lhs[0]))) {
+        fmt::print(stderr, "math::Matrix and glm disagree\n");
+        return EXIT_FAILURE;
+    }
+
+    report(
+        "multiply",
+        measure([&] {
+            math::multiply(lhs, rhs, out);
+            doNotOptimize(out.data());
+        }),
+        measure([&] {
+            for (std::size_t i = 0; i < batch_size; ++i) {
+                glm_out[i] = glm_lhs[i] * glm_rhs[i];
+            }
+            doNotOptimize(glm_out.data());
+        }));
+
+    report(
+        "multiply by one matrix",
+        measure([&] {
+            math::multiply(lhs[0], rhs, out);
+            doNotOptimize(out.data());
+        }),
+        measure([&] {
+            for (std::size_t i = 0; i < batch_size; ++i) {
+                glm_out[i] = glm_lhs[0] * glm_rhs[i];
+            }
+            doNotOptimize(glm_out.data());
+        }));
+
+    report(
+        "transpose",
+        measure([&] {
+            for (std::size_t i = 0; i < batch_size; ++i) {
+                out[i] = math::transpose(lhs[i]);
+            }
+            doNotOptimize(out.data());
+        }),
+        measure([&] {
+            for (std::size_t i = 0; i < batch_size; ++i) {
+                glm_out[i] = glm::transpose(glm_lhs[i]);
+            }
+            doNotOptimize(glm_out.data());
+        }));
+
+    report(
+        "inverse",
+        measure([&] {
+            for (std::size_t i = 0; i < batch_size; ++i) {
+                out[i] = math::inverse(lhs[i]);
+            }
+            doNotOptimize(out.data());
+        }),
+        measure([&] {
+            for (std::size_t i = 0; i < batch_size; ++i) {
+                glm_out[i] = glm::inverse(glm_lhs[i]);
+            }
+            doNotOptimize(glm_out.data());
+        }));
+
+    report(
+        "transform points",
+        measure([&] {
+            math::transform(lhs[0], points, points_out);
+            doNotOptimize(points_out.data());
+        }),
+        measure([&] {
+            for (std::size_t i = 0; i < batch_size; ++i) {
+                glm_points_out[i] = glm_lhs[0] * glm_points[i];
+            }
+            doNotOptimize(glm_points_out.data());
+        }));
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,454 @@
+#include <vendor/stb_image.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "fmt/core.h"
+#include "io/MeshFile.hpp"
+#include "math/Matrix.hpp"
+#include "renderer/Device.hpp"
+#include "renderer/Instance.hpp"
+#include "renderer/graphics/DescriptorSetLayout.hpp"
+#include "renderer/graphics/Framebuffer.hpp"
+#include "renderer/graphics/GraphicsPipeline.hpp"
+#include "renderer/graphics/PipelineRegistry.hpp"
+#include "renderer/graphics/RenderPass.hpp"
+#include "renderer/graphics/Renderer.hpp"
+#include "renderer/graphics/Shader.hpp"
+#include "renderer/graphics/ShaderLibrary.hpp"
+#include "renderer/graphics/ressources/Buffer.hpp"
+#include "renderer/graphics/ressources/DecriptorSet.hpp"
+#include "renderer/graphics/ressources/DescriptorPool.hpp"
+#include "renderer/graphics/ressources/Image.hpp"
+#include "renderer/graphics/ressources/Mesh.hpp"
+#include "renderer/sync/CommandBuffer.hpp"
+#include "renderer/sync/CommandPool.hpp"
+
+// Renders offscreen without a window, so it runs on CI against a software implementation, e.g. lavapipe:
+//   VK_DRIVER_FILES=/usr/share/vulkan/icd.d/lvp_icd.x86_64.json ./renderer_benchmark --json results.json
+// The pipelines are built from vert.spv and frag.spv, looked up in the working directory like the engine does.
+namespace {
+    constexpr VkExtent2D target_extent = {256, 256};
+    constexpr VkFormat color_format = VK_FORMAT_R8G8B8A8_UNORM;
+
+    struct Options {
+        std::string json_path;
+        std::string texture_path = "artistic.jpeg";
+        bool validation = false;
+    };
+
+    struct Result {
+        std::string name;
+        double ns = 0.0;
+    };
+
+    std::vector<Result> results;
+
+    // keeps the optimizer from discarding results nobody reads
+    template <typename T>
+    void doNotOptimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const T *sink = &value;
+        (void)sink;
+#endif
+    }
+
+    // nanoseconds per item, best of several runs of repetitions calls processing items each
+    template <typename Function>
+    double measure(std::size_t repetitions, std::size_t items, Function &&function) {
+        // one untimed call so that lazily created objects and driver caches are warm
+        function();
+
+        double best = std::numeric_limits<double>::max();
+        for (int run = 0; run < 5; ++run) {
+            const auto start = std::chrono::steady_clock::now();
+            for (std::size_t i = 0; i < repetitions; ++i) {
+                function();
+            }
+            const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            best = std::min(best, elapsed / static_cast<double>(repetitions * items));
+        }
+
+        return best;
+    }
+
+    void report(std::string name, double ns) {
+        if (ns >= 1e6) {
+            fmt::print("{:<40} {:>10.3f} ms\n", name, ns / 1e6);
+        } else if (ns >= 1e3) {
+            fmt::print("{:<40} {:>10.3f} us\n", name, ns / 1e3);
+        } else {
+            fmt::print("{:<40} {:>10.1f} ns\n", name, ns);
+        }
+
+        results.push_back(Result{std::move(name), ns});
+    }
+
+    void skip(std::string_view name, std::string_view reason) { fmt::print("{:<40} skipped, {}\n", name, reason); }
+
+    // a grid of quads in the [-1, 1] square, resolution * resolution vertices must fit in 16 bit indices
+    std::pair<std::vector<Vertex>, std::vector<std::uint16_t>> makeGrid(std::uint32_t resolution) {
+        std::vector<Vertex> vertices;
+        vertices.reserve(resolution * resolution);
+
+        for (std::uint32_t y = 0; y < resolution; ++y) {
+            for (std::uint32_t x = 0; x < resolution; ++x) {
+                const auto u = static_cast<float>(x) / static_cast<float>(resolution - 1);
+                const auto v = static_cast<float>(y) / static_cast<float>(resolution - 1);
+                vertices.push_back(Vertex{.position = {u * 2.f - 1.f, v * 2.f - 1.f, 0.f}, .color = {u, v, 1.f}});
+            }
+        }
+
+        std::vector<std::uint16_t> indices;
+        indices.reserve((resolution - 1) * (resolution - 1) * 6);
+
+        for (std::uint32_t y = 0; y + 1 < resolution; ++y) {
+            for (std::uint32_t x = 0; x + 1 < resolution; ++x) {
+                const auto corner = static_cast<std::uint16_t>(y * resolution + x);
+                const auto below = static_cast<std::uint16_t>(corner + resolution);
+
+                indices.insert(indices.end(), {corner, static_cast<std::uint16_t>(corner + 1), below, static_cast<std::uint16_t>(corner + 1),
+                                               static_cast<std::uint16_t>(below + 1), below});
+            }
+        }
+
+        return {std::move(vertices), std::move(indices)};
+    }
+
+    std::shared_ptr<DescriptorSetLayout> createSetLayout(const std::shared_ptr<Device> &device) {
+        // the layout of the engine's default pipeline
+        std::vector<ShaderResource> shaderResources;
+        shaderResources.emplace_back(0, ShaderResourceType::BUFFER_UNIFORM, 1, ShaderStage::VERTEX_SHADER, ShaderResourceMode::STATIC, "camera");
+        shaderResources.emplace_back(1, ShaderResourceType::BUFFER_STORAGE, 1, ShaderStage::VERTEX_SHADER, ShaderResourceMode::STATIC, "objects");
+
+        return std::make_shared<DescriptorSetLayout>(device, shaderResources);
+    }
+
+    // color and depth attachments with the render pass and framebuffer drawing into them
+    struct OffscreenTarget {
+        explicit OffscreenTarget(const std::shared_ptr<Device> &device)
+            : color(device, target_extent, color_format, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT),
+              depth(device, target_extent, device->findDepthFormat(), VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT),
+              render_pass(std::make_shared<RenderPass>(device, color_format, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, depth.getFormat())),
+              framebuffer(device, *render_pass, std::array{color.getImageView(), depth.getImageView()}, target_extent) {}
+
+        Image color;
+        Image depth;
+        std::shared_ptr<RenderPass> render_pass;
+        Framebuffer framebuffer;
+    };
+
+    PipelineDesc createPipelineDesc(const OffscreenTarget &target, const std::shared_ptr<DescriptorSetLayout> &layout) {
+        PipelineDesc desc{};
+        desc.vertex_input = Vertex::getVertexInputDescription();
+        desc.render_pass = target.render_pass;
+        desc.descriptor_set_layout = layout;
+
+        return desc;
+    }
+
+    void benchmarkDrawSubmission(const std::shared_ptr<Device> &device, const std::shared_ptr<ShaderLibrary> &shader_library) {
+        const auto target = OffscreenTarget(device);
+        const auto layout = createSetLayout(device);
+
+        auto registry = PipelineRegistry(device, target_extent, shader_library);
+        const auto pipeline = registry.get(createPipelineDesc(target, layout));
+
+        constexpr std::array<std::uint32_t, 2> mesh_counts = {1000, 10000};
+        constexpr auto max_meshes = mesh_counts.back();
+
+        auto camera = Buffer::createUniformBuffer(sizeof(CameraData), device);
+        camera.update(CameraData{glm::mat4(1.f), glm::mat4(1.f)});
+
+        auto objects = Buffer::createStorageBuffer(max_meshes * sizeof(math::Matrix4f), device);
+        const auto identities = std::vector<math::Matrix4f>(max_meshes, math::Matrix4f::identity());
+        objects.write(std::as_bytes(std::span(identities)));
+
+        const auto pool = std::make_shared<DescriptorPool>(device, *layout, 1);
+        const auto set = DescriptorSet(device, pool, layout);
+        set.update(0, camera);
+        set.update(1, objects);
+
+        // every draw has its own buffers, like distinct meshes of a scene
+        auto vertices = GraphicsPipeline::defaultMeshRectangleVertices();
+        auto indices = GraphicsPipeline::defaultMeshRectangleIndices();
+
+        std::vector<Mesh> meshes;
+        meshes.reserve(max_meshes);
+        for (std::uint32_t i = 0; i < max_meshes; ++i) {
+            meshes.emplace_back(DrawPrimitive::RECTANGLE, device, vertices, indices);
+        }
+
+        const std::array<VkClearValue, 2> clearValues = {VkClearValue{.color = {{0.f, 0.f, 0.f, 1.f}}}, VkClearValue{.depthStencil = {1.f, 0}}};
+
+        const auto record = [&](const CommandBuffer &cmd, std::uint32_t count) {
+            target.render_pass->begin(cmd, target.framebuffer, clearValues);
+
+            pipeline->bind(cmd);
+            set.bind(*pipeline, cmd);
+
+            for (std::uint32_t i = 0; i < count; ++i) {
+                meshes[i].bind(cmd);
+                vkCmdDrawIndexed(cmd.getCommandBuffer(), meshes[i].getIndexCount(), 1, meshes[i].getFirstIndex(), meshes[i].getVertexOffset(), i);
+            }
+
+            target.render_pass->end(cmd);
+        };
+
+        auto commandPool = CommandPool(device, QueueFamilyType::GRAPHICS);
+        const auto cmd = CommandBuffer(commandPool.acquireCommandBuffer());
+
+        for (const auto count : mesh_counts) {
+            report(fmt::format("record {} draws, per draw", count), measure(20, count, [&] {
+                       cmd.reset();
+                       cmd.begin();
+                       record(cmd, count);
+                       cmd.end();
+                   }));
+
+            // recording, submission and execution of the whole frame, waited on
+            report(fmt::format("submit {} draws, per frame", count), measure(10, 1, [&] { device->immediateSubmit([&](const CommandBuffer &frame) { record(frame, count); }); }));
+        }
+
+        commandPool.releaseCommandBuffer(cmd.getCommandBuffer());
+    }
+
+    void benchmarkUniformUpdate(const std::shared_ptr<Device> &device) {
+        auto camera = Buffer::createUniformBuffer(sizeof(CameraData), device);
+        auto data = CameraData{glm::mat4(1.f), glm::mat4(1.f)};
+
+        report("ubo update", measure(100000, 1, [&] {
+                   data.view[3][0] += 1.f;
+                   camera.update(data);
+               }));
+    }
+
+    void benchmarkDescriptorAllocation(const std::shared_ptr<Device> &device) {
+        constexpr std::uint32_t set_count = 64;
+
+        const auto layout = createSetLayout(device);
+        const auto pool = std::make_shared<DescriptorPool>(device, *layout, set_count);
+
+        const auto camera = Buffer::createUniformBuffer(sizeof(CameraData), device);
+        const auto objects = Buffer::createStorageBuffer(sizeof(math::Matrix4f), device);
+
+        std::vector<DescriptorSet> sets;
+        sets.reserve(set_count);
+
+        report("descriptor set allocation", measure(200, set_count, [&] {
+                   sets.clear();
+                   pool->resetPools();
+
+                   for (std::uint32_t i = 0; i < set_count; ++i) {
+                       sets.emplace_back(device, pool, layout);
+                   }
+               }));
+
+        report("descriptor set allocation + update", measure(200, set_count, [&] {
+                   sets.clear();
+                   pool->resetPools();
+
+                   for (std::uint32_t i = 0; i < set_count; ++i) {
+                       const auto &set = sets.emplace_back(device, pool, layout);
+                       set.update(0, camera);
+                       set.update(1, objects);
+                   }
+               }));
+    }
+
+    void benchmarkMeshUpload(const std::shared_ptr<Device> &device) {
+        auto quadVertices = GraphicsPipeline::defaultMeshRectangleVertices();
+        auto quadIndices = GraphicsPipeline::defaultMeshRectangleIndices();
+
+        report("mesh upload, quad", measure(50, 1, [&] {
+                   const auto mesh = Mesh(DrawPrimitive::RECTANGLE, device, quadVertices, quadIndices);
+                   doNotOptimize(mesh);
+               }));
+
+        auto [gridVertices, gridIndices] = makeGrid(256);
+        report(fmt::format("mesh upload, {} vertices", gridVertices.size()), measure(10, 1, [&] {
+                   const auto mesh = Mesh(DrawPrimitive::TRIANGLE, device, gridVertices, gridIndices);
+                   doNotOptimize(mesh);
+               }));
+
+        // the same grid with the 12 bytes vertices of sprites instead of 24
+        std::vector<SpriteVertex> spriteVertices;
+        spriteVertices.reserve(gridVertices.size());
+        for (const auto &vertex : gridVertices) {
+            spriteVertices.push_back(SpriteVertex{.position = glm::vec2(vertex.position), .color = SpriteVertex::packColor(glm::vec4(vertex.color, 1.f))});
+        }
+
+        report(fmt::format("mesh upload, {} sprite vertices", spriteVertices.size()), measure(10, 1, [&] {
+                   const auto mesh = Mesh(DrawPrimitive::TRIANGLE, device, spriteVertices, gridIndices);
+                   doNotOptimize(mesh);
+               }));
+
+        // quantized to 16 bytes with a normal, the cost of quantizing is measured with the upload
+        report(fmt::format("mesh upload, {} quantized vertices", gridVertices.size()), measure(10, 1, [&] {
+                   const auto mesh = Mesh::quantized(DrawPrimitive::TRIANGLE, device, gridVertices, gridIndices, VertexQuantization::SNORM16);
+                   doNotOptimize(mesh);
+               }));
+
+        // the same grid cooked to a mesh file, the page cache is warm after the untimed call so this measures the copies
+        std::vector<MeshFileAttribute> attributes;
+        for (const auto &attribute : Vertex::getVertexInputDescription().attributes) {
+            attributes.push_back(MeshFileAttribute{.location = attribute.location, .format = static_cast<std::uint32_t>(attribute.format), .offset = attribute.offset});
+        }
+
+        const auto path = (std::filesystem::temp_directory_path() / "renderer_benchmark_grid.vmsh").string();
+        writeMeshFile(
+            path, MeshFileData{
+                      .vertex_stride = sizeof(Vertex),
+                      .attributes = attributes,
+                      .vertices = std::as_bytes(std::span(gridVertices)),
+                      .indices = std::as_bytes(std::span(gridIndices)),
+                  });
+
+        report(fmt::format("mesh file load, {} vertices", gridVertices.size()), measure(10, 1, [&] {
+                   const auto mesh = Mesh::load(device, path);
+                   doNotOptimize(mesh);
+               }));
+
+        std::filesystem::remove(path);
+    }
+
+    void benchmarkTexture(const std::shared_ptr<Device> &device, const std::string &path) {
+        if (!std::filesystem::exists(path)) {
+            skip("texture decode", fmt::format("{} not found", path));
+            return;
+        }
+
+        report("texture decode", measure(5, 1, [&] {
+                   int width = 0, height = 0, channels = 0;
+                   stbi_uc *pixels = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+                   doNotOptimize(pixels);
+                   stbi_image_free(pixels);
+               }));
+
+        report("texture decode + upload", measure(5, 1, [&] {
+                   const auto image = Image(device, path);
+                   doNotOptimize(image.getImage());
+               }));
+    }
+
+    void benchmarkPipelineCreation(const std::shared_ptr<Device> &device, const std::shared_ptr<ShaderLibrary> &shader_library) {
+        const auto target = OffscreenTarget(device);
+        const auto layout = createSetLayout(device);
+        const auto desc = createPipelineDesc(target, layout);
+
+        VkPipelineCacheCreateInfo pipelineCacheInfo{};
+        pipelineCacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+
+        VkPipelineCache pipelineCache = nullptr;
+        if (vkCreatePipelineCache(device->getDevice(), &pipelineCacheInfo, nullptr, &pipelineCache) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create pipeline cache!");
+        }
+
+        const auto create = [&](VkPipelineCache cache) {
+            auto info = GraphicsPipeline::PipelineInfo(device, target_extent, shader_library, desc);
+            info.pipeline_cache = cache;
+
+            const auto pipeline = GraphicsPipeline(std::move(info));
+            doNotOptimize(pipeline.getPipeline());
+        };
+
+        // the shader modules are loaded by the untimed call, only the pipeline compilation is measured
+        report("pipeline creation, no cache", measure(10, 1, [&] { create(nullptr); }));
+        report("pipeline creation, warm cache", measure(10, 1, [&] { create(pipelineCache); }));
+
+        vkDestroyPipelineCache(device->getDevice(), pipelineCache, nullptr);
+    }
+
+    void writeJson(const std::string &path, std::string_view device_name) {
+        auto file = std::ofstream(path);
+        if (!file) {
+            throw std::runtime_error("failed to open the benchmark output file!");
+        }
+
+        file << fmt::format("{{\n  \"device\": \"{}\",\n  \"results\": [\n", device_name);
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            file << fmt::format("    {{\"name\": \"{}\", \"ns\": {:.3f}}}{}\n", results[i].name, results[i].ns, i + 1 < results.size() ? "," : "");
+        }
+        file << "  ]\n}\n";
+    }
+
+    Options parseOptions(int argc, char **argv) {
+        Options options;
+
+        for (int i = 1; i < argc; ++i) {
+            const auto argument = std::string_view(argv[i]);
+
+            if (argument == "--json" && i + 1 < argc) {
+                options.json_path = argv[++i];
+            } else if (argument == "--texture" && i + 1 < argc) {
+                options.texture_path = argv[++i];
+            } else if (argument == "--validation") {
+                options.validation = true;
+            } else {
+                throw std::runtime_error(fmt::format("unknown argument {}, usage: [--json path] [--texture path] [--validation]", argument));
+            }
+        }
+
+        return options;
+    }
+}  // namespace
+
+int main(int argc, char **argv) {
+    try {
+        const auto options = parseOptions(argc, argv);
+
+        // the layers would dominate every measurement, they are only enabled to debug the benchmarks themselves
+        auto instance = std::make_shared<Instance>("renderer benchmark", options.validation);
+
+        {
+            auto device = std::make_shared<Device>(instance);
+            const std::string deviceName = device->getProperties().deviceName;
+            fmt::print("device: {}\n\n", deviceName);
+
+            auto shaderLibrary = std::make_shared<ShaderLibrary>(device);
+
+            // a failing benchmark, e.g. without the shaders, doesn't prevent the others from running
+            // every resource is destroyed through the deletion queue, it is flushed once the device is idle after each benchmark
+            const auto run = [&](std::string_view name, auto &&benchmark) {
+                try {
+                    benchmark();
+                } catch (const std::exception &e) {
+                    skip(name, e.what());
+                }
+
+                vkDeviceWaitIdle(device->getDevice());
+                DeletionQueue::flush();
+            };
+
+            run("draw submission", [&] { benchmarkDrawSubmission(device, shaderLibrary); });
+            run("ubo update", [&] { benchmarkUniformUpdate(device); });
+            run("descriptor allocation", [&] { benchmarkDescriptorAllocation(device); });
+            run("mesh upload", [&] { benchmarkMeshUpload(device); });
+            run("texture", [&] { benchmarkTexture(device, options.texture_path); });
+            run("pipeline creation", [&] { benchmarkPipelineCreation(device, shaderLibrary); });
+
+            if (!options.json_path.empty()) {
+                writeJson(options.json_path, deviceName);
+            }
+
+            shaderLibrary.reset();
+        }
+    } catch (const std::exception &e) {
+        fmt::print(stderr, "[exception] : {}\n", e.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,46 @@
+#version 450
+
+layout(binding = 0) uniform Camera {
+    mat4 view;
+    mat4 proj;
+} camera;
+
+// math::Matrix is row-major, glsl defaults to column-major
+layout(std430, row_major, binding = 1) readonly buffer Objects {
+    mat4 world[];
+} objects;
+
+// maps the positions from [-1, 1] over the box they were quantized in back to model space
+layout(push_constant) uniform Dequantization {
+    vec4 scale;
+    vec4 offset;
+} dequantization;
+
+// snorm16 or half float positions and snorm16 normals are already unpacked to floats by the vertex fetch
+layout(location = 0) in vec4 vPosition;
+layout(location = 1) in vec4 vColor;
+layout(location = 2) in vec2 vNormal;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec3 fragNormal;
+
+vec3 decodeOctahedral(vec2 encoded) {
+    vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+
+    // unfolds the lower half of the octahedron
+    float fold = max(-normal.z, 0.0);
+    normal.x += normal.x >= 0.0 ? -fold : fold;
+    normal.y += normal.y >= 0.0 ? -fold : fold;
+
+    return normalize(normal);
+}
+
+void main() {
+    vec3 position = vPosition.xyz * dequantization.scale.xyz + dequantization.offset.xyz;
+    mat4 world = objects.world[gl_InstanceIndex];
+
+    // the renderer passes the transform index as the first instance
+    gl_Position = camera.proj * camera.view * world * vec4(position, 1.0);
+    fragColor = vColor.rgb;
+    fragNormal = normalize(mat3(world) * decodeOctahedral(vNormal));
+}
@@ -1,10 +1,14 @@
 #version 450
 
-layout(binding = 0) uniform uObject {
-    mat4 model;
+layout(binding = 0) uniform Camera {
     mat4 view;
     mat4 proj;
-} ubo;
+} camera;
+
+// math::Matrix is row-major, glsl defaults to column-major
+layout(std430, row_major, binding = 1) readonly buffer Objects {
+    mat4 world[];
+} objects;
 
 layout(location = 0) in vec2 vPosition;
 layout(location = 1) in vec3 vColor;
@@ -12,6 +16,7 @@ layout(location = 1) in vec3 vColor;
 layout(location = 0) out vec3 fragColor;
 
 void main() {
-    gl_Position = ubo.proj * ubo.view * ubo.model * vec4(vPosition, 0.0, 1.0);
+    // the renderer passes the transform index as the first instance
+    gl_Position = camera.proj * camera.view * objects.world[gl_InstanceIndex] * vec4(vPosition, 0.0, 1.0);
     fragColor = vColor;
 }
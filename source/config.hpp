@@ -9,6 +9,22 @@
 namespace config {
     static constexpr glm::vec2 window_size = {800, 600};
     static constexpr bool enable_validation_layers = true;
+    static constexpr bool enable_shader_hot_reload = true;
+    static constexpr bool enable_parallel_recording = true;
+    static constexpr bool enable_frustum_culling = true;
+    // opaque draws are culled by a compute shader and drawn indirectly, when the device supports multiDrawIndirect and drawIndirectFirstInstance
+    static constexpr bool enable_gpu_culling = true;
+    // the gpu culling runs on a dedicated compute queue, when the device exposes one
+    static constexpr bool enable_async_compute = true;
+    // timestamp queries around the main passes, read back FRAME_OVERLAP frames later
+    static constexpr bool enable_gpu_profiler = true;
+    // vertex, clipping and fragment counts of the render pass, most drivers slow the pass down while they are collected
+    static constexpr bool enable_pipeline_statistics = false;
+    // cpu zones around the frame phases, exported to cpu_trace_path when the renderer stops
+    static constexpr bool enable_cpu_profiler = true;
+    static constexpr std::string_view cpu_trace_path = "cpu_trace.json";
+
+    static constexpr std::string_view shader_directory = ".";
 
     static constexpr std::string_view engine_name = "mechap engine";
     static constexpr uint32_t engine_version = VK_MAKE_VERSION(1, 0, 0);
@@ -0,0 +1,439 @@
+#include "io/Gltf.hpp"
+
+#include <fmt/format.h>
+
+#include <cassert>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+#include "io/Json.hpp"
+
+namespace {
+    constexpr std::uint32_t glb_magic = 0x46546c67;  // "glTF"
+    constexpr std::uint32_t glb_chunk_json = 0x4e4f534a;
+    constexpr std::uint32_t glb_chunk_bin = 0x004e4942;
+
+    bool isInsideBuffer(std::span<const std::byte> data, std::uint64_t offset, std::uint64_t size) { return offset <= data.size() && size <= data.size() - offset; }
+
+    std::uint32_t readU32(std::span<const std::byte> data, std::size_t offset) {
+        std::uint32_t value = 0;
+        std::memcpy(&value, data.data() + offset, sizeof(value));
+        return value;
+    }
+
+    std::uint32_t getComponentSize(GltfComponentType type) {
+        switch (type) {
+            case GltfComponentType::BYTE:
+            case GltfComponentType::UNSIGNED_BYTE:
+                return 1;
+
+            case GltfComponentType::SHORT:
+            case GltfComponentType::UNSIGNED_SHORT:
+                return 2;
+
+            case GltfComponentType::UNSIGNED_INT:
+            case GltfComponentType::FLOAT:
+                return 4;
+
+            default:
+                throw std::runtime_error(fmt::format("unsupported glTF component type {}!", static_cast<std::uint32_t>(type)));
+        }
+    }
+
+    std::uint32_t getComponentCount(std::string_view type) {
+        if (type == "SCALAR") {
+            return 1;
+        }
+        if (type == "VEC2") {
+            return 2;
+        }
+        if (type == "VEC3") {
+            return 3;
+        }
+        if (type == "VEC4") {
+            return 4;
+        }
+
+        throw std::runtime_error(fmt::format("unsupported glTF accessor type {}!", type));
+    }
+
+    std::vector<std::byte> decodeBase64(std::string_view text) {
+        const auto decodeChar = [](char c) -> int {
+            if (c >= 'A' && c <= 'Z') {
+                return c - 'A';
+            }
+            if (c >= 'a' && c <= 'z') {
+                return c - 'a' + 26;
+            }
+            if (c >= '0' && c <= '9') {
+                return c - '0' + 52;
+            }
+            if (c == '+') {
+                return 62;
+            }
+            if (c == '/') {
+                return 63;
+            }
+            return -1;
+        };
+
+        std::vector<std::byte> bytes;
+        bytes.reserve(text.size() / 4 * 3);
+
+        std::uint32_t accumulator = 0;
+        int bits = 0;
+        for (const char c : text) {
+            if (c == '=') {
+                break;
+            }
+
+            const auto value = decodeChar(c);
+            if (value < 0) {
+                throw std::runtime_error("invalid character in glTF base64 data!");
+            }
+
+            accumulator = (accumulator << 6) | static_cast<std::uint32_t>(value);
+            bits += 6;
+            if (bits >= 8) {
+                bits -= 8;
+                bytes.push_back(static_cast<std::byte>((accumulator >> bits) & 0xff));
+            }
+        }
+
+        return bytes;
+    }
+
+    std::string decodePercents(std::string_view uri) {
+        std::string decoded;
+        decoded.reserve(uri.size());
+
+        for (std::size_t i = 0; i < uri.size(); ++i) {
+            if (uri[i] == '%' && i + 2 < uri.size()) {
+                std::uint32_t code = 0;
+                const auto [end, error] = std::from_chars(uri.data() + i + 1, uri.data() + i + 3, code, 16);
+                if (error != std::errc() || end != uri.data() + i + 3) {
+                    throw std::runtime_error(fmt::format("invalid percent escape in glTF uri {}!", uri));
+                }
+
+                decoded += static_cast<char>(code);
+                i += 2;
+            } else {
+                decoded += uri[i];
+            }
+        }
+
+        return decoded;
+    }
+
+    std::optional<std::uint32_t> findIndex(const JsonValue &object, std::string_view key) {
+        const auto *member = object.find(key);
+        return member != nullptr ? std::optional(member->asUint()) : std::nullopt;
+    }
+
+    template <typename T>
+    std::optional<std::uint32_t> checkIndex(std::optional<std::uint32_t> index, const std::vector<T> &items, std::string_view what) {
+        if (index && *index >= items.size()) {
+            throw std::runtime_error(fmt::format("glTF {} index {} is out of bounds!", what, *index));
+        }
+        return index;
+    }
+
+    std::vector<float> readFloats(const JsonValue &object, std::string_view key) {
+        std::vector<float> values;
+        if (const auto *member = object.find(key)) {
+            for (const auto &value : member->asArray()) {
+                values.push_back(static_cast<float>(value.asNumber()));
+            }
+        }
+        return values;
+    }
+}  // namespace
+
+std::optional<std::uint32_t> GltfPrimitive::findAttribute(std::string_view semantic) const {
+    for (const auto &[name, accessor] : attributes) {
+        if (name == semantic) {
+            return accessor;
+        }
+    }
+    return std::nullopt;
+}
+
+GltfAsset::GltfAsset(std::string_view filepath) : directory(std::filesystem::path(filepath).parent_path().string()) {
+    auto &file = mappings.emplace_back(filepath);
+    const auto data = file.getData();
+
+    if (data.size() < 12 || readU32(data, 0) != glb_magic) {
+        parse({reinterpret_cast<const char *>(data.data()), data.size()}, std::nullopt);
+        return;
+    }
+
+    // a .glb is a header followed by the json chunk and an optional binary chunk holding the first buffer
+    if (readU32(data, 4) != 2) {
+        throw std::runtime_error(fmt::format("glb file {} is not a glTF 2.0 file!", filepath));
+    }
+
+    std::optional<std::span<const std::byte>> json;
+    std::optional<std::span<const std::byte>> binary;
+
+    const auto length = std::min<std::uint64_t>(readU32(data, 8), data.size());
+    for (std::uint64_t offset = 12; offset + 8 <= length;) {
+        const auto chunkLength = readU32(data, offset);
+        const auto chunkType = readU32(data, offset + 4);
+        if (!isInsideBuffer(data.first(length), offset + 8, chunkLength)) {
+            throw std::runtime_error(fmt::format("glb file {} has a chunk out of bounds!", filepath));
+        }
+
+        const auto chunk = data.subspan(offset + 8, chunkLength);
+        if (chunkType == glb_chunk_json && !json) {
+            json = chunk;
+        } else if (chunkType == glb_chunk_bin && !binary) {
+            binary = chunk;
+        }
+
+        // chunks are 4 bytes aligned
+        offset += 8 + (static_cast<std::uint64_t>(chunkLength) + 3) / 4 * 4;
+    }
+
+    if (!json) {
+        throw std::runtime_error(fmt::format("glb file {} has no json chunk!", filepath));
+    }
+
+    parse({reinterpret_cast<const char *>(json->data()), json->size()}, binary);
+}
+
+std::span<const std::byte> GltfAsset::getBufferView(std::uint32_t index) const {
+    const auto &view = buffer_views.at(index);
+    return buffers[view.buffer].subspan(view.byte_offset, view.byte_length);
+}
+
+void GltfAsset::parse(std::string_view text, std::optional<std::span<const std::byte>> binary_chunk) {
+    const auto document = parseJson(text);
+
+    const auto &asset = document["asset"];
+    if (!asset.getString("version").starts_with("2.")) {
+        throw std::runtime_error(fmt::format("glTF version {} is not supported!", asset.getString("version")));
+    }
+
+    if (const auto *required = document.find("extensionsRequired"); required != nullptr && !required->asArray().empty()) {
+        throw std::runtime_error(fmt::format("glTF extension {} is required but not supported!", (*required)[0].asString()));
+    }
+
+    if (const auto *array = document.find("buffers")) {
+        for (std::size_t i = 0; i < array->asArray().size(); ++i) {
+            const auto &buffer = (*array)[i];
+            const auto byteLength = static_cast<std::uint64_t>(buffer["byteLength"].asNumber());
+
+            std::span<const std::byte> data;
+            if (const auto *uri = buffer.find("uri")) {
+                data = loadUri(uri->asString());
+            } else if (i == 0 && binary_chunk) {
+                data = *binary_chunk;
+            } else {
+                throw std::runtime_error(fmt::format("glTF buffer {} has no data!", i));
+            }
+
+            // the binary chunk may be padded past the byte length
+            if (data.size() < byteLength) {
+                throw std::runtime_error(fmt::format("glTF buffer {} is smaller than its byte length!", i));
+            }
+            buffers.push_back(data.first(byteLength));
+        }
+    }
+
+    if (const auto *array = document.find("bufferViews")) {
+        for (const auto &view : array->asArray()) {
+            auto &bufferView = buffer_views.emplace_back();
+            bufferView.buffer = view["buffer"].asUint();
+            bufferView.byte_offset = view.getUint("byteOffset", 0);
+            bufferView.byte_length = view["byteLength"].asUint();
+            bufferView.byte_stride = view.getUint("byteStride", 0);
+
+            if (bufferView.buffer >= buffers.size() || !isInsideBuffer(buffers[bufferView.buffer], bufferView.byte_offset, bufferView.byte_length)) {
+                throw std::runtime_error(fmt::format("glTF buffer view {} is out of bounds!", buffer_views.size() - 1));
+            }
+        }
+    }
+
+    if (const auto *array = document.find("accessors")) {
+        for (const auto &accessor : array->asArray()) {
+            if (accessor.find("sparse") != nullptr) {
+                throw std::runtime_error("sparse glTF accessors are not supported!");
+            }
+
+            auto &result = accessors.emplace_back();
+            result.buffer_view = checkIndex(findIndex(accessor, "bufferView"), buffer_views, "buffer view");
+            result.byte_offset = accessor.getUint("byteOffset", 0);
+            result.component_type = static_cast<GltfComponentType>(accessor["componentType"].asUint());
+            result.normalized = accessor.getBool("normalized", false);
+            result.count = accessor["count"].asUint();
+            result.component_count = getComponentCount(accessor["type"].asString());
+            result.min = readFloats(accessor, "min");
+            result.max = readFloats(accessor, "max");
+
+            // validates the component type
+            static_cast<void>(getComponentSize(result.component_type));
+        }
+    }
+
+    if (const auto *array = document.find("images")) {
+        for (const auto &image : array->asArray()) {
+            auto &result = images.emplace_back();
+
+            if (const auto view = checkIndex(findIndex(image, "bufferView"), buffer_views, "buffer view")) {
+                result.data = getBufferView(*view);
+            } else if (const auto uri = image.getString("uri"); uri.starts_with("data:")) {
+                result.data = loadUri(uri);
+            } else {
+                result.path = resolvePath(uri);
+            }
+        }
+    }
+
+    // textures only point materials to images, their samplers are left to the renderer
+    std::vector<std::optional<std::uint32_t>> textureImages;
+    if (const auto *array = document.find("textures")) {
+        for (const auto &texture : array->asArray()) {
+            textureImages.push_back(checkIndex(findIndex(texture, "source"), images, "image"));
+        }
+    }
+
+    if (const auto *array = document.find("materials")) {
+        for (const auto &material : array->asArray()) {
+            auto &result = materials.emplace_back();
+
+            if (const auto *pbr = material.find("pbrMetallicRoughness")) {
+                const auto factor = readFloats(*pbr, "baseColorFactor");
+                if (factor.size() == 4) {
+                    std::copy(factor.begin(), factor.end(), result.base_color_factor.begin());
+                }
+
+                if (const auto *texture = pbr->find("baseColorTexture")) {
+                    const auto index = checkIndex(std::optional((*texture)["index"].asUint()), textureImages, "texture");
+                    result.base_color_image = textureImages[*index];
+                }
+            }
+        }
+    }
+
+    if (const auto *array = document.find("meshes")) {
+        for (const auto &mesh : array->asArray()) {
+            auto &result = meshes.emplace_back();
+            result.name = mesh.getString("name");
+
+            for (const auto &primitive : mesh["primitives"].asArray()) {
+                auto &resultPrimitive = result.primitives.emplace_back();
+
+                for (const auto &[semantic, accessor] : primitive["attributes"].asObject()) {
+                    resultPrimitive.attributes.emplace_back(semantic, *checkIndex(std::optional(accessor.asUint()), accessors, "accessor"));
+                }
+                resultPrimitive.indices = checkIndex(findIndex(primitive, "indices"), accessors, "accessor");
+                resultPrimitive.material = checkIndex(findIndex(primitive, "material"), materials, "material");
+                resultPrimitive.mode = primitive.getUint("mode", gltf_mode_triangles);
+            }
+        }
+    }
+}
+
+std::span<const std::byte> GltfAsset::loadUri(std::string_view uri) {
+    if (uri.starts_with("data:")) {
+        const auto comma = uri.find(',');
+        if (comma == std::string_view::npos || uri.substr(0, comma).find(";base64") == std::string_view::npos) {
+            throw std::runtime_error("glTF data uri is not base64 encoded!");
+        }
+
+        return embedded_buffers.emplace_back(decodeBase64(uri.substr(comma + 1)));
+    }
+
+    return mappings.emplace_back(resolvePath(uri)).getData();
+}
+
+std::string GltfAsset::resolvePath(std::string_view uri) const { return (std::filesystem::path(directory) / decodePercents(uri)).string(); }
+
+GltfAccessorReader::GltfAccessorReader(const GltfAsset &asset, std::uint32_t accessor_index) : accessor(&asset.accessors.at(accessor_index)) {
+    component_size = getComponentSize(accessor->component_type);
+
+    const auto elementSize = component_size * accessor->component_count;
+    if (!accessor->buffer_view) {
+        return;
+    }
+
+    const auto view = asset.getBufferView(*accessor->buffer_view);
+    stride = asset.buffer_views[*accessor->buffer_view].byte_stride;
+    if (stride == 0) {
+        stride = elementSize;
+    }
+
+    const auto size = accessor->count == 0 ? 0 : static_cast<std::uint64_t>(accessor->count - 1) * stride + elementSize;
+    if (!isInsideBuffer(view, accessor->byte_offset, size)) {
+        throw std::runtime_error(fmt::format("glTF accessor {} is out of the bounds of its buffer view!", accessor_index));
+    }
+
+    data = view.subspan(accessor->byte_offset, size);
+}
+
+const std::byte *GltfAccessorReader::getComponent(std::uint32_t element, std::uint32_t component) const {
+    assert(element < accessor->count);
+    return data.data() + static_cast<std::size_t>(element) * stride + static_cast<std::size_t>(component) * component_size;
+}
+
+float GltfAccessorReader::readFloat(std::uint32_t element, std::uint32_t component) const {
+    if (data.empty() || component >= accessor->component_count) {
+        return 0.f;
+    }
+
+    const auto *bytes = getComponent(element, component);
+    const auto read = [&]<typename T>(T, float scale) {
+        T value;
+        std::memcpy(&value, bytes, sizeof(T));
+        return accessor->normalized ? std::max(static_cast<float>(value) / scale, -1.f) : static_cast<float>(value);
+    };
+
+    switch (accessor->component_type) {
+        case GltfComponentType::BYTE:
+            return read(std::int8_t{}, 127.f);
+
+        case GltfComponentType::UNSIGNED_BYTE:
+            return read(std::uint8_t{}, 255.f);
+
+        case GltfComponentType::SHORT:
+            return read(std::int16_t{}, 32767.f);
+
+        case GltfComponentType::UNSIGNED_SHORT:
+            return read(std::uint16_t{}, 65535.f);
+
+        case GltfComponentType::UNSIGNED_INT:
+            return read(std::uint32_t{}, 4294967295.f);
+
+        default:
+            return read(float{}, 1.f);
+    }
+}
+
+std::uint32_t GltfAccessorReader::readIndex(std::uint32_t element) const {
+    if (data.empty()) {
+        return 0;
+    }
+
+    const auto *bytes = getComponent(element, 0);
+    switch (accessor->component_type) {
+        case GltfComponentType::UNSIGNED_BYTE:
+            return static_cast<std::uint32_t>(*bytes);
+
+        case GltfComponentType::UNSIGNED_SHORT: {
+            std::uint16_t index;
+            std::memcpy(&index, bytes, sizeof(index));
+            return index;
+        }
+
+        case GltfComponentType::UNSIGNED_INT: {
+            std::uint32_t index;
+            std::memcpy(&index, bytes, sizeof(index));
+            return index;
+        }
+
+        default:
+            throw std::runtime_error("glTF indices must be unsigned integers!");
+    }
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "io/MappedFile.hpp"
+#include "utility.hpp"
+
+// glTF 2.0 component types, the values of accessor.componentType
+enum class GltfComponentType : std::uint32_t {
+    BYTE = 5120,
+    UNSIGNED_BYTE = 5121,
+    SHORT = 5122,
+    UNSIGNED_SHORT = 5123,
+    UNSIGNED_INT = 5125,
+    FLOAT = 5126,
+};
+
+static constexpr std::uint32_t gltf_mode_triangles = 4;
+
+struct GltfBufferView {
+    std::uint32_t buffer = 0;
+    std::uint64_t byte_offset = 0;
+    std::uint64_t byte_length = 0;
+    // 0 when the elements are tightly packed
+    std::uint32_t byte_stride = 0;
+};
+
+struct GltfAccessor {
+    // accessors without a buffer view are all zeros
+    std::optional<std::uint32_t> buffer_view;
+    std::uint64_t byte_offset = 0;
+
+    GltfComponentType component_type = GltfComponentType::FLOAT;
+    bool normalized = false;
+
+    std::uint32_t count = 0;
+    // 1 for SCALAR, 2 to 4 for VEC2 to VEC4, matrices are not supported
+    std::uint32_t component_count = 1;
+
+    // empty when the file doesn't give them, required by the spec for POSITION
+    std::vector<float> min;
+    std::vector<float> max;
+};
+
+struct GltfImage {
+    // path of an external image file, empty for embedded images
+    std::string path;
+    // encoded bytes of an image embedded in a buffer view or a data: uri
+    std::span<const std::byte> data;
+};
+
+struct GltfMaterial {
+    std::array<float, 4> base_color_factor{1.f, 1.f, 1.f, 1.f};
+    // index of an image, the sampler of the texture is not kept
+    std::optional<std::uint32_t> base_color_image;
+};
+
+struct GltfPrimitive {
+    // accessors of the vertex attributes, by semantic
+    std::vector<std::pair<std::string, std::uint32_t>> attributes;
+    std::optional<std::uint32_t> indices;
+    std::optional<std::uint32_t> material;
+    std::uint32_t mode = gltf_mode_triangles;
+
+    [[nodiscard]] std::optional<std::uint32_t> findAttribute(std::string_view semantic) const;
+};
+
+struct GltfMesh {
+    std::string name;
+    std::vector<GltfPrimitive> primitives;
+};
+
+// A .gltf file with its external .bin buffers, or a self-contained .glb, with every buffer mapped rather than read.
+// Only data: uris are decoded into memory, they are meant for small embedded assets.
+class GltfAsset final : public NoCopy {
+  public:
+    explicit GltfAsset(std::string_view filepath);
+
+    // checked against the buffer it points into
+    [[nodiscard]] std::span<const std::byte> getBufferView(std::uint32_t index) const;
+
+    std::vector<GltfBufferView> buffer_views;
+    std::vector<GltfAccessor> accessors;
+    std::vector<GltfImage> images;
+    std::vector<GltfMaterial> materials;
+    std::vector<GltfMesh> meshes;
+
+  private:
+    void parse(std::string_view json, std::optional<std::span<const std::byte>> binary_chunk);
+
+    // decodes a data: uri or maps the file the uri points to, relative to the asset
+    [[nodiscard]] std::span<const std::byte> loadUri(std::string_view uri);
+    [[nodiscard]] std::string resolvePath(std::string_view uri) const;
+
+  private:
+    std::string directory;
+
+    std::vector<MappedFile> mappings;
+    std::vector<std::vector<std::byte>> embedded_buffers;
+    std::vector<std::span<const std::byte>> buffers;
+};
+
+// Reads the elements of an accessor straight from the mapped buffer, converting the components to float or to indices.
+class GltfAccessorReader {
+  public:
+    GltfAccessorReader(const GltfAsset &asset, std::uint32_t accessor_index);
+
+    [[nodiscard]] const GltfAccessor &getAccessor() const { return *accessor; }
+    [[nodiscard]] std::uint32_t getCount() const { return accessor->count; }
+
+    // normalized integers are mapped to [0, 1] or [-1, 1], missing components read as 0
+    [[nodiscard]] float readFloat(std::uint32_t element, std::uint32_t component) const;
+    // for index accessors, which are unsigned scalars
+    [[nodiscard]] std::uint32_t readIndex(std::uint32_t element) const;
+
+  private:
+    [[nodiscard]] const std::byte *getComponent(std::uint32_t element, std::uint32_t component) const;
+
+  private:
+    const GltfAccessor *accessor;
+
+    std::span<const std::byte> data;
+    std::uint32_t stride = 0;
+    std::uint32_t component_size = 0;
+};
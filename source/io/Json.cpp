@@ -0,0 +1,394 @@
+#include "io/Json.hpp"
+
+#include <fmt/format.h>
+
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    class JsonParser {
+      public:
+        explicit JsonParser(std::string_view _text) : text(_text) {}
+
+        JsonValue parseDocument() {
+            auto value = parseValue(0);
+
+            skipWhitespace();
+            if (position != text.size()) {
+                fail("unexpected trailing characters");
+            }
+
+            return value;
+        }
+
+      private:
+        // deep enough for any sane document, keeps a malicious one from overflowing the stack
+        static constexpr std::uint32_t max_depth = 256;
+
+        [[noreturn]] void fail(std::string_view reason) const { throw std::runtime_error(fmt::format("failed to parse json at offset {} : {}!", position, reason)); }
+
+        void skipWhitespace() {
+            while (position < text.size() && (text[position] == ' ' || text[position] == '\t' || text[position] == '\n' || text[position] == '\r')) {
+                ++position;
+            }
+        }
+
+        char peek() {
+            skipWhitespace();
+            if (position == text.size()) {
+                fail("unexpected end of text");
+            }
+            return text[position];
+        }
+
+        void expect(char c) {
+            if (peek() != c) {
+                fail(fmt::format("expected '{}'", c));
+            }
+            ++position;
+        }
+
+        void expectLiteral(std::string_view literal) {
+            if (text.substr(position, literal.size()) != literal) {
+                fail(fmt::format("expected {}", literal));
+            }
+            position += literal.size();
+        }
+
+        JsonValue parseValue(std::uint32_t depth) {
+            if (depth > max_depth) {
+                fail("document is nested too deeply");
+            }
+
+            switch (peek()) {
+                case '{':
+                    return parseObject(depth);
+
+                case '[':
+                    return parseArray(depth);
+
+                case '"':
+                    return JsonValue(parseString());
+
+                case 't':
+                    expectLiteral("true");
+                    return JsonValue(true);
+
+                case 'f':
+                    expectLiteral("false");
+                    return JsonValue(false);
+
+                case 'n':
+                    expectLiteral("null");
+                    return JsonValue();
+
+                default:
+                    return JsonValue(parseNumber());
+            }
+        }
+
+        JsonValue parseObject(std::uint32_t depth) {
+            expect('{');
+
+            JsonValue::Object object;
+            if (peek() == '}') {
+                ++position;
+                return JsonValue(std::move(object));
+            }
+
+            while (true) {
+                if (peek() != '"') {
+                    fail("expected a member name");
+                }
+
+                auto key = parseString();
+                expect(':');
+                object.emplace_back(std::move(key), parseValue(depth + 1));
+
+                if (peek() == '}') {
+                    ++position;
+                    return JsonValue(std::move(object));
+                }
+                expect(',');
+            }
+        }
+
+        JsonValue parseArray(std::uint32_t depth) {
+            expect('[');
+
+            JsonValue::Array array;
+            if (peek() == ']') {
+                ++position;
+                return JsonValue(std::move(array));
+            }
+
+            while (true) {
+                array.push_back(parseValue(depth + 1));
+
+                if (peek() == ']') {
+                    ++position;
+                    return JsonValue(std::move(array));
+                }
+                expect(',');
+            }
+        }
+
+        double parseNumber() {
+            const auto first = position;
+
+            // follows the json grammar, from_chars alone would accept leading zeros and a bare trailing dot
+            const auto skipDigits = [&] {
+                const auto start = position;
+                while (position < text.size() && std::isdigit(static_cast<unsigned char>(text[position])) != 0) {
+                    ++position;
+                }
+                return position - start;
+            };
+            const auto accept = [&](char c) {
+                if (position < text.size() && text[position] == c) {
+                    ++position;
+                    return true;
+                }
+                return false;
+            };
+
+            accept('-');
+            const auto integerStart = position;
+            const auto integerDigits = skipDigits();
+            bool valid = integerDigits > 0 && (integerDigits == 1 || text[integerStart] != '0');
+
+            if (valid && accept('.')) {
+                valid = skipDigits() > 0;
+            }
+            if (valid && (accept('e') || accept('E'))) {
+                if (!accept('+')) {
+                    accept('-');
+                }
+                valid = skipDigits() > 0;
+            }
+
+            double number = 0.0;
+            if (valid) {
+                const auto [end, error] = std::from_chars(text.data() + first, text.data() + position, number);
+                valid = error == std::errc() && end == text.data() + position;
+            }
+
+            if (!valid) {
+                position = first;
+                fail("invalid number");
+            }
+
+            return number;
+        }
+
+        std::uint32_t parseHex4() {
+            if (text.size() - position < 4) {
+                fail("truncated unicode escape");
+            }
+
+            std::uint32_t code = 0;
+            const auto [end, error] = std::from_chars(text.data() + position, text.data() + position + 4, code, 16);
+            if (error != std::errc() || end != text.data() + position + 4) {
+                fail("invalid unicode escape");
+            }
+            position += 4;
+
+            return code;
+        }
+
+        static void appendUtf8(std::string &string, std::uint32_t code) {
+            if (code < 0x80) {
+                string += static_cast<char>(code);
+            } else if (code < 0x800) {
+                string += static_cast<char>(0xc0 | (code >> 6));
+                string += static_cast<char>(0x80 | (code & 0x3f));
+            } else if (code < 0x10000) {
+                string += static_cast<char>(0xe0 | (code >> 12));
+                string += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+                string += static_cast<char>(0x80 | (code & 0x3f));
+            } else {
+                string += static_cast<char>(0xf0 | (code >> 18));
+                string += static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+                string += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+                string += static_cast<char>(0x80 | (code & 0x3f));
+            }
+        }
+
+        std::string parseString() {
+            expect('"');
+
+            std::string string;
+            while (true) {
+                if (position == text.size()) {
+                    fail("unterminated string");
+                }
+
+                const char c = text[position++];
+                if (c == '"') {
+                    return string;
+                }
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    fail("control character in string");
+                }
+                if (c != '\\') {
+                    string += c;
+                    continue;
+                }
+
+                if (position == text.size()) {
+                    fail("unterminated string");
+                }
+
+                switch (const char escape = text[position++]) {
+                    case '"':
+                    case '\\':
+                    case '/':
+                        string += escape;
+                        break;
+
+                    case 'b':
+                        string += '\b';
+                        break;
+
+                    case 'f':
+                        string += '\f';
+                        break;
+
+                    case 'n':
+                        string += '\n';
+                        break;
+
+                    case 'r':
+                        string += '\r';
+                        break;
+
+                    case 't':
+                        string += '\t';
+                        break;
+
+                    case 'u': {
+                        auto code = parseHex4();
+
+                        // characters outside of the basic plane are escaped as a surrogate pair
+                        if (code >= 0xd800 && code < 0xdc00 && text.substr(position, 2) == "\\u") {
+                            position += 2;
+                            const auto low = parseHex4();
+                            if (low < 0xdc00 || low >= 0xe000) {
+                                fail("invalid surrogate pair");
+                            }
+                            code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                        }
+
+                        appendUtf8(string, code);
+                        break;
+                    }
+
+                    default:
+                        fail("invalid escape sequence");
+                }
+            }
+        }
+
+      private:
+        std::string_view text;
+        std::size_t position = 0;
+    };
+}  // namespace
+
+bool JsonValue::asBool() const {
+    if (!isBool()) {
+        throw std::runtime_error("json value is not a boolean!");
+    }
+    return std::get<bool>(value);
+}
+
+double JsonValue::asNumber() const {
+    if (!isNumber()) {
+        throw std::runtime_error("json value is not a number!");
+    }
+    return std::get<double>(value);
+}
+
+std::uint32_t JsonValue::asUint() const {
+    const auto number = asNumber();
+    if (number < 0.0 || number > static_cast<double>(std::numeric_limits<std::uint32_t>::max()) || std::floor(number) != number) {
+        throw std::runtime_error(fmt::format("json number {} is not an unsigned 32 bit integer!", number));
+    }
+    return static_cast<std::uint32_t>(number);
+}
+
+const std::string &JsonValue::asString() const {
+    if (!isString()) {
+        throw std::runtime_error("json value is not a string!");
+    }
+    return std::get<std::string>(value);
+}
+
+const JsonValue::Array &JsonValue::asArray() const {
+    if (!isArray()) {
+        throw std::runtime_error("json value is not an array!");
+    }
+    return std::get<Array>(value);
+}
+
+const JsonValue::Object &JsonValue::asObject() const {
+    if (!isObject()) {
+        throw std::runtime_error("json value is not an object!");
+    }
+    return std::get<Object>(value);
+}
+
+const JsonValue *JsonValue::find(std::string_view key) const {
+    if (!isObject()) {
+        return nullptr;
+    }
+
+    for (const auto &[name, member] : std::get<Object>(value)) {
+        if (name == key) {
+            return &member;
+        }
+    }
+
+    return nullptr;
+}
+
+const JsonValue &JsonValue::operator[](std::string_view key) const {
+    const auto *member = find(key);
+    if (member == nullptr) {
+        throw std::runtime_error(fmt::format("json object has no member {}!", key));
+    }
+    return *member;
+}
+
+const JsonValue &JsonValue::operator[](std::size_t index) const {
+    const auto &array = asArray();
+    if (index >= array.size()) {
+        throw std::runtime_error(fmt::format("json array index {} is out of bounds!", index));
+    }
+    return array[index];
+}
+
+std::uint32_t JsonValue::getUint(std::string_view key, std::uint32_t fallback) const {
+    const auto *member = find(key);
+    return member != nullptr ? member->asUint() : fallback;
+}
+
+double JsonValue::getNumber(std::string_view key, double fallback) const {
+    const auto *member = find(key);
+    return member != nullptr ? member->asNumber() : fallback;
+}
+
+bool JsonValue::getBool(std::string_view key, bool fallback) const {
+    const auto *member = find(key);
+    return member != nullptr ? member->asBool() : fallback;
+}
+
+std::string_view JsonValue::getString(std::string_view key, std::string_view fallback) const {
+    const auto *member = find(key);
+    return member != nullptr ? std::string_view(member->asString()) : fallback;
+}
+
+JsonValue parseJson(std::string_view text) { return JsonParser(text).parseDocument(); }
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Document of a parsed json text, enough for asset formats such as glTF. Accessing a value as the wrong type throws.
+class JsonValue {
+  public:
+    using Array = std::vector<JsonValue>;
+    // members keep the order of the text, lookups are linear which is fine for the small objects of asset files
+    using Object = std::vector<std::pair<std::string, JsonValue>>;
+
+  public:
+    JsonValue() = default;
+
+    template <typename T>
+        requires(!std::is_same_v<std::remove_cvref_t<T>, JsonValue>)
+    explicit JsonValue(T &&_value) : value(std::forward<T>(_value)) {}
+
+    [[nodiscard]] bool isNull() const { return std::holds_alternative<std::nullptr_t>(value); }
+    [[nodiscard]] bool isBool() const { return std::holds_alternative<bool>(value); }
+    [[nodiscard]] bool isNumber() const { return std::holds_alternative<double>(value); }
+    [[nodiscard]] bool isString() const { return std::holds_alternative<std::string>(value); }
+    [[nodiscard]] bool isArray() const { return std::holds_alternative<Array>(value); }
+    [[nodiscard]] bool isObject() const { return std::holds_alternative<Object>(value); }
+
+    [[nodiscard]] bool asBool() const;
+    [[nodiscard]] double asNumber() const;
+    // throws when the number is negative, not an integer or too large
+    [[nodiscard]] std::uint32_t asUint() const;
+    [[nodiscard]] const std::string &asString() const;
+    [[nodiscard]] const Array &asArray() const;
+    [[nodiscard]] const Object &asObject() const;
+
+    // nullptr when this isn't an object or has no such member
+    [[nodiscard]] const JsonValue *find(std::string_view key) const;
+    // throws when the member is missing
+    [[nodiscard]] const JsonValue &operator[](std::string_view key) const;
+    [[nodiscard]] const JsonValue &operator[](std::size_t index) const;
+
+    // members which are optional in a format, fallback is returned when the member is missing
+    [[nodiscard]] std::uint32_t getUint(std::string_view key, std::uint32_t fallback) const;
+    [[nodiscard]] double getNumber(std::string_view key, double fallback) const;
+    [[nodiscard]] bool getBool(std::string_view key, bool fallback) const;
+    [[nodiscard]] std::string_view getString(std::string_view key, std::string_view fallback = {}) const;
+
+  private:
+    std::variant<std::nullptr_t, bool, double, std::string, Array, Object> value{nullptr};
+};
+
+// throws on malformed text, with the offset of the error
+[[nodiscard]] JsonValue parseJson(std::string_view text);
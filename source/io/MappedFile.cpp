@@ -0,0 +1,126 @@
+#include "io/MappedFile.hpp"
+
+#include <fmt/format.h>
+
+#include <fstream>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(std::string_view filepath) : path(filepath) {
+#ifdef _WIN32
+    file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_handle == INVALID_HANDLE_VALUE) {
+        file_handle = nullptr;
+        throw std::fstream::failure(fmt::format("couldn't open file at : {}\n", path));
+    }
+
+    LARGE_INTEGER fileSize{};
+    GetFileSizeEx(file_handle, &fileSize);
+    data_size = static_cast<std::size_t>(fileSize.QuadPart);
+
+    if (data_size == 0) {
+        return;
+    }
+
+    mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_handle == nullptr) {
+        unmap();
+        throw std::fstream::failure(fmt::format("couldn't map file at : {}\n", path));
+    }
+
+    data = static_cast<const std::byte *>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::fstream::failure(fmt::format("couldn't open file at : {}\n", path));
+    }
+
+    struct stat fileStat {};
+    if (fstat(fd, &fileStat) != 0) {
+        close(fd);
+        throw std::fstream::failure(fmt::format("couldn't stat file at : {}\n", path));
+    }
+    data_size = static_cast<std::size_t>(fileStat.st_size);
+
+    if (data_size == 0) {
+        close(fd);
+        return;
+    }
+
+    void *mapping = mmap(nullptr, data_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (mapping != MAP_FAILED) {
+        data = static_cast<const std::byte *>(mapping);
+    }
+#endif
+
+    if (data == nullptr) {
+        unmap();
+        throw std::fstream::failure(fmt::format("couldn't map file at : {}\n", path));
+    }
+}
+
+MappedFile::~MappedFile() { unmap(); }
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : path(std::move(other.path)),
+      data(std::exchange(other.data, nullptr)),
+      data_size(std::exchange(other.data_size, 0))
+#ifdef _WIN32
+      ,
+      file_handle(std::exchange(other.file_handle, nullptr)),
+      mapping_handle(std::exchange(other.mapping_handle, nullptr))
+#endif
+{
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+        unmap();
+
+        path = std::move(other.path);
+        data = std::exchange(other.data, nullptr);
+        data_size = std::exchange(other.data_size, 0);
+#ifdef _WIN32
+        file_handle = std::exchange(other.file_handle, nullptr);
+        mapping_handle = std::exchange(other.mapping_handle, nullptr);
+#endif
+    }
+
+    return *this;
+}
+
+void MappedFile::unmap() {
+#ifdef _WIN32
+    if (data != nullptr) {
+        UnmapViewOfFile(data);
+    }
+    if (mapping_handle != nullptr) {
+        CloseHandle(mapping_handle);
+    }
+    if (file_handle != nullptr) {
+        CloseHandle(file_handle);
+    }
+
+    mapping_handle = nullptr;
+    file_handle = nullptr;
+#else
+    if (data != nullptr) {
+        munmap(const_cast<std::byte *>(data), data_size);
+    }
+#endif
+
+    data = nullptr;
+    data_size = 0;
+}
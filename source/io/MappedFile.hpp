@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "utility.hpp"
+
+// Read-only memory mapping of a whole file, the pages are only faulted in when touched.
+class MappedFile final : public NoCopy {
+  public:
+    explicit MappedFile(std::string_view filepath);
+    ~MappedFile();
+
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    [[nodiscard]] std::span<const std::byte> getData() const { return {data, data_size}; }
+    [[nodiscard]] std::size_t getSize() const { return data_size; }
+    [[nodiscard]] const std::string &getPath() const { return path; }
+
+  private:
+    void unmap();
+
+  private:
+    std::string path;
+
+    const std::byte *data = nullptr;
+    std::size_t data_size = 0;
+
+#ifdef _WIN32
+    void *file_handle = nullptr;
+    void *mapping_handle = nullptr;
+#endif
+};
@@ -0,0 +1,112 @@
+#include "io/MeshFile.hpp"
+
+#include <fmt/format.h>
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+    constexpr std::uint64_t alignUp(std::uint64_t value, std::uint64_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+    bool isInside(std::span<const std::byte> data, std::uint64_t offset, std::uint64_t size) { return offset <= data.size() && size <= data.size() - offset; }
+}  // namespace
+
+MeshFileView parseMeshFile(std::span<const std::byte> data) {
+    MeshFileView view{};
+    if (data.size() < sizeof(MeshFileHeader)) {
+        throw std::runtime_error("mesh file is smaller than its header!");
+    }
+
+    std::memcpy(&view.header, data.data(), sizeof(MeshFileHeader));
+    const auto &header = view.header;
+
+    if (header.magic != mesh_file_magic) {
+        throw std::runtime_error("mesh file has an invalid magic number!");
+    }
+    if (header.version != mesh_file_version) {
+        throw std::runtime_error(fmt::format("mesh file version {} is not supported, expected {}!", header.version, mesh_file_version));
+    }
+    if (header.index_size != sizeof(std::uint16_t) && header.index_size != sizeof(std::uint32_t)) {
+        throw std::runtime_error("mesh file has an invalid index size!");
+    }
+
+    const auto attributesSize = static_cast<std::uint64_t>(header.attribute_count) * sizeof(MeshFileAttribute);
+    if (!isInside(data, sizeof(MeshFileHeader), attributesSize)) {
+        throw std::runtime_error("mesh file attributes are out of bounds!");
+    }
+
+    // the blob sizes are checked against the counts so that a truncated file is never read past its end
+    if (header.vertex_data_size != static_cast<std::uint64_t>(header.vertex_count) * header.vertex_stride ||
+        header.index_data_size != static_cast<std::uint64_t>(header.index_count) * header.index_size) {
+        throw std::runtime_error("mesh file blob sizes don't match their counts!");
+    }
+    if (header.vertex_count == 0 && header.index_count > 0) {
+        throw std::runtime_error("mesh file has indices but no vertices!");
+    }
+    if (!isInside(data, header.vertex_data_offset, header.vertex_data_size) || !isInside(data, header.index_data_offset, header.index_data_size)) {
+        throw std::runtime_error("mesh file blobs are out of bounds!");
+    }
+
+    // the header size keeps the attributes aligned in a page aligned mapping
+    view.attributes = {reinterpret_cast<const MeshFileAttribute *>(data.data() + sizeof(MeshFileHeader)), header.attribute_count};
+    view.vertex_data = data.subspan(header.vertex_data_offset, header.vertex_data_size);
+    view.index_data = data.subspan(header.index_data_offset, header.index_data_size);
+
+    return view;
+}
+
+void writeMeshFile(std::string_view filepath, const MeshFileData &mesh) {
+    if (mesh.index_size != sizeof(std::uint16_t) && mesh.index_size != sizeof(std::uint32_t)) {
+        throw std::runtime_error("mesh index size must be 2 or 4 bytes!");
+    }
+
+    const auto path = std::string(filepath);
+
+    auto file = std::ofstream(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::fstream::failure(fmt::format("couldn't open file at : {}\n", path));
+    }
+
+    MeshFileHeader header{};
+    header.vertex_stride = mesh.vertex_stride;
+    header.vertex_count = mesh.vertex_stride == 0 ? 0 : static_cast<std::uint32_t>(mesh.vertices.size() / mesh.vertex_stride);
+    header.attribute_count = static_cast<std::uint32_t>(mesh.attributes.size());
+
+    header.index_size = mesh.index_size;
+    header.index_count = static_cast<std::uint32_t>(mesh.indices.size() / mesh.index_size);
+
+    header.vertex_data_offset = alignUp(sizeof(MeshFileHeader) + mesh.attributes.size_bytes(), mesh_blob_alignment);
+    header.vertex_data_size = mesh.vertices.size();
+    header.index_data_offset = alignUp(header.vertex_data_offset + header.vertex_data_size, mesh_blob_alignment);
+    header.index_data_size = mesh.indices.size();
+
+    header.bounds_min = mesh.bounds_min;
+    header.bounds_max = mesh.bounds_max;
+    header.bounds_center = mesh.bounds_center;
+    header.bounds_radius = mesh.bounds_radius;
+
+    if (header.vertex_data_size != static_cast<std::uint64_t>(header.vertex_count) * header.vertex_stride ||
+        header.index_data_size != static_cast<std::uint64_t>(header.index_count) * header.index_size) {
+        throw std::runtime_error("mesh data sizes are not a multiple of the vertex stride and index size!");
+    }
+
+    const auto pad = [&](std::uint64_t offset) {
+        static constexpr std::array<char, mesh_blob_alignment> zeros{};
+        file.write(zeros.data(), static_cast<std::streamsize>(offset - static_cast<std::uint64_t>(file.tellp())));
+    };
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(mesh.attributes.data()), static_cast<std::streamsize>(mesh.attributes.size_bytes()));
+
+    pad(header.vertex_data_offset);
+    file.write(reinterpret_cast<const char *>(mesh.vertices.data()), static_cast<std::streamsize>(mesh.vertices.size()));
+
+    pad(header.index_data_offset);
+    file.write(reinterpret_cast<const char *>(mesh.indices.data()), static_cast<std::streamsize>(mesh.indices.size()));
+
+    if (!file) {
+        throw std::fstream::failure(fmt::format("couldn't write mesh file at : {}\n", path));
+    }
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+// Offline-cooked mesh, laid out so that its vertex and index blobs are copied from a mapping of the file straight into staging memory.
+// A file is a MeshFileHeader, attribute_count MeshFileAttribute, then the vertex and index blobs at mesh_blob_alignment aligned offsets.
+// Every value is little-endian.
+static constexpr std::uint32_t mesh_file_magic = 0x48534d56;  // "VMSH"
+static constexpr std::uint32_t mesh_file_version = 1;
+static constexpr std::uint64_t mesh_blob_alignment = 256;
+
+struct MeshFileHeader {
+    std::uint32_t magic = mesh_file_magic;
+    std::uint32_t version = mesh_file_version;
+
+    std::uint32_t vertex_count = 0;
+    std::uint32_t vertex_stride = 0;
+    std::uint32_t attribute_count = 0;
+
+    std::uint32_t index_count = 0;
+    // bytes per index, 2 or 4
+    std::uint32_t index_size = 0;
+    std::uint32_t reserved = 0;
+
+    // from the start of the file
+    std::uint64_t vertex_data_offset = 0;
+    std::uint64_t vertex_data_size = 0;
+    std::uint64_t index_data_offset = 0;
+    std::uint64_t index_data_size = 0;
+
+    // model space bounds, like MeshBounds
+    std::array<float, 3> bounds_min{};
+    std::array<float, 3> bounds_max{};
+    std::array<float, 3> bounds_center{};
+    float bounds_radius = 0.f;
+};
+
+// one attribute of the single interleaved vertex binding
+struct MeshFileAttribute {
+    std::uint32_t location = 0;
+    // a VkFormat value
+    std::uint32_t format = 0;
+    std::uint32_t offset = 0;
+    std::uint32_t reserved = 0;
+};
+
+static_assert(std::is_trivially_copyable_v<MeshFileHeader> && sizeof(MeshFileHeader) == 104);
+static_assert(std::is_trivially_copyable_v<MeshFileAttribute> && sizeof(MeshFileAttribute) == 16);
+
+// what a file is cooked from
+struct MeshFileData {
+    std::uint32_t vertex_stride = 0;
+    std::span<const MeshFileAttribute> attributes;
+    std::span<const std::byte> vertices;
+
+    std::uint32_t index_size = sizeof(std::uint16_t);
+    std::span<const std::byte> indices;
+
+    std::array<float, 3> bounds_min{};
+    std::array<float, 3> bounds_max{};
+    std::array<float, 3> bounds_center{};
+    float bounds_radius = 0.f;
+};
+
+// views into the file data, nothing is copied
+struct MeshFileView {
+    MeshFileHeader header;
+    std::span<const MeshFileAttribute> attributes;
+
+    std::span<const std::byte> vertex_data;
+    std::span<const std::byte> index_data;
+};
+
+// checks the header and that every blob lies inside data, throws on a malformed file
+[[nodiscard]] MeshFileView parseMeshFile(std::span<const std::byte> data);
+
+void writeMeshFile(std::string_view filepath, const MeshFileData &mesh);
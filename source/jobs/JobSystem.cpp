@@ -0,0 +1,289 @@
+#include "jobs/JobSystem.hpp"
+
+#include <fmt/color.h>
+
+#include <stdexcept>
+
+#include "profiling/CpuProfiler.hpp"
+
+namespace {
+    thread_local const JobSystem *current_job_system = nullptr;
+    thread_local std::uint32_t current_worker_index = 0;
+
+    // job systems are told apart by id rather than address, a new one may be allocated where a destroyed one was
+    std::atomic<std::uint64_t> next_job_system_id{0};
+    // the slots the calling thread got from the job systems it isn't a worker of, by job system id
+    thread_local std::vector<std::pair<std::uint64_t, std::uint32_t>> external_thread_slots;
+}  // namespace
+
+JobSystem::JobSystem(std::uint32_t _worker_count) : id(next_job_system_id.fetch_add(1, std::memory_order_relaxed)) {
+    queues.reserve(_worker_count);
+    for (std::uint32_t i = 0; i < _worker_count; ++i) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    workers.reserve(_worker_count);
+    for (std::uint32_t i = 0; i < _worker_count; ++i) {
+        workers.emplace_back([this, i](std::stop_token stop_token) { work(std::move(stop_token), i); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    for (auto &worker : workers) {
+        worker.request_stop();
+    }
+    sleep_condition.notify_all();
+
+    workers.clear();
+
+    // the jobs left behind, and the continuations they release, run here so no counter is left pending
+    while (auto job = pop(getWorkerCount())) {
+        run(job->job);
+    }
+}
+
+void JobSystem::schedule(Job &&job, JobCounter *signal, JobCounter *dependency) {
+    if (signal != nullptr) {
+        signal->pending.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    Job wrapped = [this, job = std::move(job), signal] {
+        try {
+            job();
+        } catch (const std::exception &e) {
+            fmt::print(fmt::fg(fmt::color::orange_red) | fmt::emphasis::bold, "[job system] : {}\n", e.what());
+        }
+
+        if (signal != nullptr) {
+            finish(*signal);
+        }
+    };
+
+    if (dependency != nullptr) {
+        auto lock = std::scoped_lock(dependency->mutex);
+        if (!dependency->isDone()) {
+            dependency->continuations.emplace_back(std::move(wrapped), signal);
+            return;
+        }
+    }
+
+    push(std::move(wrapped), signal);
+}
+
+void JobSystem::parallelFor(
+    std::uint32_t count, std::uint32_t min_batch_size, const std::function<void(std::uint32_t first, std::uint32_t last)> &function, JobCounter &signal) {
+    if (count == 0) {
+        return;
+    }
+
+    const auto slots = getThreadSlotCount();
+    const auto batchSize = std::max({1u, min_batch_size, (count + slots - 1) / slots});
+
+    // shared by every batch, the caller's function may go out of scope before the batches run
+    auto shared = std::make_shared<std::function<void(std::uint32_t, std::uint32_t)>>(function);
+
+    for (std::uint32_t first = 0; first < count; first += batchSize) {
+        const auto last = std::min(count, first + batchSize);
+        schedule([shared, first, last] { (*shared)(first, last); }, &signal);
+    }
+}
+
+void JobSystem::wait(const JobCounter &counter) {
+    // other threads, e.g. the render thread, only run the jobs they wait for so unrelated work can't stall them
+    const bool worker = isWorkerThread();
+    const auto queueIndex = worker ? current_worker_index : getWorkerCount();
+    const auto *filter = worker ? nullptr : &counter;
+
+    const auto canHelp = [&] { return worker ? queued_count.load() > 0 : counter.queued.load() > 0; };
+
+    while (!counter.isDone()) {
+        if (auto job = pop(queueIndex, filter)) {
+            run(job->job);
+            continue;
+        }
+
+        // the waiter count and the queued counts are sequentially consistent, either push() sees this waiter or it is seen here
+        waiter_count.fetch_add(1);
+        {
+            auto lock = std::unique_lock(wait_mutex);
+            wait_condition.wait(lock, [&] { return counter.isDone() || canHelp(); });
+        }
+        waiter_count.fetch_sub(1);
+    }
+
+    // the last job may still be releasing the counter
+    auto lock = std::scoped_lock(counter.mutex);
+}
+
+void JobSystem::scheduleOnMainThread(Job &&job) {
+    auto lock = std::scoped_lock(main_thread_mutex);
+    main_thread_jobs.push_back(std::move(job));
+}
+
+void JobSystem::runMainThreadJobs() {
+    std::vector<Job> jobs;
+    {
+        auto lock = std::scoped_lock(main_thread_mutex);
+        jobs.swap(main_thread_jobs);
+    }
+
+    for (auto &job : jobs) {
+        run(job);
+    }
+}
+
+std::uint32_t JobSystem::getThreadIndex() const {
+    if (isWorkerThread()) {
+        return current_worker_index;
+    }
+
+    for (const auto &[system, slot] : external_thread_slots) {
+        if (system == id) {
+            return slot;
+        }
+    }
+
+    const auto external = next_external_slot.fetch_add(1, std::memory_order_relaxed);
+    if (external >= max_external_threads) {
+        throw std::runtime_error(fmt::format("more than {} threads outside of the workers use the job system!", max_external_threads));
+    }
+
+    const auto slot = getWorkerCount() + external;
+    external_thread_slots.emplace_back(id, slot);
+    return slot;
+}
+
+bool JobSystem::isWorkerThread() const { return current_job_system == this; }
+
+void JobSystem::work(std::stop_token stop_token, std::uint32_t worker_index) {
+    current_job_system = this;
+    current_worker_index = worker_index;
+
+    if constexpr (config::enable_cpu_profiler) {
+        CpuProfiler::setThreadName(fmt::format("worker {}", worker_index));
+    }
+
+    while (!stop_token.stop_requested()) {
+        if (auto job = pop(worker_index)) {
+            run(job->job);
+            continue;
+        }
+
+        auto lock = std::unique_lock(sleep_mutex);
+        sleep_condition.wait(lock, stop_token, [this] { return queued_count.load(std::memory_order_acquire) > 0; });
+    }
+}
+
+void JobSystem::push(Job &&job, JobCounter *signal) {
+    // workers keep the jobs they spawn, other threads spread theirs over every queue
+    const auto queueIndex = isWorkerThread() ? current_worker_index : next_queue.fetch_add(1, std::memory_order_relaxed) % getWorkerCount();
+
+    // counted before the job can be taken, so the counter is never decremented below zero
+    if (signal != nullptr) {
+        signal->queued.fetch_add(1);
+    }
+
+    {
+        auto &queue = *queues[queueIndex];
+        auto lock = std::scoped_lock(queue.mutex);
+        queue.jobs.push_back(QueuedJob{std::move(job), signal});
+    }
+
+    queued_count.fetch_add(1);
+
+    // taking the lock makes sure a worker can't miss the notification between checking its predicate and sleeping
+    { auto lock = std::scoped_lock(sleep_mutex); }
+    sleep_condition.notify_one();
+
+    if (waiter_count.load() > 0) {
+        wakeWaiters();
+    }
+}
+
+std::optional<JobSystem::QueuedJob> JobSystem::pop(std::uint32_t queue_index, const JobCounter *counter) {
+    if (queued_count.load(std::memory_order_acquire) == 0) {
+        return std::nullopt;
+    }
+
+    const auto workerCount = getWorkerCount();
+
+    // own queue first, newest job first as its data is the most likely to still be in cache
+    if (queue_index < workerCount) {
+        if (auto job = take(*queues[queue_index], true, counter)) {
+            return job;
+        }
+    }
+
+    // then steal the oldest job of another worker
+    for (std::uint32_t offset = 1; offset <= workerCount; ++offset) {
+        if (auto job = take(*queues[(queue_index + offset) % workerCount], false, counter)) {
+            return job;
+        }
+    }
+
+    return std::nullopt;
+}
+
+std::optional<JobSystem::QueuedJob> JobSystem::take(WorkerQueue &queue, bool newest, const JobCounter *counter) {
+    std::optional<QueuedJob> job;
+    {
+        auto lock = std::scoped_lock(queue.mutex);
+
+        if (counter == nullptr) {
+            if (queue.jobs.empty()) {
+                return std::nullopt;
+            }
+
+            job.emplace(std::move(newest ? queue.jobs.back() : queue.jobs.front()));
+            if (newest) {
+                queue.jobs.pop_back();
+            } else {
+                queue.jobs.pop_front();
+            }
+        } else {
+            const auto found = std::ranges::find(queue.jobs, counter, &QueuedJob::signal);
+            if (found == queue.jobs.end()) {
+                return std::nullopt;
+            }
+
+            job.emplace(std::move(*found));
+            queue.jobs.erase(found);
+        }
+    }
+
+    queued_count.fetch_sub(1, std::memory_order_relaxed);
+    // the job hasn't run yet, its counter is still alive
+    if (job->signal != nullptr) {
+        job->signal->queued.fetch_sub(1);
+    }
+
+    return job;
+}
+
+void JobSystem::run(Job &job) {
+    CPU_ZONE("job");
+    job();
+}
+
+void JobSystem::finish(JobCounter &counter) {
+    std::vector<std::pair<Job, JobCounter *>> ready;
+    {
+        auto lock = std::scoped_lock(counter.mutex);
+        if (counter.pending.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        ready.swap(counter.continuations);
+    }
+
+    // a waiter may destroy the counter as soon as its mutex is released, only the ready jobs are used from here
+    wakeWaiters();
+
+    for (auto &[job, signal] : ready) {
+        push(std::move(job), signal);
+    }
+}
+
+void JobSystem::wakeWaiters() {
+    { auto lock = std::scoped_lock(wait_mutex); }
+    wait_condition.notify_all();
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "utility.hpp"
+
+using Job = std::function<void()>;
+
+// Number of scheduled jobs that haven't finished yet, jobs can be made to wait for a counter to reach zero before they start.
+// A counter must outlive the jobs signaling it, JobSystem::wait() is the usual way to make sure of that.
+class JobCounter final : public NoCopy, public NoMove {
+    friend class JobSystem;
+
+  public:
+    JobCounter() = default;
+
+    [[nodiscard]] bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+
+  private:
+    std::atomic<std::uint32_t> pending{0};
+    // jobs signaling the counter that sit in a queue, a thread waiting on the counter can run them
+    std::atomic<std::uint32_t> queued{0};
+
+    // also held while the last job signals the counter, so wait() can't return before the counter is released
+    mutable std::mutex mutex;
+    std::vector<std::pair<Job, JobCounter *>> continuations;
+};
+
+// Fixed pool of workers, each with its own deque. Workers pop their own jobs from the back and steal from the front of the others' deques.
+// Jobs that must run on the main thread, e.g. anything touching the window, are queued apart and run by runMainThreadJobs().
+class JobSystem final : public NoCopy, public NoMove {
+  public:
+    // threads other than the workers that can get a slot from getThreadIndex()
+    static constexpr std::uint32_t max_external_threads = 4;
+
+  public:
+    explicit JobSystem(std::uint32_t _worker_count = std::max(2u, std::thread::hardware_concurrency()) - 1);
+    // the workers finish their current job, the jobs still queued then run on the destroying thread so every counter completes
+    // jobs must not wait on counters signaled by main thread jobs, which are dropped
+    ~JobSystem();
+
+    // signal is incremented now and decremented once the job has run, the job only starts once dependency is done
+    void schedule(Job &&job, JobCounter *signal = nullptr, JobCounter *dependency = nullptr);
+
+    // splits [0, count) into batches of at least min_batch_size, function is called with each [first, last) batch
+    void parallelFor(
+        std::uint32_t count, std::uint32_t min_batch_size, const std::function<void(std::uint32_t first, std::uint32_t last)> &function, JobCounter &signal);
+
+    // helps with the jobs signaling the counter until it is done, then blocks until the last ones finish
+    // a worker helps with any job, so that a job waiting on another never starves the pool
+    void wait(const JobCounter &counter);
+
+    void scheduleOnMainThread(Job &&job);
+    // called by the main thread once per frame, right after polling the window events
+    void runMainThreadJobs();
+
+    [[nodiscard]] std::uint32_t getWorkerCount() const { return static_cast<std::uint32_t>(queues.size()); }
+
+    // index of the calling worker in [0, getWorkerCount()), other threads get their own slot after the workers on their first call
+    // lets systems keep per-thread data, e.g. command pools, without locking
+    [[nodiscard]] std::uint32_t getThreadIndex() const;
+    [[nodiscard]] std::uint32_t getThreadSlotCount() const { return getWorkerCount() + max_external_threads; }
+
+  private:
+    struct QueuedJob {
+        Job job;
+        JobCounter *signal = nullptr;
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<QueuedJob> jobs;
+    };
+
+    void work(std::stop_token stop_token, std::uint32_t worker_index);
+
+    [[nodiscard]] bool isWorkerThread() const;
+
+    void push(Job &&job, JobCounter *signal);
+    // any job, or only the ones signaling counter
+    [[nodiscard]] std::optional<QueuedJob> pop(std::uint32_t queue_index, const JobCounter *counter = nullptr);
+    [[nodiscard]] std::optional<QueuedJob> take(WorkerQueue &queue, bool newest, const JobCounter *counter);
+    void run(Job &job);
+
+    void finish(JobCounter &counter);
+    void wakeWaiters();
+
+  private:
+    const std::uint64_t id;
+    mutable std::atomic<std::uint32_t> next_external_slot{0};
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+
+    std::atomic<std::uint32_t> queued_count{0};
+    std::atomic<std::uint32_t> next_queue{0};
+
+    std::mutex sleep_mutex;
+    std::condition_variable_any sleep_condition;
+
+    // threads blocked in wait(), woken when a job is queued or a counter completes
+    std::atomic<std::uint32_t> waiter_count{0};
+    std::mutex wait_mutex;
+    std::condition_variable wait_condition;
+
+    std::mutex main_thread_mutex;
+    std::vector<Job> main_thread_jobs;
+
+    std::vector<std::jthread> workers;
+};
@@ -23,31 +23,28 @@ int main() {
         auto defaultVertices = GraphicsPipeline::defaultMeshRectangleVertices();
         auto defaultIndices = GraphicsPipeline::defaultMeshRectangleIndices();
 
-        auto mesh1 = Mesh(DrawPrimitive::RECTANGLE, renderer.getInfo().device, {defaultVertices.begin(), defaultVertices.end()}, {defaultIndices.begin(), defaultIndices.end()});
-        auto ubo1 = UniformObject();
-        ubo1.model = glm::mat4(1.0f);
-        ubo1.view = glm::mat4(1.0f);
-        ubo1.proj = glm::ortho(0.0f, 800.0f, 0.0f, 600.0f, -100.0f, 100.0f);
+        renderer.setCamera(glm::mat4(1.0f), glm::ortho(0.0f, 800.0f, 0.0f, 600.0f, -100.0f, 100.0f));
+        auto &transforms = renderer.getTransforms();
 
-        renderer.draw(mesh1, ubo1);
+        auto mesh1 = Mesh(DrawPrimitive::RECTANGLE, renderer.getInfo().device, defaultVertices, defaultIndices);
+        const auto transform1 = transforms.create();
 
-        auto mesh2 = Mesh(DrawPrimitive::RECTANGLE, renderer.getInfo().device, {defaultVertices.begin(), defaultVertices.end()}, {defaultIndices.begin(), defaultIndices.end()});
-        auto ubo2 = ubo1;
-        ubo2.model = glm::translate(ubo2.model, glm::vec3(200.f, 200.f, 0.f));
+        renderer.draw(mesh1, transform1);
 
-        renderer.draw(mesh2, ubo2);
+        auto mesh2 = Mesh(DrawPrimitive::RECTANGLE, renderer.getInfo().device, defaultVertices, defaultIndices);
+        const auto transform2 = transforms.create(glm::vec3(200.f, 200.f, 0.f));
 
-        auto mesh3 = Mesh(DrawPrimitive::RECTANGLE, renderer.getInfo().device, {defaultVertices.begin(), defaultVertices.end()}, {defaultIndices.begin(), defaultIndices.end()});
-        auto ubo3 = ubo1;
-        ubo3.model = glm::translate(ubo2.model, glm::vec3(-100.f, -100.f, 0.f));
+        renderer.draw(mesh2, transform2);
 
-        renderer.draw(mesh3, ubo3);
+        auto mesh3 = Mesh(DrawPrimitive::RECTANGLE, renderer.getInfo().device, defaultVertices, defaultIndices);
+        const auto transform3 = transforms.create(glm::vec3(-100.f, -100.f, 0.f), glm::quat(1.f, 0.f, 0.f, 0.f), glm::vec3(1.f), transform2);
 
-        auto mesh4 = Mesh(DrawPrimitive::RECTANGLE, renderer.getInfo().device, {defaultVertices.begin(), defaultVertices.end()}, {defaultIndices.begin(), defaultIndices.end()});
-        auto ubo4 = ubo3;
-        ubo4.model = glm::translate(ubo3.model, glm::vec3(150.f, 50.f, 0.f));
+        renderer.draw(mesh3, transform3);
 
-        renderer.draw(mesh4, ubo4);
+        auto mesh4 = Mesh(DrawPrimitive::RECTANGLE, renderer.getInfo().device, defaultVertices, defaultIndices);
+        const auto transform4 = transforms.create(glm::vec3(150.f, 50.f, 0.f), glm::quat(1.f, 0.f, 0.f, 0.f), glm::vec3(1.f), transform3);
+
+        renderer.draw(mesh4, transform4);
 
         renderer.end();
     } catch (const std::exception &e) {
@@ -1,13 +1,26 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cassert>
+#include <cmath>
 #include <concepts>
 #include <span>
+#include <type_traits>
+#include <utility>
+
+#include "math/MatrixSimd.hpp"
 
 namespace math {
+    namespace detail {
+        // 16 bytes aligned when the storage fills whole sse registers, so rows and vec4 never straddle a cache line
+        template <typename T, std::size_t N>
+        inline constexpr std::size_t matrix_alignment = (sizeof(T) * N) % 16 == 0 ? 16 : alignof(T);
+    }  // namespace detail
+
+    // Row-major storage. Vectors are column matrices transformed as m * v, the same convention as glm.
     template <std::floating_point T, std::size_t Rows, std::size_t Cols>
-    class Matrix {
+    class alignas(detail::matrix_alignment<T, Rows * Cols>) Matrix {
       public:
         static constexpr auto size() noexcept { return Rows * Cols; }
         static constexpr auto rows() noexcept { return Rows; }
@@ -25,36 +38,112 @@ namespace math {
         Matrix(Matrix<T, Rows, Cols> &&other) noexcept = default;
         Matrix &operator=(Matrix<T, Rows, Cols> &&) noexcept = default;
 
-        explicit Matrix(std::span<const T, Rows> views) noexcept { std::ranges::copy(views, first()); }
-        explicit Matrix(T value) noexcept { std::ranges::fill(elems, value); }
+        constexpr explicit Matrix(std::span<const T, Rows> views) noexcept { std::ranges::copy(views, first()); }
+        constexpr explicit Matrix(T value) noexcept { std::ranges::fill(elems, value); }
 
         template <std::size_t N>
-        explicit Matrix(const T (&initializer)[N]) noexcept {
+        constexpr explicit Matrix(const T (&initializer)[N]) noexcept {
             static_assert((N == cols() && rows() == 1) || (N == rows() && cols() == 1));
             std::ranges::copy_n(&initializer[0], size(), first());
         }
 
-        explicit Matrix(const T (&initializer)[Rows][Cols]) noexcept { std::ranges::copy_n(&initializer[0][0], size(), first()); }
+        constexpr explicit Matrix(const T (&initializer)[Rows][Cols]) noexcept { std::ranges::copy_n(&initializer[0][0], size(), first()); }
 
-        constexpr auto operator[](std::size_t index) const {
-            assert(index >= 0);
+        static constexpr Matrix zero() noexcept { return Matrix(T{0}); }
 
+        static constexpr Matrix identity() noexcept
+            requires(Rows == Cols)
+        {
+            auto result = zero();
+            for (std::size_t i = 0; i < Rows; ++i) {
+                result(i, i) = T{1};
+            }
+            return result;
+        }
+
+        constexpr auto operator[](std::size_t index) const {
             if constexpr (cols() == 1) {
                 assert(index < rows());
                 return elems[index];
             } else if constexpr (rows() == 1) {
                 assert(index < cols());
                 return elems[index];
+            } else {
+                assert(index < rows());
+                return std::span<const T, Cols>{&elems[index * Cols], Cols};
+            }
+        }
+
+        constexpr decltype(auto) operator[](std::size_t index) {
+            if constexpr (cols() == 1 || rows() == 1) {
+                assert(index < size());
+                return (elems[index]);
             } else {
                 assert(index < rows());
                 return std::span<T, Cols>{&elems[index * Cols], Cols};
             }
         }
 
+        constexpr T &operator()(std::size_t row, std::size_t col) noexcept {
+            assert(row < Rows && col < Cols);
+            return elems[row * Cols + col];
+        }
+
+        constexpr T operator()(std::size_t row, std::size_t col) const noexcept {
+            assert(row < Rows && col < Cols);
+            return elems[row * Cols + col];
+        }
+
+        constexpr bool operator==(const Matrix &other) const = default;
+
+        constexpr Matrix &operator+=(const Matrix &other) noexcept {
+            for (std::size_t i = 0; i < size(); ++i) {
+                elems[i] += other.elems[i];
+            }
+            return *this;
+        }
+
+        constexpr Matrix &operator-=(const Matrix &other) noexcept {
+            for (std::size_t i = 0; i < size(); ++i) {
+                elems[i] -= other.elems[i];
+            }
+            return *this;
+        }
+
+        constexpr Matrix &operator*=(T scalar) noexcept {
+            for (auto &elem : elems) {
+                elem *= scalar;
+            }
+            return *this;
+        }
+
+        constexpr Matrix &operator/=(T scalar) noexcept {
+            for (auto &elem : elems) {
+                elem /= scalar;
+            }
+            return *this;
+        }
+
+        friend constexpr Matrix operator+(Matrix lhs, const Matrix &rhs) noexcept { return lhs += rhs; }
+        friend constexpr Matrix operator-(Matrix lhs, const Matrix &rhs) noexcept { return lhs -= rhs; }
+        friend constexpr Matrix operator*(Matrix lhs, T scalar) noexcept { return lhs *= scalar; }
+        friend constexpr Matrix operator*(T scalar, Matrix rhs) noexcept { return rhs *= scalar; }
+        friend constexpr Matrix operator/(Matrix lhs, T scalar) noexcept { return lhs /= scalar; }
+        friend constexpr Matrix operator-(Matrix value) noexcept { return value *= T{-1}; }
+
       private:
         std::array<T, Rows * Cols> elems;
     };
 
+    template <std::floating_point T, std::size_t N>
+    using Vector = Matrix<T, N, 1>;
+
+    using Matrix4f = Matrix<float, 4, 4>;
+    using Matrix3f = Matrix<float, 3, 3>;
+    using Vector4f = Vector<float, 4>;
+    using Vector3f = Vector<float, 3>;
+    using Vector2f = Vector<float, 2>;
+
     namespace detail {
         template <typename T>
         struct is_matrix : std::false_type {};
@@ -64,8 +153,149 @@ namespace math {
 
         template <typename T, std::size_t M, std::size_t N>
         struct is_matrix<const Matrix<T, M, N>> : std::true_type {};
+
+        template <typename T, std::size_t M, std::size_t N, std::size_t P>
+        inline constexpr bool is_simd_4x4 = std::is_same_v<T, float> && M == 4 && N == 4 && P == 4;
     }  // namespace detail
 
     template <typename T>
     inline constexpr bool is_matrix_v = detail::is_matrix<T>::value;
+
+    template <std::floating_point T, std::size_t M, std::size_t N, std::size_t P>
+    constexpr Matrix<T, M, P> operator*(const Matrix<T, M, N> &lhs, const Matrix<T, N, P> &rhs) noexcept {
+        Matrix<T, M, P> result;
+
+        if constexpr (detail::is_simd_4x4<T, M, N, P>) {
+            if (!std::is_constant_evaluated()) {
+                simd::multiply4x4(lhs.first(), rhs.first(), result.first());
+                return result;
+            }
+        } else if constexpr (std::is_same_v<T, float> && M == 4 && N == 4 && P == 1) {
+            if (!std::is_constant_evaluated()) {
+                simd::transform4(lhs.first(), rhs.first(), result.first());
+                return result;
+            }
+        }
+
+        for (std::size_t row = 0; row < M; ++row) {
+            for (std::size_t col = 0; col < P; ++col) {
+                T sum{0};
+                for (std::size_t k = 0; k < N; ++k) {
+                    sum += lhs(row, k) * rhs(k, col);
+                }
+                result(row, col) = sum;
+            }
+        }
+
+        return result;
+    }
+
+    template <std::floating_point T, std::size_t M, std::size_t N>
+    constexpr Matrix<T, M, N> &operator*=(Matrix<T, M, N> &lhs, const Matrix<T, N, N> &rhs) noexcept {
+        return lhs = lhs * rhs;
+    }
+
+    template <std::floating_point T, std::size_t Rows, std::size_t Cols>
+    constexpr Matrix<T, Cols, Rows> transpose(const Matrix<T, Rows, Cols> &matrix) noexcept {
+        Matrix<T, Cols, Rows> result;
+
+        if constexpr (detail::is_simd_4x4<T, Rows, Cols, 4>) {
+            if (!std::is_constant_evaluated()) {
+                simd::transpose4x4(matrix.first(), result.first());
+                return result;
+            }
+        }
+
+        for (std::size_t row = 0; row < Rows; ++row) {
+            for (std::size_t col = 0; col < Cols; ++col) {
+                result(col, row) = matrix(row, col);
+            }
+        }
+
+        return result;
+    }
+
+    // Gauss-Jordan elimination with partial pivoting, returns false and leaves result untouched when the matrix is singular
+    template <std::floating_point T, std::size_t N>
+    constexpr bool inverse(const Matrix<T, N, N> &matrix, Matrix<T, N, N> &result) noexcept {
+        if constexpr (detail::is_simd_4x4<T, N, N, N>) {
+            if (!std::is_constant_evaluated()) {
+                return simd::inverse4x4(matrix.first(), result.first());
+            }
+        }
+
+        auto work = matrix;
+        auto inverted = Matrix<T, N, N>::identity();
+
+        for (std::size_t col = 0; col < N; ++col) {
+            std::size_t pivot = col;
+            for (std::size_t row = col + 1; row < N; ++row) {
+                if ((work(row, col) < 0 ? -work(row, col) : work(row, col)) > (work(pivot, col) < 0 ? -work(pivot, col) : work(pivot, col))) {
+                    pivot = row;
+                }
+            }
+
+            if (work(pivot, col) == T{0}) {
+                return false;
+            }
+
+            if (pivot != col) {
+                for (std::size_t k = 0; k < N; ++k) {
+                    std::swap(work(pivot, k), work(col, k));
+                    std::swap(inverted(pivot, k), inverted(col, k));
+                }
+            }
+
+            const T scale = T{1} / work(col, col);
+            for (std::size_t k = 0; k < N; ++k) {
+                work(col, k) *= scale;
+                inverted(col, k) *= scale;
+            }
+
+            for (std::size_t row = 0; row < N; ++row) {
+                if (row != col && work(row, col) != T{0}) {
+                    const T factor = work(row, col);
+                    for (std::size_t k = 0; k < N; ++k) {
+                        work(row, k) -= factor * work(col, k);
+                        inverted(row, k) -= factor * inverted(col, k);
+                    }
+                }
+            }
+        }
+
+        result = inverted;
+        return true;
+    }
+
+    template <std::floating_point T, std::size_t N>
+    constexpr Matrix<T, N, N> inverse(const Matrix<T, N, N> &matrix) noexcept {
+        Matrix<T, N, N> result = Matrix<T, N, N>::zero();
+        [[maybe_unused]] const bool invertible = inverse(matrix, result);
+        assert(invertible);
+        return result;
+    }
+
+    template <std::floating_point T, std::size_t N>
+    constexpr T dot(const Vector<T, N> &lhs, const Vector<T, N> &rhs) noexcept {
+        T sum{0};
+        for (std::size_t i = 0; i < N; ++i) {
+            sum += lhs[i] * rhs[i];
+        }
+        return sum;
+    }
+
+    template <std::floating_point T, std::size_t N>
+    T length(const Vector<T, N> &vector) noexcept {
+        return std::sqrt(dot(vector, vector));
+    }
+
+    template <std::floating_point T, std::size_t N>
+    Vector<T, N> normalize(const Vector<T, N> &vector) noexcept {
+        return vector / length(vector);
+    }
+
+    template <std::floating_point T>
+    constexpr Vector<T, 3> cross(const Vector<T, 3> &lhs, const Vector<T, 3> &rhs) noexcept {
+        return Vector<T, 3>({lhs[1] * rhs[2] - lhs[2] * rhs[1], lhs[2] * rhs[0] - lhs[0] * rhs[2], lhs[0] * rhs[1] - lhs[1] * rhs[0]});
+    }
 }  // namespace math
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cassert>
+#include <span>
+
+#include "math/Matrix.hpp"
+
+// Batched kernels over contiguous spans, the loops stay in one place so the compiler keeps every operand in registers.
+namespace math {
+    // out[i] = lhs[i] * rhs[i]
+    inline void multiply(std::span<const Matrix4f> lhs, std::span<const Matrix4f> rhs, std::span<Matrix4f> out) noexcept {
+        assert(lhs.size() == rhs.size() && lhs.size() <= out.size());
+
+        for (std::size_t i = 0; i < lhs.size(); ++i) {
+            simd::multiply4x4(lhs[i].first(), rhs[i].first(), out[i].first());
+        }
+    }
+
+    // out[i] = lhs * rhs[i], typically a parent or view-projection matrix applied to many models
+    inline void multiply(const Matrix4f &lhs, std::span<const Matrix4f> rhs, std::span<Matrix4f> out) noexcept {
+        assert(rhs.size() <= out.size());
+
+        for (std::size_t i = 0; i < rhs.size(); ++i) {
+            simd::multiply4x4(lhs.first(), rhs[i].first(), out[i].first());
+        }
+    }
+
+    // out[i] = matrix * points[i]
+    inline void transform(const Matrix4f &matrix, std::span<const Vector4f> points, std::span<Vector4f> out) noexcept {
+        assert(points.size() <= out.size());
+
+#if defined(MATH_SIMD_SSE)
+        // transpose once for the whole batch instead of once per point
+        const auto columns = transpose(matrix);
+
+#if defined(MATH_SIMD_AVX)
+        const __m256 c0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(columns.first() + 0));
+        const __m256 c1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(columns.first() + 4));
+        const __m256 c2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(columns.first() + 8));
+        const __m256 c3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(columns.first() + 12));
+
+        // Vector4f is 16 bytes with no padding, two adjacent points fill one ymm register
+        static_assert(sizeof(Vector4f) == 4 * sizeof(float));
+
+        std::size_t i = 0;
+        for (; i + 2 <= points.size(); i += 2) {
+            const __m256 p = _mm256_loadu_ps(points[i].first());
+
+            __m256 result = _mm256_mul_ps(c0, _mm256_shuffle_ps(p, p, 0x00));
+            result = _mm256_add_ps(result, _mm256_mul_ps(c1, _mm256_shuffle_ps(p, p, 0x55)));
+            result = _mm256_add_ps(result, _mm256_mul_ps(c2, _mm256_shuffle_ps(p, p, 0xAA)));
+            result = _mm256_add_ps(result, _mm256_mul_ps(c3, _mm256_shuffle_ps(p, p, 0xFF)));
+
+            _mm256_storeu_ps(out[i].first(), result);
+        }
+#else
+        std::size_t i = 0;
+#endif
+        const __m128 s0 = _mm_load_ps(columns.first() + 0);
+        const __m128 s1 = _mm_load_ps(columns.first() + 4);
+        const __m128 s2 = _mm_load_ps(columns.first() + 8);
+        const __m128 s3 = _mm_load_ps(columns.first() + 12);
+
+        for (; i < points.size(); ++i) {
+            const __m128 p = _mm_loadu_ps(points[i].first());
+
+            __m128 result = _mm_mul_ps(s0, _mm_shuffle_ps(p, p, 0x00));
+            result = _mm_add_ps(result, _mm_mul_ps(s1, _mm_shuffle_ps(p, p, 0x55)));
+            result = _mm_add_ps(result, _mm_mul_ps(s2, _mm_shuffle_ps(p, p, 0xAA)));
+            result = _mm_add_ps(result, _mm_mul_ps(s3, _mm_shuffle_ps(p, p, 0xFF)));
+
+            _mm_storeu_ps(out[i].first(), result);
+        }
+#else
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            simd::transform4(matrix.first(), points[i].first(), out[i].first());
+        }
+#endif
+    }
+}  // namespace math
@@ -0,0 +1,252 @@
+#pragma once
+
+// Kernels behind math::Matrix<float, 4, 4>, working on row-major float[16] so they don't depend on the Matrix template.
+// AVX is used when the compiler targets it, SSE2 on any x86-64 target, plain scalar code everywhere else or with MATH_FORCE_SCALAR.
+
+#if !defined(MATH_FORCE_SCALAR)
+#if defined(__AVX__)
+#define MATH_SIMD_AVX 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MATH_SIMD_SSE 1
+#endif
+#endif
+
+#if defined(MATH_SIMD_SSE) || defined(MATH_SIMD_AVX)
+#include <immintrin.h>
+#endif
+
+#include <cstddef>
+
+namespace math::simd {
+#if defined(MATH_SIMD_AVX)
+    inline constexpr const char *instruction_set = "avx";
+#elif defined(MATH_SIMD_SSE)
+    inline constexpr const char *instruction_set = "sse2";
+#else
+    inline constexpr const char *instruction_set = "scalar";
+#endif
+
+#if defined(MATH_SIMD_SSE)
+    namespace detail {
+        template <int X, int Y, int Z, int W>
+        inline __m128 shuffle(__m128 lhs, __m128 rhs) noexcept {
+            return _mm_shuffle_ps(lhs, rhs, _MM_SHUFFLE(W, Z, Y, X));
+        }
+
+        template <int X, int Y, int Z, int W>
+        inline __m128 swizzle(__m128 vec) noexcept {
+            return shuffle<X, Y, Z, W>(vec, vec);
+        }
+
+        // 2x2 row-major matrices packed in one register
+        inline __m128 mat2Mul(__m128 lhs, __m128 rhs) noexcept {
+            return _mm_add_ps(_mm_mul_ps(lhs, swizzle<0, 3, 0, 3>(rhs)), _mm_mul_ps(swizzle<1, 0, 3, 2>(lhs), swizzle<2, 1, 2, 1>(rhs)));
+        }
+
+        // adjugate(lhs) * rhs
+        inline __m128 mat2AdjMul(__m128 lhs, __m128 rhs) noexcept {
+            return _mm_sub_ps(_mm_mul_ps(swizzle<3, 3, 0, 0>(lhs), rhs), _mm_mul_ps(swizzle<1, 1, 2, 2>(lhs), swizzle<2, 3, 0, 1>(rhs)));
+        }
+
+        // lhs * adjugate(rhs)
+        inline __m128 mat2MulAdj(__m128 lhs, __m128 rhs) noexcept {
+            return _mm_sub_ps(_mm_mul_ps(lhs, swizzle<3, 0, 3, 0>(rhs)), _mm_mul_ps(swizzle<1, 0, 3, 2>(lhs), swizzle<2, 1, 2, 1>(rhs)));
+        }
+    }  // namespace detail
+#endif
+
+    // out = lhs * rhs, out may alias neither input
+    inline void multiply4x4(const float *lhs, const float *rhs, float *out) noexcept {
+#if defined(MATH_SIMD_AVX)
+        // two result rows per register, each lane broadcasts its own row's coefficients
+        const __m256 r0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(rhs + 0));
+        const __m256 r1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(rhs + 4));
+        const __m256 r2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(rhs + 8));
+        const __m256 r3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(rhs + 12));
+
+        for (std::size_t row = 0; row < 16; row += 8) {
+            const __m256 l = _mm256_loadu_ps(lhs + row);
+
+            __m256 result = _mm256_mul_ps(_mm256_shuffle_ps(l, l, 0x00), r0);
+            result = _mm256_add_ps(result, _mm256_mul_ps(_mm256_shuffle_ps(l, l, 0x55), r1));
+            result = _mm256_add_ps(result, _mm256_mul_ps(_mm256_shuffle_ps(l, l, 0xAA), r2));
+            result = _mm256_add_ps(result, _mm256_mul_ps(_mm256_shuffle_ps(l, l, 0xFF), r3));
+
+            _mm256_storeu_ps(out + row, result);
+        }
+#elif defined(MATH_SIMD_SSE)
+        const __m128 r0 = _mm_loadu_ps(rhs + 0);
+        const __m128 r1 = _mm_loadu_ps(rhs + 4);
+        const __m128 r2 = _mm_loadu_ps(rhs + 8);
+        const __m128 r3 = _mm_loadu_ps(rhs + 12);
+
+        for (std::size_t row = 0; row < 16; row += 4) {
+            __m128 result = _mm_mul_ps(_mm_set1_ps(lhs[row + 0]), r0);
+            result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(lhs[row + 1]), r1));
+            result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(lhs[row + 2]), r2));
+            result = _mm_add_ps(result, _mm_mul_ps(_mm_set1_ps(lhs[row + 3]), r3));
+
+            _mm_storeu_ps(out + row, result);
+        }
+#else
+        for (std::size_t row = 0; row < 4; ++row) {
+            for (std::size_t col = 0; col < 4; ++col) {
+                out[row * 4 + col] = lhs[row * 4 + 0] * rhs[0 * 4 + col] + lhs[row * 4 + 1] * rhs[1 * 4 + col] + lhs[row * 4 + 2] * rhs[2 * 4 + col] +
+                                     lhs[row * 4 + 3] * rhs[3 * 4 + col];
+            }
+        }
+#endif
+    }
+
+    inline void transpose4x4(const float *in, float *out) noexcept {
+#if defined(MATH_SIMD_SSE)
+        __m128 r0 = _mm_loadu_ps(in + 0);
+        __m128 r1 = _mm_loadu_ps(in + 4);
+        __m128 r2 = _mm_loadu_ps(in + 8);
+        __m128 r3 = _mm_loadu_ps(in + 12);
+
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+        _mm_storeu_ps(out + 0, r0);
+        _mm_storeu_ps(out + 4, r1);
+        _mm_storeu_ps(out + 8, r2);
+        _mm_storeu_ps(out + 12, r3);
+#else
+        for (std::size_t row = 0; row < 4; ++row) {
+            for (std::size_t col = 0; col < 4; ++col) {
+                out[col * 4 + row] = in[row * 4 + col];
+            }
+        }
+#endif
+    }
+
+    // out = m * v for a column vector v
+    inline void transform4(const float *m, const float *v, float *out) noexcept {
+#if defined(MATH_SIMD_SSE)
+        __m128 c0 = _mm_loadu_ps(m + 0);
+        __m128 c1 = _mm_loadu_ps(m + 4);
+        __m128 c2 = _mm_loadu_ps(m + 8);
+        __m128 c3 = _mm_loadu_ps(m + 12);
+
+        // rows become columns, the product is then a sum of scaled columns
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+        __m128 result = _mm_mul_ps(c0, _mm_set1_ps(v[0]));
+        result = _mm_add_ps(result, _mm_mul_ps(c1, _mm_set1_ps(v[1])));
+        result = _mm_add_ps(result, _mm_mul_ps(c2, _mm_set1_ps(v[2])));
+        result = _mm_add_ps(result, _mm_mul_ps(c3, _mm_set1_ps(v[3])));
+
+        _mm_storeu_ps(out, result);
+#else
+        for (std::size_t row = 0; row < 4; ++row) {
+            out[row] = m[row * 4 + 0] * v[0] + m[row * 4 + 1] * v[1] + m[row * 4 + 2] * v[2] + m[row * 4 + 3] * v[3];
+        }
+#endif
+    }
+
+    // returns false and leaves out untouched when the matrix is singular
+    inline bool inverse4x4(const float *in, float *out) noexcept {
+#if defined(MATH_SIMD_SSE)
+        using namespace detail;
+
+        // block inversion on the four 2x2 sub-matrices | A B |
+        //                                              | C D |
+        const __m128 m0 = _mm_loadu_ps(in + 0);
+        const __m128 m1 = _mm_loadu_ps(in + 4);
+        const __m128 m2 = _mm_loadu_ps(in + 8);
+        const __m128 m3 = _mm_loadu_ps(in + 12);
+
+        const __m128 a = _mm_movelh_ps(m0, m1);
+        const __m128 b = _mm_movehl_ps(m1, m0);
+        const __m128 c = _mm_movelh_ps(m2, m3);
+        const __m128 d = _mm_movehl_ps(m3, m2);
+
+        // (|A|, |B|, |C|, |D|)
+        const __m128 detSub = _mm_sub_ps(
+            _mm_mul_ps(shuffle<0, 2, 0, 2>(m0, m2), shuffle<1, 3, 1, 3>(m1, m3)), _mm_mul_ps(shuffle<1, 3, 1, 3>(m0, m2), shuffle<0, 2, 0, 2>(m1, m3)));
+
+        const __m128 detA = swizzle<0, 0, 0, 0>(detSub);
+        const __m128 detB = swizzle<1, 1, 1, 1>(detSub);
+        const __m128 detC = swizzle<2, 2, 2, 2>(detSub);
+        const __m128 detD = swizzle<3, 3, 3, 3>(detSub);
+
+        const __m128 dc = mat2AdjMul(d, c);
+        const __m128 ab = mat2AdjMul(a, b);
+
+        __m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), mat2Mul(b, dc));
+        __m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), mat2Mul(c, ab));
+        __m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), mat2MulAdj(d, ab));
+        __m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), mat2MulAdj(a, dc));
+
+        // |M| = |A||D| + |B||C| - tr((A#B)(D#C))
+        __m128 trace = _mm_mul_ps(ab, swizzle<0, 2, 1, 3>(dc));
+        trace = _mm_add_ps(trace, swizzle<1, 0, 3, 2>(trace));
+        trace = _mm_add_ps(trace, swizzle<2, 3, 0, 1>(trace));
+
+        const __m128 detM = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+        if (_mm_cvtss_f32(detM) == 0.0f) {
+            return false;
+        }
+
+        const __m128 reciprocal = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), detM);
+
+        x = _mm_mul_ps(x, reciprocal);
+        y = _mm_mul_ps(y, reciprocal);
+        z = _mm_mul_ps(z, reciprocal);
+        w = _mm_mul_ps(w, reciprocal);
+
+        // applies the last adjugate shuffle while storing
+        _mm_storeu_ps(out + 0, shuffle<3, 1, 3, 1>(x, y));
+        _mm_storeu_ps(out + 4, shuffle<2, 0, 2, 0>(x, y));
+        _mm_storeu_ps(out + 8, shuffle<3, 1, 3, 1>(z, w));
+        _mm_storeu_ps(out + 12, shuffle<2, 0, 2, 0>(z, w));
+
+        return true;
+#else
+        // cofactor expansion over 2x2 sub-determinants
+        const float s0 = in[0] * in[5] - in[4] * in[1];
+        const float s1 = in[0] * in[6] - in[4] * in[2];
+        const float s2 = in[0] * in[7] - in[4] * in[3];
+        const float s3 = in[1] * in[6] - in[5] * in[2];
+        const float s4 = in[1] * in[7] - in[5] * in[3];
+        const float s5 = in[2] * in[7] - in[6] * in[3];
+
+        const float c5 = in[10] * in[15] - in[14] * in[11];
+        const float c4 = in[9] * in[15] - in[13] * in[11];
+        const float c3 = in[9] * in[14] - in[13] * in[10];
+        const float c2 = in[8] * in[15] - in[12] * in[11];
+        const float c1 = in[8] * in[14] - in[12] * in[10];
+        const float c0 = in[8] * in[13] - in[12] * in[9];
+
+        const float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+        if (det == 0.0f) {
+            return false;
+        }
+
+        const float invDet = 1.0f / det;
+
+        out[0] = (in[5] * c5 - in[6] * c4 + in[7] * c3) * invDet;
+        out[1] = (-in[1] * c5 + in[2] * c4 - in[3] * c3) * invDet;
+        out[2] = (in[13] * s5 - in[14] * s4 + in[15] * s3) * invDet;
+        out[3] = (-in[9] * s5 + in[10] * s4 - in[11] * s3) * invDet;
+
+        out[4] = (-in[4] * c5 + in[6] * c2 - in[7] * c1) * invDet;
+        out[5] = (in[0] * c5 - in[2] * c2 + in[3] * c1) * invDet;
+        out[6] = (-in[12] * s5 + in[14] * s2 - in[15] * s1) * invDet;
+        out[7] = (in[8] * s5 - in[10] * s2 + in[11] * s1) * invDet;
+
+        out[8] = (in[4] * c4 - in[5] * c2 + in[7] * c0) * invDet;
+        out[9] = (-in[0] * c4 + in[1] * c2 - in[3] * c0) * invDet;
+        out[10] = (in[12] * s4 - in[13] * s2 + in[15] * s0) * invDet;
+        out[11] = (-in[8] * s4 + in[9] * s2 - in[11] * s0) * invDet;
+
+        out[12] = (-in[4] * c3 + in[5] * c1 - in[6] * c0) * invDet;
+        out[13] = (in[0] * c3 - in[1] * c1 + in[2] * c0) * invDet;
+        out[14] = (-in[12] * s3 + in[13] * s1 - in[14] * s0) * invDet;
+        out[15] = (in[8] * s3 - in[9] * s1 + in[10] * s0) * invDet;
+
+        return true;
+#endif
+    }
+}  // namespace math::simd
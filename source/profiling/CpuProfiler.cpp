@@ -0,0 +1,126 @@
+#include "profiling/CpuProfiler.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+    struct ThreadBuffer {
+        std::uint32_t thread_id = 0;
+        std::string name;
+
+        // only written by the owning thread, head is published after the event it counts
+        std::array<CpuProfiler::Event, CpuProfiler::events_per_thread> events;
+        std::atomic<std::uint64_t> head{0};
+    };
+
+    // buffers outlive their thread so the events of finished threads can still be exported
+    struct Registry {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    };
+
+    Registry &getRegistry() {
+        static Registry registry;
+        return registry;
+    }
+
+    ThreadBuffer &getThreadBuffer() {
+        thread_local const std::shared_ptr<ThreadBuffer> buffer = [] {
+            auto &registry = getRegistry();
+            auto lock = std::scoped_lock(registry.mutex);
+
+            auto created = std::make_shared<ThreadBuffer>();
+            created->thread_id = static_cast<std::uint32_t>(registry.buffers.size());
+            created->name = fmt::format("thread {}", created->thread_id);
+
+            registry.buffers.push_back(created);
+            return created;
+        }();
+
+        return *buffer;
+    }
+
+    std::string escapeJson(std::string_view text) {
+        std::string escaped;
+        escaped.reserve(text.size());
+
+        for (const auto c : text) {
+            if (c == '"' || c == '\\') {
+                escaped += '\\';
+                escaped += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                // json forbids raw control characters in strings
+                escaped += fmt::format("\\u{:04x}", static_cast<unsigned char>(c));
+            } else {
+                escaped += c;
+            }
+        }
+
+        return escaped;
+    }
+}  // namespace
+
+void CpuProfiler::record(const char *name, std::uint64_t begin, std::uint64_t end) {
+    auto &buffer = getThreadBuffer();
+
+    const auto head = buffer.head.load(std::memory_order_relaxed);
+    buffer.events[head % events_per_thread] = {name, begin, end};
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void CpuProfiler::setThreadName(std::string name) {
+    auto &buffer = getThreadBuffer();
+
+    auto lock = std::scoped_lock(getRegistry().mutex);
+    buffer.name = std::move(name);
+}
+
+void CpuProfiler::exportChromeTrace(const std::filesystem::path &path) {
+    auto &registry = getRegistry();
+    auto lock = std::scoped_lock(registry.mutex);
+
+    std::FILE *file = std::fopen(path.string().c_str(), "w");
+    if (file == nullptr) {
+        throw std::runtime_error(fmt::format("failed to open {} to export the cpu trace!", path.string()));
+    }
+
+    fmt::print(file, "{{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+
+    bool first = true;
+    const auto separator = [&] {
+        if (!first) {
+            std::fputc(',', file);
+        }
+        first = false;
+    };
+
+    for (const auto &buffer : registry.buffers) {
+        separator();
+        fmt::print(file, "\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}", buffer->thread_id, escapeJson(buffer->name));
+
+        const auto head = buffer->head.load(std::memory_order_acquire);
+        const auto count = std::min<std::uint64_t>(head, events_per_thread);
+
+        for (auto i = head - count; i < head; ++i) {
+            const auto &event = buffer->events[i % events_per_thread];
+
+            // complete events, chrome expects microseconds
+            separator();
+            fmt::print(
+                file, "\n{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":0,\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f}}}", escapeJson(event.name), buffer->thread_id,
+                static_cast<double>(event.begin) / 1e3, static_cast<double>(event.end - event.begin) / 1e3);
+        }
+    }
+
+    fmt::print(file, "\n]}}\n");
+
+    if (std::fclose(file) != 0) {
+        throw std::runtime_error(fmt::format("failed to write the cpu trace to {}!", path.string()));
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "config.hpp"
+#include "utility.hpp"
+
+// Records named cpu zones into a ring buffer per thread and exports them to the chrome trace format (chrome://tracing, perfetto).
+// Recording a zone only touches the calling thread's buffer, the registry lock is taken once per thread when its buffer is created.
+class CpuProfiler final {
+  public:
+    struct Event {
+        // zone names must outlive the profiler, string literals in practice
+        const char *name = nullptr;
+        // nanoseconds since the profiler's epoch
+        std::uint64_t begin = 0;
+        std::uint64_t end = 0;
+    };
+
+    // latest events of each thread kept for export, older ones are overwritten
+    static constexpr std::size_t events_per_thread = 16384;
+
+  public:
+    [[nodiscard]] static std::uint64_t now() {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+    }
+
+    static void record(const char *name, std::uint64_t begin, std::uint64_t end);
+
+    // shows up as the thread's name in the trace, the calling thread is named "thread <id>" otherwise
+    static void setThreadName(std::string name);
+
+    // events still being written by other threads may be torn, export once the recorded threads are idle
+    static void exportChromeTrace(const std::filesystem::path &path);
+
+  private:
+    static inline const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+};
+
+// Records the time between its construction and its destruction, compiled out when config::enable_cpu_profiler is false.
+class CpuZone final : public NoCopy, public NoMove {
+  public:
+    explicit CpuZone(const char *_name) : name(_name) {
+        if constexpr (config::enable_cpu_profiler) {
+            begin = CpuProfiler::now();
+        }
+    }
+
+    ~CpuZone() {
+        if constexpr (config::enable_cpu_profiler) {
+            CpuProfiler::record(name, begin, CpuProfiler::now());
+        }
+    }
+
+  private:
+    const char *name;
+    std::uint64_t begin = 0;
+};
+
+#define CPU_ZONE_CONCAT_IMPL(a, b) a##b
+#define CPU_ZONE_CONCAT(a, b) CPU_ZONE_CONCAT_IMPL(a, b)
+#define CPU_ZONE(name) const CpuZone CPU_ZONE_CONCAT(cpu_zone_, __LINE__)(name)
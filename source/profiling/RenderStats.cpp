@@ -0,0 +1,32 @@
+#include "profiling/RenderStats.hpp"
+
+FrameStats RenderStats::collect() {
+    std::array<std::uint64_t, static_cast<std::size_t>(RenderCounter::COUNT)> totals{};
+
+    for (auto &shard : shards) {
+        for (std::size_t counter = 0; counter < totals.size(); ++counter) {
+            totals[counter] += shard.counters[counter].exchange(0, std::memory_order_relaxed);
+        }
+    }
+
+    const auto total = [&](RenderCounter counter) { return totals[static_cast<std::size_t>(counter)]; };
+
+    FrameStats stats;
+    stats.draws = total(RenderCounter::DRAWS);
+    stats.instances = total(RenderCounter::INSTANCES);
+    stats.triangles = total(RenderCounter::TRIANGLES);
+
+    stats.pipeline_binds = total(RenderCounter::PIPELINE_BINDS);
+    stats.descriptor_binds = total(RenderCounter::DESCRIPTOR_BINDS);
+    stats.vertex_buffer_binds = total(RenderCounter::VERTEX_BUFFER_BINDS);
+    stats.index_buffer_binds = total(RenderCounter::INDEX_BUFFER_BINDS);
+
+    stats.bytes_uploaded = total(RenderCounter::BYTES_UPLOADED);
+    stats.descriptor_writes = total(RenderCounter::DESCRIPTOR_WRITES);
+    stats.allocations = total(RenderCounter::ALLOCATIONS);
+
+    stats.fence_wait_ms = static_cast<double>(total(RenderCounter::FENCE_WAIT_NS)) / 1e6;
+    stats.acquire_wait_ms = static_cast<double>(total(RenderCounter::ACQUIRE_WAIT_NS)) / 1e6;
+
+    return stats;
+}
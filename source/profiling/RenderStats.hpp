@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "utility.hpp"
+
+enum class RenderCounter : std::uint32_t {
+    DRAWS,
+    // gpu-culled batches count every object they may draw, the culling happens after recording
+    INSTANCES,
+    TRIANGLES,
+
+    PIPELINE_BINDS,
+    DESCRIPTOR_BINDS,
+    VERTEX_BUFFER_BINDS,
+    INDEX_BUFFER_BINDS,
+
+    BYTES_UPLOADED,
+    DESCRIPTOR_WRITES,
+    ALLOCATIONS,
+
+    FENCE_WAIT_NS,
+    ACQUIRE_WAIT_NS,
+
+    COUNT,
+};
+
+// totals of one frame, as returned by RenderStats::collect()
+struct FrameStats {
+    std::uint64_t draws = 0;
+    std::uint64_t instances = 0;
+    std::uint64_t triangles = 0;
+
+    std::uint64_t pipeline_binds = 0;
+    std::uint64_t descriptor_binds = 0;
+    std::uint64_t vertex_buffer_binds = 0;
+    std::uint64_t index_buffer_binds = 0;
+
+    std::uint64_t bytes_uploaded = 0;
+    std::uint64_t descriptor_writes = 0;
+    std::uint64_t allocations = 0;
+
+    // time the render thread spent blocked
+    double fence_wait_ms = 0.0;
+    double acquire_wait_ms = 0.0;
+};
+
+// Always-on counters incremented by the renderer and the resource classes from any thread.
+// Threads are spread over cache-line sized shards so that parallel recording doesn't contend on a single atomic.
+class RenderStats final {
+  public:
+    static void add(RenderCounter counter, std::uint64_t value = 1) {
+        shards[shardIndex()].counters[static_cast<std::size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+    }
+
+    // sums and resets every counter, increments racing with it are counted in the next call
+    [[nodiscard]] static FrameStats collect();
+
+    // adds the time between its construction and its destruction to a *_NS counter
+    class Timer final : public NoCopy, public NoMove {
+      public:
+        explicit Timer(RenderCounter _counter) : counter(_counter), begin(std::chrono::steady_clock::now()) {}
+        ~Timer() {
+            add(counter, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count()));
+        }
+
+      private:
+        RenderCounter counter;
+        std::chrono::steady_clock::time_point begin;
+    };
+
+  private:
+    static constexpr std::size_t shard_count = 16;
+
+    struct alignas(64) Shard {
+        std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(RenderCounter::COUNT)> counters;
+    };
+
+    static std::size_t shardIndex() {
+        static std::atomic<std::size_t> next_shard{0};
+        thread_local const std::size_t shard = next_shard.fetch_add(1, std::memory_order_relaxed) % shard_count;
+        return shard;
+    }
+
+    // zero initialized, like every static
+    static inline std::array<Shard, shard_count> shards;
+};
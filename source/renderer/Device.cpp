@@ -1,34 +1,64 @@
 #include "renderer/Device.hpp"
 #include <vulkan/vulkan_core.h>
 
+#include <algorithm>
+#include <array>
+#include <limits>
 #include <set>
 #include <stdexcept>
 #include <unordered_set>
 
 #include "config.hpp"
 #include "renderer/Instance.hpp"
+#include "renderer/MemoryBudget.hpp"
 #include "renderer/sync/CommandBuffer.hpp"
+#include "renderer/sync/CommandPoolRecycler.hpp"
+#include "renderer/sync/FencePool.hpp"
+#include "renderer/sync/SemaphorePool.hpp"
 
 Device::Device(std::shared_ptr<Instance> instance) : instance(std::move(instance)) {
     physical_device = pickPhysicalDevices();
+    queue_family_indices = findQueueFamilies(physical_device);
 
     vkGetPhysicalDeviceProperties(physical_device, &physical_device_properties);
     vkGetPhysicalDeviceFeatures(physical_device, &physical_device_features);
 
+    VkPhysicalDeviceVulkan12Features vulkan12Features{};
+    vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+
+    VkPhysicalDeviceFeatures2 features{};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &vulkan12Features;
+
+    vkGetPhysicalDeviceFeatures2(physical_device, &features);
+    draw_indirect_count_support = vulkan12Features.drawIndirectCount == VK_TRUE;
+    memory_budget_support = checkDeviceExtensionSupport(physical_device, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+
     device = createLogicalDevice();
     allocator = createAllocator();
+    memory_budget = std::make_unique<MemoryBudget>(physical_device, allocator);
+
+    fence_pool = std::make_unique<FencePool>(device);
+    semaphore_pool = std::make_unique<SemaphorePool>(device);
+    graphics_command_pools = std::make_unique<CommandPoolRecycler>(device, queue_family_indices.graphics_family.value());
 }
 
 Device::~Device() {
+    graphics_command_pools.reset();
+    semaphore_pool.reset();
+    fence_pool.reset();
+    memory_budget.reset();
+
     vmaDestroyAllocator(allocator);
     vkDestroyDevice(device, nullptr);
 }
 
 VkDevice Device::createLogicalDevice() {
-    auto indices = findQueueFamilies(physical_device);
+    const auto &indices = queue_family_indices;
 
     std::vector<VkDeviceQueueCreateInfo> queueInfos;
-    std::set<uint32_t> uniqueQueueFamilies = {indices.graphics_family.value(), indices.present_family.value()};
+    std::set<uint32_t> uniqueQueueFamilies = {
+        indices.graphics_family.value(), indices.present_family.value(), indices.transfer_family.value(), indices.compute_family.value()};
 
     float queuePriority = 1.0f;
     for (uint32_t queueFamily : uniqueQueueFamilies) {
@@ -43,16 +73,33 @@ VkDevice Device::createLogicalDevice() {
     }
 
     VkPhysicalDeviceFeatures deviceFeatures{};
+    deviceFeatures.multiDrawIndirect = physical_device_features.multiDrawIndirect;
+    deviceFeatures.drawIndirectFirstInstance = physical_device_features.drawIndirectFirstInstance;
+    deviceFeatures.pipelineStatisticsQuery = physical_device_features.pipelineStatisticsQuery;
+    deviceFeatures.inheritedQueries = physical_device_features.inheritedQueries;
+
+    // the vulkan 1.2 struct replaces the individual feature structs, they can't be chained together
+    VkPhysicalDeviceVulkan12Features vulkan12Features{};
+    vulkan12Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    vulkan12Features.timelineSemaphore = VK_TRUE;
+    vulkan12Features.drawIndirectCount = draw_indirect_count_support ? VK_TRUE : VK_FALSE;
 
     VkDeviceCreateInfo deviceInfo{};
     deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    deviceInfo.pNext = &vulkan12Features;
 
     deviceInfo.queueCreateInfoCount = static_cast<uint32_t>(queueInfos.size());
     deviceInfo.pQueueCreateInfos = queueInfos.data();
     deviceInfo.pEnabledFeatures = &deviceFeatures;
 
-    deviceInfo.enabledExtensionCount = static_cast<uint32_t>(config::device_extensions.size());
-    deviceInfo.ppEnabledExtensionNames = config::device_extensions.data();
+    // optional extensions are enabled on top of the required ones
+    auto extensions = getRequiredExtensions();
+    if (memory_budget_support) {
+        extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+
+    deviceInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
+    deviceInfo.ppEnabledExtensionNames = extensions.data();
 
     deviceInfo.enabledLayerCount = 0;
 
@@ -64,6 +111,7 @@ VkDevice Device::createLogicalDevice() {
     vkGetDeviceQueue(vk_device, indices.graphics_family.value(), 0, &graphics_queue);
     vkGetDeviceQueue(vk_device, indices.present_family.value(), 0, &present_queue);
     vkGetDeviceQueue(vk_device, indices.transfer_family.value(), 0, &transfer_queue);
+    vkGetDeviceQueue(vk_device, indices.compute_family.value(), 0, &compute_queue);
 
     return vk_device;
 }
@@ -73,6 +121,9 @@ VmaAllocator Device::createAllocator() {
     allocatorInfo.physicalDevice = physical_device;
     allocatorInfo.device = device;
     allocatorInfo.instance = instance->getInstance();
+    allocatorInfo.vulkanApiVersion = VK_API_VERSION_1_2;
+    // physical device properties 2 is core in vulkan 1.1, the memory budget extension is all VMA needs
+    allocatorInfo.flags = memory_budget_support ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : 0;
 
     VmaAllocator vma_allocator = nullptr;
     if (vmaCreateAllocator(&allocatorInfo, &vma_allocator) != VK_SUCCESS) {
@@ -91,30 +142,130 @@ VmaAllocator Device::createAllocator() {
     std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
     vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
 
-    int i = 0;
-    for (const auto &queueFamily : queueFamilies) {
-        if (queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) {
+    for (uint32_t i = 0; i < queueFamilyCount; ++i) {
+        const auto flags = queueFamilies[i].queueFlags;
+
+        if ((flags & VK_QUEUE_GRAPHICS_BIT) && !indices.graphics_family.has_value()) {
             indices.graphics_family = i;
         }
-        if (queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT) {
+        if ((flags & VK_QUEUE_TRANSFER_BIT) && !indices.transfer_family.has_value()) {
             indices.transfer_family = i;
         }
+        if ((flags & VK_QUEUE_COMPUTE_BIT) && !(flags & VK_QUEUE_GRAPHICS_BIT) && !indices.compute_family.has_value()) {
+            indices.compute_family = i;
+        }
 
+        // a headless instance never presents
         VkBool32 presentSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, instance->getSurface(), &presentSupport);
+        if (instance->isHeadless()) {
+            presentSupport = (flags & VK_QUEUE_GRAPHICS_BIT) ? VK_TRUE : VK_FALSE;
+        } else {
+            vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, i, instance->getSurface(), &presentSupport);
+        }
 
-        if (presentSupport) {
+        if (presentSupport && !indices.present_family.has_value()) {
             indices.present_family = i;
         }
+    }
 
-        if (indices.isComplete()) break;
-
-        i++;
+    // every device exposes a family supporting both graphics and compute
+    if (!indices.compute_family.has_value() && indices.graphics_family.has_value() && (queueFamilies[*indices.graphics_family].queueFlags & VK_QUEUE_COMPUTE_BIT)) {
+        indices.compute_family = indices.graphics_family;
     }
 
     return indices;
 }
 
+std::uint32_t Device::getQueueFamilyIndex(QueueFamilyType type) const {
+    switch (type) {
+        case QueueFamilyType::GRAPHICS:
+            return queue_family_indices.graphics_family.value();
+
+        case QueueFamilyType::PRESENT:
+            return queue_family_indices.present_family.value();
+
+        case QueueFamilyType::TRANSFER:
+            return queue_family_indices.transfer_family.value();
+
+        case QueueFamilyType::COMPUTE:
+            return queue_family_indices.compute_family.value();
+
+        default:
+            throw std::runtime_error("got an incorect queue family type!");
+    }
+}
+
+void Device::immediateSubmit(const std::function<void(const CommandBuffer &)> &record) const {
+    const auto commands = graphics_command_pools->acquire();
+    const auto cmd = CommandBuffer(commands.command_buffer);
+
+    try {
+        cmd.begin();
+        record(cmd);
+        cmd.end();
+    } catch (...) {
+        graphics_command_pools->release(commands);
+        throw;
+    }
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &cmd.getCommandBuffer();
+
+    const auto fence = fence_pool->acquire();
+
+    // waiting on a fence only blocks on this submission, unlike vkQueueWaitIdle
+    if (submit(QueueFamilyType::GRAPHICS, submitInfo, fence) != VK_SUCCESS) {
+        fence_pool->release(fence);
+        graphics_command_pools->release(commands);
+        throw std::runtime_error("failed to submit immediate commands!");
+    }
+    vkWaitForFences(device, 1, &fence, VK_TRUE, std::numeric_limits<std::uint64_t>::max());
+
+    fence_pool->release(fence);
+    graphics_command_pools->release(commands);
+}
+
+VkResult Device::submit(QueueFamilyType type, const VkSubmitInfo &submitInfo, VkFence fence) const {
+    std::scoped_lock lock(getQueueMutex(type));
+    return vkQueueSubmit(getQueue(type), 1, &submitInfo, fence);
+}
+
+VkResult Device::present(const VkPresentInfoKHR &presentInfo) const {
+    std::scoped_lock lock(getQueueMutex(QueueFamilyType::PRESENT));
+    return vkQueuePresentKHR(present_queue, &presentInfo);
+}
+
+std::mutex &Device::getQueueMutex(QueueFamilyType type) const {
+    constexpr std::array types = {QueueFamilyType::GRAPHICS, QueueFamilyType::PRESENT, QueueFamilyType::TRANSFER, QueueFamilyType::COMPUTE};
+
+    const auto queue = getQueue(type);
+    const auto it = std::find_if(types.begin(), types.end(), [&](QueueFamilyType other) { return getQueue(other) == queue; });
+    return queue_mutexes[static_cast<std::size_t>(*it)];
+}
+
+VkFormat Device::findSupportedFormat(std::span<const VkFormat> candidates, VkImageTiling tiling, VkFormatFeatureFlags features) const {
+    for (const auto format : candidates) {
+        VkFormatProperties properties;
+        vkGetPhysicalDeviceFormatProperties(physical_device, format, &properties);
+
+        const auto supported = tiling == VK_IMAGE_TILING_LINEAR ? properties.linearTilingFeatures : properties.optimalTilingFeatures;
+        if ((supported & features) == features) {
+            return format;
+        }
+    }
+
+    throw std::runtime_error("failed to find a supported format!");
+}
+
+VkFormat Device::findDepthFormat() const {
+    // smallest format first, the renderer doesn't use stencil
+    constexpr std::array candidates = {VK_FORMAT_D16_UNORM, VK_FORMAT_X8_D24_UNORM_PACK32, VK_FORMAT_D32_SFLOAT, VK_FORMAT_D24_UNORM_S8_UINT, VK_FORMAT_D32_SFLOAT_S8_UINT};
+    return findSupportedFormat(candidates, VK_IMAGE_TILING_OPTIMAL, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
+}
+
 VkPhysicalDevice Device::pickPhysicalDevices() {
     uint32_t deviceCount = 0;
     vkEnumeratePhysicalDevices(instance->getInstance(), &deviceCount, nullptr);
@@ -141,20 +292,60 @@ VkPhysicalDevice Device::pickPhysicalDevices() {
 bool Device::isDeviceSuitable(VkPhysicalDevice physicalDevice) const {
     auto indices = findQueueFamilies(physicalDevice);
 
-    return indices.isComplete() && checkDeviceExtensionsSupport(physicalDevice);
+    return indices.isComplete() && checkDeviceExtensionsSupport(physicalDevice) && checkTimelineSemaphoreSupport(physicalDevice);
+}
+
+bool Device::checkTimelineSemaphoreSupport(VkPhysicalDevice physicalDevice) {
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+
+    if (properties.apiVersion < VK_API_VERSION_1_2) {
+        return false;
+    }
+
+    VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures{};
+    timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+
+    VkPhysicalDeviceFeatures2 features{};
+    features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    features.pNext = &timelineFeatures;
+
+    vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+
+    return timelineFeatures.timelineSemaphore == VK_TRUE;
+}
+
+std::vector<const char *> Device::getRequiredExtensions() const {
+    auto extensions = config::device_extensions;
+    if (instance->isHeadless()) {
+        std::erase_if(extensions, [](const char *extension) { return std::string_view(extension) == VK_KHR_SWAPCHAIN_EXTENSION_NAME; });
+    }
+
+    return extensions;
 }
 
-bool Device::checkDeviceExtensionsSupport(VkPhysicalDevice physicalDevice) {
+bool Device::checkDeviceExtensionsSupport(VkPhysicalDevice physicalDevice) const {
     uint32_t extensionCount = 0;
     vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
 
     std::vector<VkExtensionProperties> availableExtensions(extensionCount);
     vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, availableExtensions.data());
 
-    std::unordered_set<std::string> requiredExtensions(config::device_extensions.begin(), config::device_extensions.end());
+    const auto extensions = getRequiredExtensions();
+    std::unordered_set<std::string> requiredExtensions(extensions.begin(), extensions.end());
     for (const auto &extension : availableExtensions) {
         requiredExtensions.erase(extension.extensionName);
     }
 
     return requiredExtensions.empty();
 }
+
+bool Device::checkDeviceExtensionSupport(VkPhysicalDevice physicalDevice, std::string_view extension) {
+    uint32_t extensionCount = 0;
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, nullptr);
+
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    vkEnumerateDeviceExtensionProperties(physicalDevice, nullptr, &extensionCount, availableExtensions.data());
+
+    return std::ranges::any_of(availableExtensions, [&](const VkExtensionProperties &properties) { return extension == properties.extensionName; });
+}
@@ -3,12 +3,23 @@
 #include <vendor/vk_mem_alloc.h>
 #include <vulkan/vulkan_core.h>
 
+#include <array>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
 
 #include "utility.hpp"
 
 class Instance;
+class CommandBuffer;
+class FencePool;
+class SemaphorePool;
+class CommandPoolRecycler;
+class MemoryBudget;
 
 struct Mesh;
 
@@ -16,14 +27,19 @@ struct QueueFanmilyIndices final {
     std::optional<uint32_t> graphics_family;
     std::optional<uint32_t> present_family;
     std::optional<uint32_t> transfer_family;
+    // a family without graphics support when the device has one, the graphics family otherwise
+    std::optional<uint32_t> compute_family;
 
-    [[nodiscard]] constexpr bool isComplete() const { return graphics_family.has_value() && present_family.has_value() && transfer_family.has_value(); }
+    [[nodiscard]] constexpr bool isComplete() const {
+        return graphics_family.has_value() && present_family.has_value() && transfer_family.has_value() && compute_family.has_value();
+    }
 };
 
 enum class QueueFamilyType {
     GRAPHICS,
     PRESENT,
     TRANSFER,
+    COMPUTE,
 };
 
 class Device final : public NoCopy, public NoMove {
@@ -33,8 +49,22 @@ class Device final : public NoCopy, public NoMove {
 
     [[nodiscard]] const VkDevice &getDevice() const { return device; }
     [[nodiscard]] const VkPhysicalDevice &getPhysicalDevice() const { return physical_device; }
+    [[nodiscard]] const VkPhysicalDeviceProperties &getProperties() const { return physical_device_properties; }
 
     [[nodiscard]] const VmaAllocator &getAllocator() const { return allocator; }
+    // usage per resource category and per heap, budgets come from VK_EXT_memory_budget when the device supports it
+    [[nodiscard]] MemoryBudget &getMemoryBudget() const { return *memory_budget; }
+
+    // the pools synchronise themselves, they can be used from any thread
+    [[nodiscard]] FencePool &getFencePool() const { return *fence_pool; }
+    [[nodiscard]] SemaphorePool &getSemaphorePool() const { return *semaphore_pool; }
+
+    // records and submits one-off work on the graphics queue with recycled objects, then blocks until it has completed
+    void immediateSubmit(const std::function<void(const CommandBuffer &)> &record) const;
+
+    // queues need external synchronisation, every submission and presentation goes through these so that any thread can use them
+    VkResult submit(QueueFamilyType type, const VkSubmitInfo &submitInfo, VkFence fence) const;
+    VkResult present(const VkPresentInfoKHR &presentInfo) const;
 
     [[nodiscard]] constexpr const VkQueue &getQueue(QueueFamilyType type) const {
         switch (type) {
@@ -47,21 +77,51 @@ class Device final : public NoCopy, public NoMove {
             case QueueFamilyType::TRANSFER:
                 return transfer_queue;
 
+            case QueueFamilyType::COMPUTE:
+                return compute_queue;
+
             default:
                 break;
         }
     }
 
+    [[nodiscard]] std::uint32_t getQueueFamilyIndex(QueueFamilyType type) const;
+
+    // compute work submitted to a dedicated family can overlap the graphics queue instead of being interleaved with it
+    [[nodiscard]] bool hasDedicatedComputeQueue() const { return queue_family_indices.compute_family != queue_family_indices.graphics_family; }
+
+    // all optional, gpu-driven rendering needs the first two and compacts its draws with the third
+    [[nodiscard]] bool supportsMultiDrawIndirect() const { return physical_device_features.multiDrawIndirect == VK_TRUE; }
+    // indirect draws select their world matrix with their first instance
+    [[nodiscard]] bool supportsDrawIndirectFirstInstance() const { return physical_device_features.drawIndirectFirstInstance == VK_TRUE; }
+    [[nodiscard]] bool supportsDrawIndirectCount() const { return draw_indirect_count_support; }
+
+    // pipeline statistics queries, the second lets them stay active while secondary command buffers execute
+    [[nodiscard]] bool supportsPipelineStatisticsQuery() const { return physical_device_features.pipelineStatisticsQuery == VK_TRUE; }
+    [[nodiscard]] bool supportsInheritedQueries() const { return physical_device_features.inheritedQueries == VK_TRUE; }
+
     [[nodiscard]] QueueFanmilyIndices findQueueFamilies(VkPhysicalDevice physicalDevice) const;
 
+    // returns the first candidate supporting the features with the given tiling
+    [[nodiscard]] VkFormat findSupportedFormat(std::span<const VkFormat> candidates, VkImageTiling tiling, VkFormatFeatureFlags features) const;
+    [[nodiscard]] VkFormat findDepthFormat() const;
+
   private:
     VkDevice createLogicalDevice();
     VmaAllocator createAllocator();
 
     VkPhysicalDevice pickPhysicalDevices();
 
+    // the swapchain extension is left out for a headless instance
+    [[nodiscard]] std::vector<const char *> getRequiredExtensions() const;
+
     bool isDeviceSuitable(VkPhysicalDevice physicalDevice) const;
-    static bool checkDeviceExtensionsSupport(VkPhysicalDevice physicalDevice);
+    bool checkDeviceExtensionsSupport(VkPhysicalDevice physicalDevice) const;
+    static bool checkDeviceExtensionSupport(VkPhysicalDevice physicalDevice, std::string_view extension);
+    static bool checkTimelineSemaphoreSupport(VkPhysicalDevice physicalDevice);
+
+    // families may share a queue, they share its mutex too
+    [[nodiscard]] std::mutex &getQueueMutex(QueueFamilyType type) const;
 
   private:
     std::shared_ptr<Instance> instance;
@@ -70,6 +130,10 @@ class Device final : public NoCopy, public NoMove {
 
     VkPhysicalDeviceProperties physical_device_properties;
     VkPhysicalDeviceFeatures physical_device_features;
+    bool draw_indirect_count_support = false;
+    bool memory_budget_support = false;
+
+    QueueFanmilyIndices queue_family_indices;
 
     VkDevice device;
     VmaAllocator allocator;
@@ -77,4 +141,13 @@ class Device final : public NoCopy, public NoMove {
     VkQueue graphics_queue;
     VkQueue present_queue;
     VkQueue transfer_queue;
+    VkQueue compute_queue;
+
+    // indexed like QueueFamilyType
+    mutable std::array<std::mutex, 4> queue_mutexes;
+
+    std::unique_ptr<MemoryBudget> memory_budget;
+    std::unique_ptr<FencePool> fence_pool;
+    std::unique_ptr<SemaphorePool> semaphore_pool;
+    std::unique_ptr<CommandPoolRecycler> graphics_command_pools;
 };
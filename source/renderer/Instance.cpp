@@ -1,5 +1,4 @@
 #include <vulkan/vulkan_core.h>
-#define GLFW_INCLUDE_VULKAN
 #include <fmt/color.h>
 
 #include <stdexcept>
@@ -35,16 +34,25 @@ namespace {
     }
 }  // namespace
 
-Instance::Instance(const Window &window, std::string_view app_name, uint32_t app_version) {
-    instance = createInstance(app_name, config::engine_name, app_version, config::engine_version, getRequiredExtensions());
+Instance::Instance(const Window &window, std::string_view app_name, uint32_t app_version) : validation_enabled(config::enable_validation_layers) {
+    instance = createInstance(app_name, config::engine_name, app_version, config::engine_version, getRequiredExtensions(true));
     debug_messenger = createDebugMessenger();
 
     glfwCreateWindowSurface(instance, window.getWindow(), nullptr, &window_surface);
 }
 
+Instance::Instance(std::string_view app_name, bool enable_validation, uint32_t app_version) : validation_enabled(enable_validation) {
+    instance = createInstance(app_name, config::engine_name, app_version, config::engine_version, getRequiredExtensions(false));
+    if (validation_enabled) {
+        debug_messenger = createDebugMessenger();
+    }
+}
+
 Instance::~Instance() {
-    vkDestroySurfaceKHR(instance, window_surface, nullptr);
-    if constexpr (config::enable_validation_layers) {
+    if (window_surface != nullptr) {
+        vkDestroySurfaceKHR(instance, window_surface, nullptr);
+    }
+    if (debug_messenger != nullptr) {
         destroyDebugUtilsMessengerEXT(instance, debug_messenger, nullptr);
     }
 
@@ -53,7 +61,7 @@ Instance::~Instance() {
 
 VkInstance Instance::createInstance(
     std::string_view app_name, std::string_view engine_name, uint32_t app_version, uint32_t engine_version, std::vector<const char *> &&required_extensions) {
-    if constexpr (config::enable_validation_layers) {
+    if (validation_enabled) {
         if (!checkValidationLayerSupport()) {
             throw std::runtime_error("failed to query validation layers!");
         }
@@ -67,7 +75,8 @@ VkInstance Instance::createInstance(
     app_info.applicationVersion = app_version;
     app_info.engineVersion = engine_version;
 
-    app_info.apiVersion = VK_API_VERSION_1_0;
+    // timeline semaphores are core since vulkan 1.2
+    app_info.apiVersion = VK_API_VERSION_1_2;
 
     VkInstanceCreateInfo instance_info{};
     instance_info.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -78,7 +87,7 @@ VkInstance Instance::createInstance(
     instance_info.ppEnabledExtensionNames = required_extensions.data();
 
     VkDebugUtilsMessengerCreateInfoEXT debugMessenger{};
-    if constexpr (config::enable_validation_layers) {
+    if (validation_enabled) {
         instance_info.enabledLayerCount = static_cast<uint32_t>(config::validation_layers.size());
         instance_info.ppEnabledLayerNames = config::validation_layers.data();
 
@@ -121,18 +130,22 @@ void Instance::populateDebugMessenger(VkDebugUtilsMessengerCreateInfoEXT &debug_
     debug_info.pfnUserCallback = debugCallback;
 }
 
-std::vector<const char *> Instance::getRequiredExtensions() {
-    uint32_t extensionCount = 0;
-    const char **glfwExtensions = nullptr;
+std::vector<const char *> Instance::getRequiredExtensions(bool with_surface) const {
+    std::vector<const char *> extensions;
+    if (with_surface) {
+        uint32_t extensionCount = 0;
+        const char **glfwExtensions = glfwGetRequiredInstanceExtensions(&extensionCount);
 
-    glfwExtensions = glfwGetRequiredInstanceExtensions(&extensionCount);
+        extensions.assign(glfwExtensions, glfwExtensions + extensionCount);
+    }
 
-    std::vector<const char *> extensions(glfwExtensions, glfwExtensions + extensionCount);
-    if constexpr (config::enable_validation_layers) {
+    if (validation_enabled) {
         extensions.emplace_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
 		extensions.emplace_back(VK_EXT_DEBUG_REPORT_EXTENSION_NAME);
     }
-    extensions.emplace_back(VK_KHR_SURFACE_EXTENSION_NAME);
+    if (with_surface) {
+        extensions.emplace_back(VK_KHR_SURFACE_EXTENSION_NAME);
+    }
 
     for (const char *extensionName : extensions) {
         fmt::print("{}\n", extensionName);
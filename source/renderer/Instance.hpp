@@ -14,10 +14,13 @@ class Window;
 class Instance final : public NoCopy, public NoMove {
   public:
     Instance(const Window &window, std::string_view app_name, uint32_t app_version = VK_MAKE_VERSION(1, 0, 0));
+    // headless instance without a surface nor glfw, for tools and benchmarks rendering offscreen
+    Instance(std::string_view app_name, bool enable_validation, uint32_t app_version = VK_MAKE_VERSION(1, 0, 0));
     ~Instance();
 
     [[nodiscard]] VkInstance getInstance() const { return instance; }
     [[nodiscard]] VkSurfaceKHR getSurface() const { return window_surface; }
+    [[nodiscard]] bool isHeadless() const { return window_surface == nullptr; }
 
   private:
     VkInstance createInstance(
@@ -26,11 +29,13 @@ class Instance final : public NoCopy, public NoMove {
     VkDebugUtilsMessengerEXT createDebugMessenger();
     static void populateDebugMessenger(VkDebugUtilsMessengerCreateInfoEXT &debug_info);
 
-    static std::vector<const char *> getRequiredExtensions();
+    std::vector<const char *> getRequiredExtensions(bool with_surface) const;
     static bool checkValidationLayerSupport();
 
   private:
+    bool validation_enabled = false;
+
     VkInstance instance = nullptr;
     VkDebugUtilsMessengerEXT debug_messenger = nullptr;
-    VkSurfaceKHR window_surface;
+    VkSurfaceKHR window_surface = nullptr;
 };
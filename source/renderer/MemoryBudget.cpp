@@ -0,0 +1,147 @@
+#include "renderer/MemoryBudget.hpp"
+
+#include <fmt/color.h>
+
+const char *toString(MemoryCategory category) {
+    switch (category) {
+        case MemoryCategory::VERTEX_BUFFER:
+            return "vertex buffer";
+
+        case MemoryCategory::INDEX_BUFFER:
+            return "index buffer";
+
+        case MemoryCategory::UNIFORM_BUFFER:
+            return "uniform buffer";
+
+        case MemoryCategory::STORAGE_BUFFER:
+            return "storage buffer";
+
+        case MemoryCategory::STAGING_BUFFER:
+            return "staging buffer";
+
+        case MemoryCategory::TEXTURE:
+            return "texture";
+
+        case MemoryCategory::ATTACHMENT:
+            return "attachment";
+
+        default:
+            return "unknown";
+    }
+}
+
+MemoryBudget::MemoryBudget(VkPhysicalDevice physical_device, VmaAllocator _allocator) : allocator(_allocator) {
+    vkGetPhysicalDeviceMemoryProperties(physical_device, &memory_properties);
+    under_pressure.assign(memory_properties.memoryHeapCount, false);
+}
+
+void MemoryBudget::track(MemoryCategory category, VkDeviceSize size) {
+    const auto index = static_cast<std::size_t>(category);
+
+    category_bytes[index].fetch_add(size, std::memory_order_relaxed);
+    category_allocations[index].fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemoryBudget::untrack(MemoryCategory category, VkDeviceSize size) {
+    const auto index = static_cast<std::size_t>(category);
+
+    category_bytes[index].fetch_sub(size, std::memory_order_relaxed);
+    category_allocations[index].fetch_sub(1, std::memory_order_relaxed);
+}
+
+void MemoryBudget::update(std::uint32_t frame_index) {
+    // VMA only queries VK_EXT_memory_budget when the frame index changes
+    vmaSetCurrentFrameIndex(allocator, frame_index);
+
+    const auto heaps = getHeapBudgets();
+    const auto limit = soft_limit.load(std::memory_order_relaxed);
+
+    std::vector<HeapBudget> pressured;
+    for (const auto &heap : heaps) {
+        const bool above = heap.budget > 0 && static_cast<double>(heap.usage) > static_cast<double>(heap.budget) * limit;
+
+        if (above && !under_pressure[heap.heap_index]) {
+            fmt::print(
+                fmt::fg(fmt::color::orange) | fmt::emphasis::bold, "[memory budget] : heap {} uses {} MiB of its {} MiB budget\n", heap.heap_index,
+                heap.usage >> 20, heap.budget >> 20);
+        }
+
+        under_pressure[heap.heap_index] = above;
+        if (above) {
+            pressured.push_back(heap);
+        }
+    }
+
+    if (pressured.empty()) {
+        return;
+    }
+
+    // called without the lock so that a callback can remove itself
+    std::vector<PressureCallback> callbacks;
+    {
+        auto lock = std::scoped_lock(callback_mutex);
+        for (const auto &[id, callback] : pressure_callbacks) {
+            callbacks.push_back(callback);
+        }
+    }
+
+    for (const auto &heap : pressured) {
+        for (const auto &callback : callbacks) {
+            callback(heap);
+        }
+    }
+}
+
+MemoryReport MemoryBudget::getReport() const {
+    MemoryReport report;
+    report.heaps = getHeapBudgets();
+
+    for (std::size_t category = 0; category < report.category_bytes.size(); ++category) {
+        report.category_bytes[category] = category_bytes[category].load(std::memory_order_relaxed);
+        report.category_allocations[category] = category_allocations[category].load(std::memory_order_relaxed);
+    }
+
+    return report;
+}
+
+std::string MemoryBudget::buildStatsJson(bool detailed) const {
+    char *stats = nullptr;
+    vmaBuildStatsString(allocator, &stats, detailed ? VK_TRUE : VK_FALSE);
+
+    std::string json = stats != nullptr ? stats : "";
+    vmaFreeStatsString(allocator, stats);
+
+    return json;
+}
+
+std::uint32_t MemoryBudget::addPressureCallback(PressureCallback callback) {
+    auto lock = std::scoped_lock(callback_mutex);
+
+    const auto id = next_callback_id++;
+    pressure_callbacks.emplace_back(id, std::move(callback));
+
+    return id;
+}
+
+void MemoryBudget::removePressureCallback(std::uint32_t id) {
+    auto lock = std::scoped_lock(callback_mutex);
+    std::erase_if(pressure_callbacks, [&](const auto &entry) { return entry.first == id; });
+}
+
+std::vector<HeapBudget> MemoryBudget::getHeapBudgets() const {
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets{};
+    vmaGetBudget(allocator, budgets.data());
+
+    std::vector<HeapBudget> heaps(memory_properties.memoryHeapCount);
+    for (std::uint32_t i = 0; i < memory_properties.memoryHeapCount; ++i) {
+        heaps[i].heap_index = i;
+        heaps[i].flags = memory_properties.memoryHeaps[i].flags;
+
+        heaps[i].block_bytes = budgets[i].blockBytes;
+        heaps[i].allocation_bytes = budgets[i].allocationBytes;
+        heaps[i].usage = budgets[i].usage;
+        heaps[i].budget = budgets[i].budget;
+    }
+
+    return heaps;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <vendor/vk_mem_alloc.h>
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "utility.hpp"
+
+enum class MemoryCategory : std::uint32_t {
+    VERTEX_BUFFER,
+    INDEX_BUFFER,
+    UNIFORM_BUFFER,
+    STORAGE_BUFFER,
+    STAGING_BUFFER,
+    TEXTURE,
+    ATTACHMENT,
+
+    COUNT,
+};
+
+[[nodiscard]] const char *toString(MemoryCategory category);
+
+struct HeapBudget {
+    std::uint32_t heap_index = 0;
+    VkMemoryHeapFlags flags = 0;
+
+    // VkDeviceMemory blocks allocated by VMA and the part of them actually used by allocations
+    VkDeviceSize block_bytes = 0;
+    VkDeviceSize allocation_bytes = 0;
+
+    // usage of the whole process and what it may use, from VK_EXT_memory_budget when supported, estimated by VMA otherwise
+    VkDeviceSize usage = 0;
+    VkDeviceSize budget = 0;
+};
+
+struct MemoryReport {
+    std::vector<HeapBudget> heaps;
+
+    // bytes and number of live allocations made by the engine's resources, per category
+    std::array<VkDeviceSize, static_cast<std::size_t>(MemoryCategory::COUNT)> category_bytes{};
+    std::array<std::uint64_t, static_cast<std::size_t>(MemoryCategory::COUNT)> category_allocations{};
+};
+
+// Tracks the memory used by the engine's resources per category and the budget of every heap.
+// Systems that can give memory back, e.g. streaming, register a pressure callback called every frame while a heap is above the soft limit.
+class MemoryBudget final : public NoCopy, public NoMove {
+  public:
+    using PressureCallback = std::function<void(const HeapBudget &heap)>;
+
+  public:
+    MemoryBudget(VkPhysicalDevice physical_device, VmaAllocator _allocator);
+
+    // called by the resources when their allocation is created and destroyed, from any thread
+    void track(MemoryCategory category, VkDeviceSize size);
+    void untrack(MemoryCategory category, VkDeviceSize size);
+
+    // refreshes the budget, once per frame, and calls the pressure callbacks for every heap above the soft limit
+    void update(std::uint32_t frame_index);
+
+    [[nodiscard]] MemoryReport getReport() const;
+    // VMA's json dump of every heap, memory type and block, with every allocation when detailed
+    [[nodiscard]] std::string buildStatsJson(bool detailed = false) const;
+
+    // fraction of a heap budget above which memory is under pressure
+    void setSoftLimit(float fraction) { soft_limit = fraction; }
+    [[nodiscard]] float getSoftLimit() const { return soft_limit; }
+
+    std::uint32_t addPressureCallback(PressureCallback callback);
+    void removePressureCallback(std::uint32_t id);
+
+  private:
+    [[nodiscard]] std::vector<HeapBudget> getHeapBudgets() const;
+
+  private:
+    VmaAllocator allocator;
+    VkPhysicalDeviceMemoryProperties memory_properties;
+
+    std::atomic<float> soft_limit{0.9f};
+
+    std::array<std::atomic<VkDeviceSize>, static_cast<std::size_t>(MemoryCategory::COUNT)> category_bytes{};
+    std::array<std::atomic<std::uint64_t>, static_cast<std::size_t>(MemoryCategory::COUNT)> category_allocations{};
+
+    std::mutex callback_mutex;
+    std::uint32_t next_callback_id = 0;
+    std::vector<std::pair<std::uint32_t, PressureCallback>> pressure_callbacks;
+
+    // heaps that were above the soft limit at the last update, a warning is printed when a heap goes above it
+    std::vector<bool> under_pressure;
+};
@@ -0,0 +1,69 @@
+#include "renderer/graphics/ComputePipeline.hpp"
+
+#include <cassert>
+#include <stdexcept>
+
+#include "profiling/RenderStats.hpp"
+#include "renderer/Device.hpp"
+#include "renderer/graphics/DescriptorSetLayout.hpp"
+#include "renderer/graphics/Shader.hpp"
+#include "renderer/graphics/ShaderLibrary.hpp"
+#include "renderer/sync/CommandBuffer.hpp"
+
+ComputePipeline::ComputePipeline(PipelineInfo &&pipelineInfo) : pipeline_info(std::move(pipelineInfo)) {
+    // pipeline layout
+    auto set_layout = pipeline_info.descriptor_set_layout->getLayout();
+
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = pipeline_info.push_constant_size;
+
+    VkPipelineLayoutCreateInfo pipelineLayoutInfo{};
+    pipelineLayoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+
+    pipelineLayoutInfo.setLayoutCount = 1;
+    pipelineLayoutInfo.pSetLayouts = &set_layout;
+
+    pipelineLayoutInfo.pushConstantRangeCount = pipeline_info.push_constant_size > 0 ? 1 : 0;
+    pipelineLayoutInfo.pPushConstantRanges = pipeline_info.push_constant_size > 0 ? &pushConstantRange : nullptr;
+
+    if (vkCreatePipelineLayout(pipeline_info.device->getDevice(), &pipelineLayoutInfo, nullptr, &pipeline_layout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create pipeline layout!");
+    }
+
+    // pipeline
+    const auto shader = pipeline_info.shader_library->load(pipeline_info.shader_path, ShaderStage::COMPUTE_SHADER);
+
+    VkComputePipelineCreateInfo computePipelineInfo{};
+    computePipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+
+    computePipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    computePipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    computePipelineInfo.stage.module = shader->getShaderModule();
+    computePipelineInfo.stage.pName = "main";
+
+    computePipelineInfo.layout = pipeline_layout;
+    computePipelineInfo.basePipelineHandle = nullptr;
+    computePipelineInfo.basePipelineIndex = -1;
+
+    if (vkCreateComputePipelines(pipeline_info.device->getDevice(), pipeline_info.pipeline_cache, 1, &computePipelineInfo, nullptr, &compute_pipeline) != VK_SUCCESS) {
+        vkDestroyPipelineLayout(pipeline_info.device->getDevice(), pipeline_layout, nullptr);
+        throw std::runtime_error("failed to create compute pipeline!");
+    }
+}
+
+ComputePipeline::~ComputePipeline() {
+    vkDestroyPipelineLayout(pipeline_info.device->getDevice(), pipeline_layout, nullptr);
+    vkDestroyPipeline(pipeline_info.device->getDevice(), compute_pipeline, nullptr);
+}
+
+void ComputePipeline::bind(const CommandBuffer &commandBuffer) const {
+    vkCmdBindPipeline(commandBuffer.getCommandBuffer(), VK_PIPELINE_BIND_POINT_COMPUTE, compute_pipeline);
+    RenderStats::add(RenderCounter::PIPELINE_BINDS);
+}
+
+void ComputePipeline::pushConstants(const CommandBuffer &commandBuffer, const void *data, std::uint32_t size) const {
+    assert(size <= pipeline_info.push_constant_size);
+    vkCmdPushConstants(commandBuffer.getCommandBuffer(), pipeline_layout, VK_SHADER_STAGE_COMPUTE_BIT, 0, size, data);
+}
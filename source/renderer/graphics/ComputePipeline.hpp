@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "utility.hpp"
+
+class Device;
+class ShaderLibrary;
+class DescriptorSetLayout;
+class CommandBuffer;
+
+class ComputePipeline final : public NoCopy, public NoMove {
+  public:
+    struct PipelineInfo {
+        std::shared_ptr<Device> device;
+        std::shared_ptr<ShaderLibrary> shader_library;
+        std::shared_ptr<DescriptorSetLayout> descriptor_set_layout;
+
+        std::string shader_path;
+        // a single range visible to the compute stage, 0 for none
+        std::uint32_t push_constant_size = 0;
+
+        VkPipelineCache pipeline_cache = nullptr;
+    };
+
+  public:
+    explicit ComputePipeline(PipelineInfo &&pipelineInfo);
+    ~ComputePipeline();
+
+    void bind(const CommandBuffer &commandBuffer) const;
+    void pushConstants(const CommandBuffer &commandBuffer, const void *data, std::uint32_t size) const;
+
+    [[nodiscard]] const std::shared_ptr<Device> &getDevice() const { return pipeline_info.device; }
+    [[nodiscard]] VkPipeline getPipeline() const { return compute_pipeline; }
+    [[nodiscard]] VkPipelineLayout getPipelineLayout() const { return pipeline_layout; }
+
+  private:
+    PipelineInfo pipeline_info;
+
+    VkPipeline compute_pipeline = nullptr;
+    VkPipelineLayout pipeline_layout = nullptr;
+};
@@ -14,6 +14,9 @@ namespace {
             case ShaderStage::FRAGMENT_SHADER:
                 return VK_SHADER_STAGE_FRAGMENT_BIT;
 
+            case ShaderStage::COMPUTE_SHADER:
+                return VK_SHADER_STAGE_COMPUTE_BIT;
+
             default:
                 throw std::runtime_error("unknown shader type!");
         }
@@ -4,18 +4,17 @@
 #include <utility>
 
 #include "renderer/Device.hpp"
-#include "renderer/Swapchain.hpp"
 #include "renderer/graphics/RenderPass.hpp"
 
-Framebuffer::Framebuffer(std::shared_ptr<Device> _device, const RenderPass &renderpass, const VkImageView &attachment, const VkExtent2D &extent)
-    : device(std::move(_device)) {
+Framebuffer::Framebuffer(std::shared_ptr<Device> _device, const RenderPass &renderpass, std::span<const VkImageView> attachments, const VkExtent2D &_extent)
+    : device(std::move(_device)), extent(_extent) {
     VkFramebufferCreateInfo framebufferInfo{};
     framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
 
     framebufferInfo.renderPass = renderpass.getPass();
 
-    framebufferInfo.attachmentCount = 1;
-    framebufferInfo.pAttachments = &attachment;
+    framebufferInfo.attachmentCount = static_cast<std::uint32_t>(attachments.size());
+    framebufferInfo.pAttachments = attachments.data();
 
     framebufferInfo.width = extent.width;
     framebufferInfo.height = extent.height;
@@ -28,11 +27,13 @@ Framebuffer::Framebuffer(std::shared_ptr<Device> _device, const RenderPass &rend
     }
 }
 
-Framebuffer::Framebuffer(Framebuffer &&other) noexcept : device(std::move(other.device)), framebuffer(std::exchange(other.framebuffer, nullptr)) {}
+Framebuffer::Framebuffer(Framebuffer &&other) noexcept
+    : device(std::move(other.device)), framebuffer(std::exchange(other.framebuffer, nullptr)), extent(other.extent) {}
 
 Framebuffer &Framebuffer::operator=(Framebuffer &&other) noexcept {
     device = std::move(other.device);
 	framebuffer = std::exchange(other.framebuffer, nullptr);
+    extent = other.extent;
 
     return *this;
 }
@@ -4,6 +4,7 @@
 
 #include <functional>
 #include <memory>
+#include <span>
 
 #include "utility.hpp"
 
@@ -14,14 +15,16 @@ class RenderPass;
 
 class Framebuffer {
   public:
-    Framebuffer(std::shared_ptr<Device> _device, const RenderPass &renderpass, const VkImageView &attachment, const VkExtent2D &extent);
+    Framebuffer(std::shared_ptr<Device> _device, const RenderPass &renderpass, std::span<const VkImageView> attachments, const VkExtent2D &_extent);
 
     Framebuffer(Framebuffer &&other) noexcept;
     Framebuffer &operator=(Framebuffer &&other) noexcept;
 
     [[nodiscard]] const VkFramebuffer &getFramebuffer() const { return framebuffer; }
+    [[nodiscard]] const VkExtent2D &getExtent() const { return extent; }
 
   private:
     std::shared_ptr<Device> device;
     VkFramebuffer framebuffer = nullptr;
+    VkExtent2D extent{};
 };
@@ -0,0 +1,190 @@
+#include "renderer/graphics/GpuCuller.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+
+#include "renderer/Device.hpp"
+#include "renderer/graphics/ComputePipeline.hpp"
+#include "renderer/graphics/DescriptorSetLayout.hpp"
+#include "renderer/graphics/Shader.hpp"
+#include "renderer/graphics/ressources/DecriptorSet.hpp"
+#include "renderer/graphics/ressources/DescriptorPool.hpp"
+#include "renderer/sync/AsyncCompute.hpp"
+#include "renderer/sync/CommandBuffer.hpp"
+#include "scene/FrustumCuller.hpp"
+
+namespace {
+    constexpr std::uint32_t workgroup_size = 64;
+
+    // push constant block of cull.comp
+    struct CullConstants {
+        std::array<glm::vec4, 6> planes;
+        std::uint32_t object_count;
+        std::uint32_t compact;
+    };
+
+    enum Binding : std::uint32_t {
+        OBJECTS = 0,
+        WORLD_MATRICES,
+        BATCHES,
+        COMMANDS,
+        COUNTS,
+    };
+}  // namespace
+
+GpuCuller::GpuCuller(std::shared_ptr<Device> _device, std::shared_ptr<ShaderLibrary> _shader_library, VkPipelineCache pipeline_cache, std::uint32_t _frame_count)
+    : device(std::move(_device)), frame_count(_frame_count), compact(device->supportsDrawIndirectCount()) {
+    if (!device->supportsMultiDrawIndirect()) {
+        throw std::runtime_error("gpu culling requires the multiDrawIndirect feature!");
+    }
+    if (!device->supportsDrawIndirectFirstInstance()) {
+        throw std::runtime_error("gpu culling requires the drawIndirectFirstInstance feature!");
+    }
+
+    std::vector<ShaderResource> shaderResources;
+    shaderResources.emplace_back(OBJECTS, ShaderResourceType::BUFFER_STORAGE, 1, ShaderStage::COMPUTE_SHADER, ShaderResourceMode::STATIC, "objects");
+    shaderResources.emplace_back(WORLD_MATRICES, ShaderResourceType::BUFFER_STORAGE, 1, ShaderStage::COMPUTE_SHADER, ShaderResourceMode::STATIC, "world matrices");
+    shaderResources.emplace_back(BATCHES, ShaderResourceType::BUFFER_STORAGE, 1, ShaderStage::COMPUTE_SHADER, ShaderResourceMode::STATIC, "batches");
+    shaderResources.emplace_back(COMMANDS, ShaderResourceType::BUFFER_STORAGE, 1, ShaderStage::COMPUTE_SHADER, ShaderResourceMode::STATIC, "commands");
+    shaderResources.emplace_back(COUNTS, ShaderResourceType::BUFFER_STORAGE, 1, ShaderStage::COMPUTE_SHADER, ShaderResourceMode::STATIC, "counts");
+
+    descriptor_set_layout = std::make_shared<DescriptorSetLayout>(device, shaderResources);
+    descriptor_pool = std::make_shared<DescriptorPool>(device, *descriptor_set_layout, frame_count);
+
+    ComputePipeline::PipelineInfo info;
+    info.device = device;
+    info.shader_library = std::move(_shader_library);
+    info.descriptor_set_layout = descriptor_set_layout;
+    info.shader_path = "cull.spv";
+    info.push_constant_size = sizeof(CullConstants);
+    info.pipeline_cache = pipeline_cache;
+
+    pipeline = std::make_unique<ComputePipeline>(std::move(info));
+}
+
+GpuCuller::~GpuCuller() = default;
+
+void GpuCuller::upload(std::span<const Object> objects, std::span<const std::uint32_t> _batch_first, std::span<const Buffer> world_buffers) {
+    if (world_buffers.size() != frame_count) {
+        throw std::runtime_error("gpu culling needs one world matrix buffer per frame in flight!");
+    }
+
+    object_count = static_cast<std::uint32_t>(objects.size());
+    batch_first.assign(_batch_first.begin(), _batch_first.end());
+
+    batch_size.resize(batch_first.size());
+    batch_triangles.assign(batch_first.size(), 0);
+    for (std::size_t batch = 0; batch < batch_first.size(); ++batch) {
+        const auto last = batch + 1 < batch_first.size() ? batch_first[batch + 1] : object_count;
+        batch_size[batch] = last - batch_first[batch];
+
+        for (auto object = batch_first[batch]; object < last; ++object) {
+            batch_triangles[batch] += objects[object].index_count / 3;
+        }
+    }
+
+    // storage buffers can't be empty
+    const auto objectCount = std::max<std::size_t>(objects.size(), 1);
+    const auto batchCount = std::max<std::size_t>(batch_first.size(), 1);
+
+    object_buffer = std::make_unique<Buffer>(Buffer::createStorageBuffer(objectCount * sizeof(Object), device));
+    object_buffer->write(std::as_bytes(objects));
+
+    batch_buffer = std::make_unique<Buffer>(Buffer::createStorageBuffer(batchCount * sizeof(std::uint32_t), device));
+    batch_buffer->write(std::as_bytes(std::span(batch_first)));
+
+    command_buffers.clear();
+    count_buffers.clear();
+    descriptor_sets.clear();
+
+    for (std::uint32_t frame = 0; frame < frame_count; ++frame) {
+        command_buffers.emplace_back(
+            device, Buffer::Type::SSBO, objectCount * sizeof(VkDrawIndexedIndirectCommand), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+            VMA_MEMORY_USAGE_GPU_ONLY);
+        count_buffers.emplace_back(
+            device, Buffer::Type::SSBO, batchCount * sizeof(std::uint32_t),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+
+        auto &set = descriptor_sets.emplace_back(device, descriptor_pool, descriptor_set_layout);
+        set.update(OBJECTS, *object_buffer);
+        set.update(WORLD_MATRICES, world_buffers[frame]);
+        set.update(BATCHES, *batch_buffer);
+        set.update(COMMANDS, command_buffers.back());
+        set.update(COUNTS, count_buffers.back());
+    }
+}
+
+void GpuCuller::record(const CommandBuffer &cmd, std::uint32_t frame_index, const Frustum &frustum) const {
+    if (object_count == 0) {
+        return;
+    }
+
+    recordCulling(cmd, frame_index, frustum);
+
+    VkMemoryBarrier afterCull{};
+    afterCull.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    afterCull.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    afterCull.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+
+    vkCmdPipelineBarrier(cmd.getCommandBuffer(), VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 1, &afterCull, 0, nullptr, 0, nullptr);
+}
+
+void GpuCuller::recordAsync(const CommandBuffer &cmd, std::uint32_t frame_index, const Frustum &frustum, const AsyncCompute &async_compute) const {
+    if (object_count == 0) {
+        return;
+    }
+
+    recordCulling(cmd, frame_index, frustum);
+
+    async_compute.releaseToGraphics(cmd, command_buffers[frame_index], VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT);
+    async_compute.releaseToGraphics(cmd, count_buffers[frame_index], VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT);
+}
+
+void GpuCuller::acquire(const CommandBuffer &cmd, std::uint32_t frame_index, const AsyncCompute &async_compute) const {
+    if (object_count == 0) {
+        return;
+    }
+
+    async_compute.acquireFromCompute(cmd, command_buffers[frame_index], VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
+    async_compute.acquireFromCompute(cmd, count_buffers[frame_index], VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
+}
+
+void GpuCuller::recordCulling(const CommandBuffer &cmd, std::uint32_t frame_index, const Frustum &frustum) const {
+    vkCmdFillBuffer(cmd.getCommandBuffer(), count_buffers[frame_index].getBuffer(), 0, VK_WHOLE_SIZE, 0);
+
+    // the cleared counts and last use of the commands by the indirect draws both come before the dispatch
+    VkMemoryBarrier beforeCull{};
+    beforeCull.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    beforeCull.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    beforeCull.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+
+    vkCmdPipelineBarrier(
+        cmd.getCommandBuffer(), VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &beforeCull, 0, nullptr, 0,
+        nullptr);
+
+    CullConstants constants{};
+    for (std::size_t plane = 0; plane < constants.planes.size(); ++plane) {
+        constants.planes[plane] = glm::vec4(frustum.normal_x[plane], frustum.normal_y[plane], frustum.normal_z[plane], frustum.distance[plane]);
+    }
+    constants.object_count = object_count;
+    constants.compact = compact ? 1 : 0;
+
+    pipeline->bind(cmd);
+    descriptor_sets[frame_index].bind(*pipeline, cmd);
+    pipeline->pushConstants(cmd, &constants, sizeof(constants));
+
+    cmd.dispatch(CommandBuffer::groupCount(object_count, workgroup_size));
+}
+
+void GpuCuller::drawBatch(const CommandBuffer &cmd, std::uint32_t frame_index, std::uint32_t batch) const {
+    const auto offset = static_cast<VkDeviceSize>(batch_first[batch]) * sizeof(VkDrawIndexedIndirectCommand);
+
+    if (compact) {
+        vkCmdDrawIndexedIndirectCount(
+            cmd.getCommandBuffer(), command_buffers[frame_index].getBuffer(), offset, count_buffers[frame_index].getBuffer(), batch * sizeof(std::uint32_t),
+            batch_size[batch], sizeof(VkDrawIndexedIndirectCommand));
+    } else {
+        vkCmdDrawIndexedIndirect(cmd.getCommandBuffer(), command_buffers[frame_index].getBuffer(), offset, batch_size[batch], sizeof(VkDrawIndexedIndirectCommand));
+    }
+}
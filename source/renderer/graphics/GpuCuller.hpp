@@ -0,0 +1,95 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <glm/vec4.hpp>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "renderer/graphics/ressources/Buffer.hpp"
+#include "utility.hpp"
+
+class Device;
+class ShaderLibrary;
+class CommandBuffer;
+class ComputePipeline;
+class DescriptorSetLayout;
+class DescriptorPool;
+class DescriptorSet;
+class AsyncCompute;
+
+struct Frustum;
+
+// Culls objects on the gpu and writes the indexed indirect draw of every visible one.
+// Objects are grouped in batches sharing a mesh and a pipeline, each batch is drawn by a single indirect call.
+// When drawIndirectCount is supported visible draws are compacted and counted per batch,
+// otherwise every object keeps its command slot and culled ones get an instance count of 0.
+class GpuCuller final : public NoCopy, public NoMove {
+  public:
+    // std430 layout of an object in cull.comp
+    struct Object {
+        // model-space bounding sphere, center in xyz and radius in w
+        glm::vec4 bounds;
+
+        std::uint32_t transform;
+        std::uint32_t batch;
+        std::uint32_t index_count;
+        std::uint32_t first_index;
+        std::int32_t vertex_offset;
+
+        // std430 rounds the stride up to the alignment of bounds
+        std::uint32_t padding[3];
+    };
+
+  public:
+    GpuCuller(std::shared_ptr<Device> _device, std::shared_ptr<ShaderLibrary> _shader_library, VkPipelineCache pipeline_cache, std::uint32_t _frame_count);
+    ~GpuCuller();
+
+    // objects must be sorted by batch, batch_first[b] is the index of the first object of batch b
+    // world_buffers[f] holds the row-major world matrices indexed by Object::transform in frame f
+    void upload(std::span<const Object> objects, std::span<const std::uint32_t> batch_first, std::span<const Buffer> world_buffers);
+
+    // records the culling dispatch and the barrier to the indirect draws, outside of any render pass
+    void record(const CommandBuffer &cmd, std::uint32_t frame_index, const Frustum &frustum) const;
+
+    // same as record() but on the compute queue of async_compute, the graphics command buffer acquires the written draws with acquire()
+    // before the render pass, in a submission waiting for the compute one at the draw indirect stage
+    void recordAsync(const CommandBuffer &cmd, std::uint32_t frame_index, const Frustum &frustum, const AsyncCompute &async_compute) const;
+    void acquire(const CommandBuffer &cmd, std::uint32_t frame_index, const AsyncCompute &async_compute) const;
+
+    // the caller binds the pipeline, descriptor sets and mesh buffers of the batch first
+    void drawBatch(const CommandBuffer &cmd, std::uint32_t frame_index, std::uint32_t batch) const;
+
+    [[nodiscard]] std::uint32_t getBatchCount() const { return static_cast<std::uint32_t>(batch_first.size()); }
+    // before culling, the number of objects the batch draws at most and their triangles
+    [[nodiscard]] std::uint32_t getBatchObjectCount(std::uint32_t batch) const { return batch_size[batch]; }
+    [[nodiscard]] std::uint64_t getBatchTriangleCount(std::uint32_t batch) const { return batch_triangles[batch]; }
+    [[nodiscard]] bool isCompacting() const { return compact; }
+
+  private:
+    void recordCulling(const CommandBuffer &cmd, std::uint32_t frame_index, const Frustum &frustum) const;
+
+  private:
+    std::shared_ptr<Device> device;
+    std::uint32_t frame_count;
+    bool compact;
+
+    std::shared_ptr<DescriptorSetLayout> descriptor_set_layout;
+    std::shared_ptr<DescriptorPool> descriptor_pool;
+    std::unique_ptr<ComputePipeline> pipeline;
+
+    std::uint32_t object_count = 0;
+    std::vector<std::uint32_t> batch_first;
+    std::vector<std::uint32_t> batch_size;
+    std::vector<std::uint64_t> batch_triangles;
+
+    std::unique_ptr<Buffer> object_buffer;
+    std::unique_ptr<Buffer> batch_buffer;
+
+    // one of each per frame in flight, written by the gpu every frame
+    std::vector<Buffer> command_buffers;
+    std::vector<Buffer> count_buffers;
+    std::vector<DescriptorSet> descriptor_sets;
+};
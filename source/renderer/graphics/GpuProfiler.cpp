@@ -0,0 +1,309 @@
+#include "renderer/graphics/GpuProfiler.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include "renderer/Device.hpp"
+#include "renderer/sync/CommandBuffer.hpp"
+
+GpuProfiler::Scope::Scope(GpuProfiler *_profiler, const CommandBuffer &_cmd, std::string_view name) : profiler(_profiler), cmd(_cmd) {
+    if (profiler) {
+        scope = profiler->begin(cmd, name);
+    }
+}
+
+GpuProfiler::Scope::~Scope() {
+    if (profiler) {
+        profiler->end(cmd, scope);
+    }
+}
+
+namespace {
+    // in bit order, the order the counters of a query are written in
+    constexpr VkQueryPipelineStatisticFlags collected_statistics =
+        VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT | VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT | VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+
+    constexpr std::size_t statistic_count = 7;
+}  // namespace
+
+GpuProfiler::GpuProfiler(
+    std::shared_ptr<Device> _device, std::uint32_t _frame_count, bool enable_pipeline_statistics, std::uint32_t _max_scopes, std::uint32_t _history_size)
+    : device(std::move(_device)), frame_count(_frame_count), max_scopes(_max_scopes), history_size(_history_size) {
+    const auto physicalDevice = device->getPhysicalDevice();
+    timestamp_period = device->getProperties().limits.timestampPeriod;
+
+    std::uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+
+    const auto validBits = queueFamilies[device->getQueueFamilyIndex(QueueFamilyType::GRAPHICS)].timestampValidBits;
+    timestamp_mask = validBits >= 64 ? std::numeric_limits<std::uint64_t>::max() : (std::uint64_t{1} << validBits) - 1;
+
+    if (!isSupported()) {
+        return;
+    }
+
+    frames.resize(frame_count);
+    for (auto &frame : frames) {
+        VkQueryPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+        poolInfo.queryCount = max_scopes * 2;
+
+        if (vkCreateQueryPool(device->getDevice(), &poolInfo, nullptr, &frame.pool) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create timestamp query pool!");
+        }
+    }
+
+    results.resize(static_cast<std::size_t>(max_scopes) * 4);
+
+    if (!enable_pipeline_statistics || !device->supportsPipelineStatisticsQuery()) {
+        return;
+    }
+
+    statistic_flags = collected_statistics;
+    inherited_statistics = device->supportsInheritedQueries() ? statistic_flags : 0;
+
+    for (auto &frame : frames) {
+        VkQueryPoolCreateInfo poolInfo{};
+        poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        poolInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        poolInfo.queryCount = max_statistics_scopes;
+        poolInfo.pipelineStatistics = statistic_flags;
+
+        if (vkCreateQueryPool(device->getDevice(), &poolInfo, nullptr, &frame.statistics_pool) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create pipeline statistics query pool!");
+        }
+    }
+
+    statistics_results.resize(static_cast<std::size_t>(max_statistics_scopes) * (statistic_count + 1));
+}
+
+GpuProfiler::~GpuProfiler() {
+    for (const auto &frame : frames) {
+        vkDestroyQueryPool(device->getDevice(), frame.pool, nullptr);
+        vkDestroyQueryPool(device->getDevice(), frame.statistics_pool, nullptr);
+    }
+}
+
+void GpuProfiler::beginFrame(const CommandBuffer &cmd, std::uint32_t frame_index) {
+    if (!isSupported()) {
+        return;
+    }
+
+    resolve(frame_index);
+    resolveStatistics(frame_index);
+
+    current_frame = frame_index;
+
+    auto &frame = frames[frame_index];
+    frame.scopes.clear();
+    vkCmdResetQueryPool(cmd.getCommandBuffer(), frame.pool, 0, max_scopes * 2);
+
+    if (collectsPipelineStatistics()) {
+        frame.statistics_scopes.clear();
+        vkCmdResetQueryPool(cmd.getCommandBuffer(), frame.statistics_pool, 0, max_statistics_scopes);
+    }
+}
+
+std::uint32_t GpuProfiler::begin(const CommandBuffer &cmd, std::string_view name, VkPipelineStageFlagBits stage) {
+    if (!isSupported()) {
+        return invalid_scope;
+    }
+
+    auto &frame = frames[current_frame];
+    if (frame.scopes.size() == max_scopes) {
+        return invalid_scope;
+    }
+
+    std::uint32_t id = 0;
+    {
+        std::lock_guard lock(mutex);
+
+        if (const auto it = scope_ids.find(name); it != scope_ids.end()) {
+            id = it->second;
+        } else {
+            id = static_cast<std::uint32_t>(histories.size());
+            scope_ids.emplace(std::string(name), id);
+            histories.push_back({std::string(name), {}, 0, 0.0});
+        }
+    }
+
+    const auto scope = static_cast<std::uint32_t>(frame.scopes.size());
+    frame.scopes.push_back(id);
+
+    vkCmdWriteTimestamp(cmd.getCommandBuffer(), stage, frame.pool, scope * 2);
+    return scope;
+}
+
+void GpuProfiler::end(const CommandBuffer &cmd, std::uint32_t scope, VkPipelineStageFlagBits stage) {
+    if (scope == invalid_scope) {
+        return;
+    }
+
+    vkCmdWriteTimestamp(cmd.getCommandBuffer(), stage, frames[current_frame].pool, scope * 2 + 1);
+}
+
+std::uint32_t GpuProfiler::beginStatistics(const CommandBuffer &cmd, std::string_view name) {
+    if (!collectsPipelineStatistics()) {
+        return invalid_scope;
+    }
+
+    auto &frame = frames[current_frame];
+    if (frame.statistics_scopes.size() == max_statistics_scopes) {
+        return invalid_scope;
+    }
+
+    std::uint32_t id = 0;
+    {
+        std::lock_guard lock(mutex);
+
+        if (const auto it = statistics_ids.find(name); it != statistics_ids.end()) {
+            id = it->second;
+        } else {
+            id = static_cast<std::uint32_t>(pipeline_statistics.size());
+            statistics_ids.emplace(std::string(name), id);
+            pipeline_statistics.emplace_back().name = std::string(name);
+        }
+    }
+
+    const auto scope = static_cast<std::uint32_t>(frame.statistics_scopes.size());
+    frame.statistics_scopes.push_back(id);
+
+    vkCmdBeginQuery(cmd.getCommandBuffer(), frame.statistics_pool, scope, 0);
+    return scope;
+}
+
+void GpuProfiler::endStatistics(const CommandBuffer &cmd, std::uint32_t scope) {
+    if (scope == invalid_scope) {
+        return;
+    }
+
+    vkCmdEndQuery(cmd.getCommandBuffer(), frames[current_frame].statistics_pool, scope);
+}
+
+void GpuProfiler::resolve(std::uint32_t frame_index) {
+    const auto &frame = frames[frame_index];
+    if (frame.scopes.empty()) {
+        return;
+    }
+
+    const auto queryCount = static_cast<std::uint32_t>(frame.scopes.size() * 2);
+
+    // no wait bit, a scope whose queries aren't available yet is skipped rather than stalling the frame
+    const auto result = vkGetQueryPoolResults(
+        device->getDevice(), frame.pool, 0, queryCount, queryCount * 2 * sizeof(std::uint64_t), results.data(), 2 * sizeof(std::uint64_t),
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+    if (result != VK_SUCCESS && result != VK_NOT_READY) {
+        return;
+    }
+
+    for (std::size_t scope = 0; scope < frame.scopes.size(); ++scope) {
+        const auto *begin = &results[scope * 4];
+        const auto *end = begin + 2;
+
+        if (begin[1] == 0 || end[1] == 0) {
+            continue;
+        }
+
+        // masking the difference handles a counter wrapping around between the two timestamps
+        const auto ticks = (end[0] - begin[0]) & timestamp_mask;
+        addSample(frame.scopes[scope], static_cast<double>(ticks) * timestamp_period / 1e6);
+    }
+}
+
+void GpuProfiler::resolveStatistics(std::uint32_t frame_index) {
+    const auto &frame = frames[frame_index];
+    if (frame.statistics_scopes.empty()) {
+        return;
+    }
+
+    const auto queryCount = static_cast<std::uint32_t>(frame.statistics_scopes.size());
+    constexpr auto stride = (statistic_count + 1) * sizeof(std::uint64_t);
+
+    const auto result = vkGetQueryPoolResults(
+        device->getDevice(), frame.statistics_pool, 0, queryCount, queryCount * stride, statistics_results.data(), stride,
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+
+    if (result != VK_SUCCESS && result != VK_NOT_READY) {
+        return;
+    }
+
+    std::lock_guard lock(mutex);
+
+    for (std::size_t scope = 0; scope < frame.statistics_scopes.size(); ++scope) {
+        const auto *values = &statistics_results[scope * (statistic_count + 1)];
+        if (values[statistic_count] == 0) {
+            continue;
+        }
+
+        auto &statistics = pipeline_statistics[frame.statistics_scopes[scope]];
+        statistics.input_assembly_vertices = values[0];
+        statistics.input_assembly_primitives = values[1];
+        statistics.vertex_shader_invocations = values[2];
+        statistics.clipping_invocations = values[3];
+        statistics.clipping_primitives = values[4];
+        statistics.fragment_shader_invocations = values[5];
+        statistics.compute_shader_invocations = values[6];
+    }
+}
+
+void GpuProfiler::addSample(std::uint32_t id, double milliseconds) {
+    std::lock_guard lock(mutex);
+
+    auto &history = histories[id];
+    if (history.samples.size() < history_size) {
+        history.samples.push_back(milliseconds);
+    } else {
+        history.samples[history.next] = milliseconds;
+    }
+
+    history.next = (history.next + 1) % history_size;
+    history.last = milliseconds;
+}
+
+std::vector<GpuProfiler::ScopeStats> GpuProfiler::getStats() const {
+    std::lock_guard lock(mutex);
+
+    std::vector<ScopeStats> stats;
+    stats.reserve(scope_ids.size());
+
+    for (const auto &[name, id] : scope_ids) {
+        const auto &history = histories[id];
+        if (history.samples.empty()) {
+            continue;
+        }
+
+        const auto [min, max] = std::minmax_element(history.samples.begin(), history.samples.end());
+
+        auto &scope = stats.emplace_back();
+        scope.name = name;
+        scope.last_ms = history.last;
+        scope.min_ms = *min;
+        scope.max_ms = *max;
+        scope.avg_ms = std::accumulate(history.samples.begin(), history.samples.end(), 0.0) / static_cast<double>(history.samples.size());
+        scope.sample_count = static_cast<std::uint32_t>(history.samples.size());
+    }
+
+    return stats;
+}
+
+std::vector<GpuProfiler::PipelineStatistics> GpuProfiler::getPipelineStatistics() const {
+    std::lock_guard lock(mutex);
+
+    std::vector<PipelineStatistics> statistics;
+    statistics.reserve(statistics_ids.size());
+
+    for (const auto &[name, id] : statistics_ids) {
+        statistics.push_back(pipeline_statistics[id]);
+    }
+
+    return statistics;
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "utility.hpp"
+
+class Device;
+class CommandBuffer;
+
+// Measures named scopes of the graphics command buffers with timestamp queries, and optionally counts their shader workload with pipeline statistics queries.
+// Every frame in flight has its own query pools, read back without waiting once the slot is reused, i.e. frame_count frames later.
+// Recording is done from the render thread only, getStats() and getPipelineStatistics() can be called from any thread.
+class GpuProfiler final : public NoCopy, public NoMove {
+  public:
+    static constexpr std::uint32_t invalid_scope = std::numeric_limits<std::uint32_t>::max();
+
+    struct ScopeStats {
+        std::string name;
+
+        // milliseconds, over the last history_size frames the scope ran in
+        double last_ms = 0.0;
+        double min_ms = 0.0;
+        double avg_ms = 0.0;
+        double max_ms = 0.0;
+
+        std::uint32_t sample_count = 0;
+    };
+
+    // counters of the last frame the scope was resolved in
+    struct PipelineStatistics {
+        std::string name;
+
+        std::uint64_t input_assembly_vertices = 0;
+        std::uint64_t input_assembly_primitives = 0;
+        std::uint64_t vertex_shader_invocations = 0;
+        std::uint64_t clipping_invocations = 0;
+        std::uint64_t clipping_primitives = 0;
+        std::uint64_t fragment_shader_invocations = 0;
+        std::uint64_t compute_shader_invocations = 0;
+    };
+
+    // writes the begin timestamp on construction and the end one on destruction, does nothing without a profiler
+    class Scope final : public NoCopy, public NoMove {
+      public:
+        Scope(GpuProfiler *_profiler, const CommandBuffer &_cmd, std::string_view name);
+        ~Scope();
+
+      private:
+        GpuProfiler *profiler;
+        const CommandBuffer &cmd;
+        std::uint32_t scope = invalid_scope;
+    };
+
+  public:
+    // pipeline statistics are only collected with enable_pipeline_statistics and a device supporting the query type
+    GpuProfiler(
+        std::shared_ptr<Device> _device, std::uint32_t _frame_count, bool enable_pipeline_statistics = false, std::uint32_t _max_scopes = 64,
+        std::uint32_t _history_size = 128);
+    ~GpuProfiler();
+
+    // reads back the timestamps of the previous submission of frame_index, which must have completed, and resets its queries
+    // recorded first in the frame's command buffer, outside of any render pass
+    void beginFrame(const CommandBuffer &cmd, std::uint32_t frame_index);
+
+    // returns the scope to pass to end(), scopes past max_scopes in a frame are dropped and return invalid_scope
+    // timestamps can't be written in a render pass whose contents are secondary command buffers, scopes surround it instead
+    [[nodiscard]] std::uint32_t begin(const CommandBuffer &cmd, std::string_view name, VkPipelineStageFlagBits stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+    void end(const CommandBuffer &cmd, std::uint32_t scope, VkPipelineStageFlagBits stage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+
+    // a pipeline statistics query is begun and ended outside of a render pass, or both within the same subpass
+    // secondary command buffers executed inside the scope are recorded with getInheritedStatistics() in their inheritance info
+    [[nodiscard]] std::uint32_t beginStatistics(const CommandBuffer &cmd, std::string_view name);
+    void endStatistics(const CommandBuffer &cmd, std::uint32_t scope);
+
+    // sorted by name
+    [[nodiscard]] std::vector<ScopeStats> getStats() const;
+    [[nodiscard]] std::vector<PipelineStatistics> getPipelineStatistics() const;
+
+    // false when the graphics queue has no valid timestamp bits, every call is then a no-op
+    [[nodiscard]] bool isSupported() const { return timestamp_mask != 0; }
+    [[nodiscard]] bool collectsPipelineStatistics() const { return statistic_flags != 0; }
+    // 0 without pipeline statistics or when the device can't keep them active across secondary command buffers
+    [[nodiscard]] VkQueryPipelineStatisticFlags getInheritedStatistics() const { return inherited_statistics; }
+
+  private:
+    void resolve(std::uint32_t frame_index);
+    void resolveStatistics(std::uint32_t frame_index);
+    void addSample(std::uint32_t id, double milliseconds);
+
+  private:
+    std::shared_ptr<Device> device;
+    std::uint32_t frame_count;
+    std::uint32_t max_scopes;
+    std::uint32_t history_size;
+
+    // nanoseconds per tick, and the bits of a timestamp the queue actually writes
+    double timestamp_period = 0.0;
+    std::uint64_t timestamp_mask = 0;
+
+    VkQueryPipelineStatisticFlags statistic_flags = 0;
+    VkQueryPipelineStatisticFlags inherited_statistics = 0;
+    static constexpr std::uint32_t max_statistics_scopes = 8;
+
+    struct FrameQueries {
+        VkQueryPool pool = nullptr;
+        // scope id of each begin/end pair written in the frame
+        std::vector<std::uint32_t> scopes;
+
+        VkQueryPool statistics_pool = nullptr;
+        // index in pipeline_statistics of each statistics query of the frame
+        std::vector<std::uint32_t> statistics_scopes;
+    };
+    std::vector<FrameQueries> frames;
+    std::uint32_t current_frame = 0;
+
+    struct History {
+        std::string name;
+        std::vector<double> samples;
+        std::size_t next = 0;
+        double last = 0.0;
+    };
+
+    mutable std::mutex mutex;
+    std::map<std::string, std::uint32_t, std::less<>> scope_ids;
+    std::vector<History> histories;
+
+    std::map<std::string, std::uint32_t, std::less<>> statistics_ids;
+    std::vector<PipelineStatistics> pipeline_statistics;
+
+    // reused by resolve(), an [timestamp, availability] pair per query
+    std::vector<std::uint64_t> results;
+    // reused by resolveStatistics(), the counters followed by the availability of each query
+    std::vector<std::uint64_t> statistics_results;
+};
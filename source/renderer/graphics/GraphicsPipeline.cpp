@@ -1,12 +1,15 @@
 #include "renderer/graphics/GraphicsPipeline.hpp"
 
+#include <cassert>
 #include <stdexcept>
+#include <utility>
 
-#include "renderer/Swapchain.hpp"
+#include "profiling/RenderStats.hpp"
 #include "renderer/graphics/DescriptorSetLayout.hpp"
 #include "renderer/graphics/RenderPass.hpp"
 #include "renderer/graphics/Renderer.hpp"
 #include "renderer/graphics/Shader.hpp"
+#include "renderer/graphics/ShaderLibrary.hpp"
 #include "renderer/sync/CommandBuffer.hpp"
 
 [[nodiscard]] VertexInputDescription Vertex::getVertexInputDescription() {
@@ -40,6 +43,82 @@
     return description;
 }
 
+[[nodiscard]] VertexInputDescription SpriteVertex::getVertexInputDescription() {
+    VertexInputDescription description;
+
+    VkVertexInputBindingDescription mainBinding{};
+    mainBinding.binding = 0;
+    mainBinding.stride = sizeof(SpriteVertex);
+    mainBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    description.bindings.push_back(mainBinding);
+
+    // position attribute
+    VkVertexInputAttributeDescription positionAttribute{};
+    positionAttribute.binding = 0;
+    positionAttribute.location = 0;
+    positionAttribute.format = VK_FORMAT_R32G32_SFLOAT;
+    positionAttribute.offset = offsetof(SpriteVertex, position);
+
+    description.attributes.push_back(positionAttribute);
+
+    // color attribute, unpacked to [0, 1] floats by the vertex fetch so the shaders are shared with Vertex
+    VkVertexInputAttributeDescription colorAttribute{};
+    colorAttribute.binding = 0;
+    colorAttribute.location = 1;
+    colorAttribute.format = VK_FORMAT_R8G8B8A8_UNORM;
+    colorAttribute.offset = offsetof(SpriteVertex, color);
+
+    description.attributes.push_back(colorAttribute);
+
+    return description;
+}
+
+template <VkFormat position_format>
+    requires(position_format == VK_FORMAT_R16G16B16A16_SNORM || position_format == VK_FORMAT_R16G16B16A16_SFLOAT)
+[[nodiscard]] VertexInputDescription BasicQuantizedVertex<position_format>::getVertexInputDescription() {
+    VertexInputDescription description;
+
+    VkVertexInputBindingDescription mainBinding{};
+    mainBinding.binding = 0;
+    mainBinding.stride = sizeof(BasicQuantizedVertex);
+    mainBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    description.bindings.push_back(mainBinding);
+
+    // position attribute, snorm16 is unpacked to [-1, 1] floats by the vertex fetch and the shader applies the dequantization
+    VkVertexInputAttributeDescription positionAttribute{};
+    positionAttribute.binding = 0;
+    positionAttribute.location = 0;
+    positionAttribute.format = position_format;
+    positionAttribute.offset = offsetof(BasicQuantizedVertex, position);
+
+    description.attributes.push_back(positionAttribute);
+
+    // color attribute, at the same location as in Vertex
+    VkVertexInputAttributeDescription colorAttribute{};
+    colorAttribute.binding = 0;
+    colorAttribute.location = 1;
+    colorAttribute.format = VK_FORMAT_R8G8B8A8_UNORM;
+    colorAttribute.offset = offsetof(BasicQuantizedVertex, color);
+
+    description.attributes.push_back(colorAttribute);
+
+    // octahedral normal attribute
+    VkVertexInputAttributeDescription normalAttribute{};
+    normalAttribute.binding = 0;
+    normalAttribute.location = 2;
+    normalAttribute.format = VK_FORMAT_R16G16_SNORM;
+    normalAttribute.offset = offsetof(BasicQuantizedVertex, normal);
+
+    description.attributes.push_back(normalAttribute);
+
+    return description;
+}
+
+template VertexInputDescription QuantizedVertex::getVertexInputDescription();
+template VertexInputDescription HalfQuantizedVertex::getVertexInputDescription();
+
 namespace {
     [[nodiscard]] VkPipelineShaderStageCreateInfo createShaderStage(const ShaderModule &shader) {
         VkPipelineShaderStageCreateInfo info{};
@@ -65,7 +144,7 @@ namespace {
     }
 
 	// TODO: make a more intuitive implementation
-    [[nodiscard]] VkPipelineVertexInputStateCreateInfo createVertexInputState(const nostd::not_null<VertexInputDescription> inputInfo) {
+    [[nodiscard]] VkPipelineVertexInputStateCreateInfo createVertexInputState(const nostd::not_null<const VertexInputDescription> inputInfo) {
         VkPipelineVertexInputStateCreateInfo info{};
         info.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
 
@@ -96,18 +175,18 @@ namespace {
         return info;
     }
 
-    [[nodiscard]] VkPipelineRasterizationStateCreateInfo createRasterizationState(VkPolygonMode polygonMode) {
+    [[nodiscard]] VkPipelineRasterizationStateCreateInfo createRasterizationState(const RasterState &state) {
         VkPipelineRasterizationStateCreateInfo info{};
         info.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
 
         info.depthClampEnable = VK_FALSE;
         info.rasterizerDiscardEnable = VK_FALSE;
 
-        info.polygonMode = polygonMode;
+        info.polygonMode = state.polygon_mode;
         info.lineWidth = 1.0f;
 
-        info.cullMode = VK_CULL_MODE_FRONT_BIT;
-        info.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        info.cullMode = state.cull_mode;
+        info.frontFace = state.front_face;
 
         info.depthBiasEnable = VK_FALSE;
         info.depthBiasConstantFactor = 0.0f;
@@ -117,12 +196,12 @@ namespace {
         return info;
     }
 
-    [[nodiscard]] VkPipelineMultisampleStateCreateInfo createMultisampleState() {
+    [[nodiscard]] VkPipelineMultisampleStateCreateInfo createMultisampleState(VkSampleCountFlagBits samples) {
         VkPipelineMultisampleStateCreateInfo info{};
         info.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
 
         info.sampleShadingEnable = VK_FALSE;
-        info.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+        info.rasterizationSamples = samples;
         info.minSampleShading = 1.0f;
         info.pSampleMask = nullptr;
         info.alphaToCoverageEnable = VK_FALSE;
@@ -131,87 +210,163 @@ namespace {
         return info;
     }
 
-    [[nodiscard]] VkPipelineColorBlendAttachmentState createColorBlendAttachmentState() {
+    [[nodiscard]] VkPipelineDepthStencilStateCreateInfo createDepthStencilState(const DepthState &depth) {
+        VkPipelineDepthStencilStateCreateInfo info{};
+        info.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+
+        info.depthTestEnable = depth.test_enable ? VK_TRUE : VK_FALSE;
+        info.depthWriteEnable = depth.write_enable ? VK_TRUE : VK_FALSE;
+        info.depthCompareOp = depth.test_enable ? depth.compare_op : VK_COMPARE_OP_ALWAYS;
+        info.depthBoundsTestEnable = VK_FALSE;
+        info.minDepthBounds = 0.0f;
+        info.maxDepthBounds = 1.0f;
+        info.stencilTestEnable = VK_FALSE;
+
+        return info;
+    }
+
+    [[nodiscard]] VkPipelineColorBlendAttachmentState createColorBlendAttachmentState(const BlendState &state) {
         VkPipelineColorBlendAttachmentState colorBlendAttachment{};
-        colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-        colorBlendAttachment.blendEnable = VK_FALSE;
+        colorBlendAttachment.colorWriteMask = state.write_mask;
+        colorBlendAttachment.blendEnable = state.enable ? VK_TRUE : VK_FALSE;
+
+        colorBlendAttachment.srcColorBlendFactor = state.src_color_factor;
+        colorBlendAttachment.dstColorBlendFactor = state.dst_color_factor;
+        colorBlendAttachment.colorBlendOp = state.color_op;
+
+        colorBlendAttachment.srcAlphaBlendFactor = state.src_alpha_factor;
+        colorBlendAttachment.dstAlphaBlendFactor = state.dst_alpha_factor;
+        colorBlendAttachment.alphaBlendOp = state.alpha_op;
 
         return colorBlendAttachment;
     }
 }  // namespace
 
 GraphicsPipeline::GraphicsPipeline(GraphicsPipeline::PipelineInfo &&pipelineInfo) : pipeline_info(std::move(pipelineInfo)) {
+    // pipeline layout
+    auto set_layout = pipeline_info.desc.descriptor_set_layout->getLayout();
+    auto pipelineLayoutInfo = createPipelineLayout(nostd::make_observer(&set_layout));
+
+    // vertex stage constants, e.g. the dequantization of quantized meshes
+    VkPushConstantRange pushConstantRange{};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = pipeline_info.desc.push_constant_size;
+
+    if (pushConstantRange.size > 0) {
+        pipelineLayoutInfo.pushConstantRangeCount = 1;
+        pipelineLayoutInfo.pPushConstantRanges = &pushConstantRange;
+    }
+
+    if (vkCreatePipelineLayout(pipeline_info.device->getDevice(), &pipelineLayoutInfo, nullptr, &pipeline_layout) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create pipeline layout!");
+    }
+
+    graphics_pipeline = createPipeline();
+}
+
+GraphicsPipeline::~GraphicsPipeline() {
+    vkDestroyPipelineLayout(pipeline_info.device->getDevice(), pipeline_layout, nullptr);
+    vkDestroyPipeline(pipeline_info.device->getDevice(), graphics_pipeline, nullptr);
+
+    if (auto pending = rebuilt_pipeline.exchange(nullptr); pending != nullptr) {
+        vkDestroyPipeline(pipeline_info.device->getDevice(), pending, nullptr);
+    }
+}
+
+VkPipeline GraphicsPipeline::createPipeline() const {
     VkViewport viewport{};
     viewport.x = 0.0f;
     viewport.y = 0.0f;
-    viewport.width = pipeline_info.swapchain->getExtent().width;
-    viewport.height = pipeline_info.swapchain->getExtent().height;
+    viewport.width = static_cast<float>(pipeline_info.extent.width);
+    viewport.height = static_cast<float>(pipeline_info.extent.height);
     viewport.minDepth = 0.0f;
     viewport.maxDepth = 1.0f;
 
     VkRect2D scissor{};
     scissor.offset = {0, 0};
-    scissor.extent = pipeline_info.swapchain->getExtent();
+    scissor.extent = pipeline_info.extent;
 
     auto viewportInfo = createViewportState(viewport, scissor);
 
-    color_blend_attachment = createColorBlendAttachmentState();
-    auto colorBlendInfo = createColorBlendState();
+    const auto &desc = pipeline_info.desc;
 
-    // Shaders
-    ShaderModule vertexShader(pipeline_info.device, "vert.spv", ShaderStage::VERTEX_SHADER);
-    shader_stages.push_back(createShaderStage(vertexShader));
+    const auto colorBlendAttachment = createColorBlendAttachmentState(desc.blend);
+    auto colorBlendInfo = createColorBlendState(colorBlendAttachment);
 
-    ShaderModule fragmentShader(pipeline_info.device, "frag.spv", ShaderStage::FRAGMENT_SHADER);
-    shader_stages.push_back(createShaderStage(fragmentShader));
+    // Shaders
+    std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
 
-    // pipeline layout
-    auto set_layout = pipeline_info.descriptor_set_layout->getLayout();
-    auto pipelineLayoutInfo = createPipelineLayout(nostd::make_observer(&set_layout));
+    const auto vertexShader = pipeline_info.shader_library->load(desc.vertex_shader_path, ShaderStage::VERTEX_SHADER);
+    shaderStages.push_back(createShaderStage(*vertexShader));
 
-    if (vkCreatePipelineLayout(pipeline_info.device->getDevice(), &pipelineLayoutInfo, nullptr, &pipeline_layout) != VK_SUCCESS) {
-        throw std::runtime_error("failed to create pipeline layout!");
-    }
+    const auto fragmentShader = pipeline_info.shader_library->load(desc.fragment_shader_path, ShaderStage::FRAGMENT_SHADER);
+    shaderStages.push_back(createShaderStage(*fragmentShader));
 
     // vertex input and input assembly
-    if (pipeline_info.input_info) {
-        vertex_input_info = createVertexInputState(nostd::make_not_null(pipeline_info.input_info.get()));
-    }
+    auto vertexInputInfo = createVertexInputState(nostd::make_not_null(&desc.vertex_input));
 
-    input_assembly = createInputAssembly(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP);
-    rasterizer = createRasterizationState(VK_POLYGON_MODE_FILL);
-    multisampling = createMultisampleState();
+    auto inputAssembly = createInputAssembly(desc.raster.topology);
+    auto rasterizer = createRasterizationState(desc.raster);
+    auto multisampling = createMultisampleState(desc.raster.samples);
+    auto depthStencil = createDepthStencilState(desc.depth);
 
     // Graphics Pipeline
     VkGraphicsPipelineCreateInfo graphicsPipelineInfo{};
     graphicsPipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
 
-    graphicsPipelineInfo.stageCount = shader_stages.size();
-    graphicsPipelineInfo.pStages = shader_stages.data();
-    graphicsPipelineInfo.pVertexInputState = &vertex_input_info;
-    graphicsPipelineInfo.pInputAssemblyState = &input_assembly;
+    graphicsPipelineInfo.stageCount = shaderStages.size();
+    graphicsPipelineInfo.pStages = shaderStages.data();
+    graphicsPipelineInfo.pVertexInputState = &vertexInputInfo;
+    graphicsPipelineInfo.pInputAssemblyState = &inputAssembly;
     graphicsPipelineInfo.pViewportState = &viewportInfo;
     graphicsPipelineInfo.pRasterizationState = &rasterizer;
     graphicsPipelineInfo.pMultisampleState = &multisampling;
-    graphicsPipelineInfo.pDepthStencilState = nullptr;
+    graphicsPipelineInfo.pDepthStencilState = desc.render_pass->hasDepthAttachment() ? &depthStencil : nullptr;
     graphicsPipelineInfo.pColorBlendState = &colorBlendInfo;
     graphicsPipelineInfo.pDynamicState = nullptr;
     graphicsPipelineInfo.layout = pipeline_layout;
 
-    graphicsPipelineInfo.renderPass = pipeline_info.render_pass->getPass();
+    graphicsPipelineInfo.renderPass = desc.render_pass->getPass();
 
-    graphicsPipelineInfo.subpass = 0;
+    graphicsPipelineInfo.subpass = desc.subpass;
     graphicsPipelineInfo.basePipelineHandle = nullptr;
     graphicsPipelineInfo.basePipelineIndex = -1;
 
-    if (vkCreateGraphicsPipelines(pipeline_info.device->getDevice(), nullptr, 1, &graphicsPipelineInfo, nullptr, &graphics_pipeline) != VK_SUCCESS) {
+    VkPipeline pipeline = nullptr;
+    if (vkCreateGraphicsPipelines(pipeline_info.device->getDevice(), pipeline_info.pipeline_cache, 1, &graphicsPipelineInfo, nullptr, &pipeline) != VK_SUCCESS) {
         throw std::runtime_error("failed to create graphics pipeline!");
     }
+
+    return pipeline;
 }
 
-GraphicsPipeline::~GraphicsPipeline() {
-    vkDestroyPipelineLayout(pipeline_info.device->getDevice(), pipeline_layout, nullptr);
-    vkDestroyPipeline(pipeline_info.device->getDevice(), graphics_pipeline, nullptr);
+void GraphicsPipeline::rebuild() {
+    // a previous rebuild that was never swapped in has never been bound, so it can be destroyed right away
+    if (auto stale = rebuilt_pipeline.exchange(createPipeline()); stale != nullptr) {
+        vkDestroyPipeline(pipeline_info.device->getDevice(), stale, nullptr);
+    }
+}
+
+VkPipeline GraphicsPipeline::applyRebuild() {
+    if (auto rebuilt = rebuilt_pipeline.exchange(nullptr); rebuilt != nullptr) {
+        return std::exchange(graphics_pipeline, rebuilt);
+    }
+
+    return nullptr;
+}
+
+bool GraphicsPipeline::usesShader(const std::filesystem::path &filepath) const {
+    std::error_code error;
+    const auto target = std::filesystem::weakly_canonical(filepath, error);
+
+    for (const auto &shader : {pipeline_info.desc.vertex_shader_path, pipeline_info.desc.fragment_shader_path}) {
+        if (std::filesystem::weakly_canonical(shader, error) == target) {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 /*
@@ -277,7 +432,15 @@ return mesh;
 }
 */
 
-void GraphicsPipeline::bind(const CommandBuffer &commandBuffer) const { vkCmdBindPipeline(commandBuffer.getCommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline); }
+void GraphicsPipeline::bind(const CommandBuffer &commandBuffer) const {
+    vkCmdBindPipeline(commandBuffer.getCommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, graphics_pipeline);
+    RenderStats::add(RenderCounter::PIPELINE_BINDS);
+}
+
+void GraphicsPipeline::pushConstants(const CommandBuffer &commandBuffer, const void *data, std::uint32_t size) const {
+    assert(size <= pipeline_info.desc.push_constant_size);
+    vkCmdPushConstants(commandBuffer.getCommandBuffer(), pipeline_layout, VK_SHADER_STAGE_VERTEX_BIT, 0, size, data);
+}
 
 [[nodiscard]] VkPipelineViewportStateCreateInfo GraphicsPipeline::createViewportState(const VkViewport &viewport, const VkRect2D &scissor) const {
     VkPipelineViewportStateCreateInfo viewportInfo{};
@@ -291,14 +454,14 @@ void GraphicsPipeline::bind(const CommandBuffer &commandBuffer) const { vkCmdBin
     return viewportInfo;
 }
 
-[[nodiscard]] VkPipelineColorBlendStateCreateInfo GraphicsPipeline::createColorBlendState() const {
+[[nodiscard]] VkPipelineColorBlendStateCreateInfo GraphicsPipeline::createColorBlendState(const VkPipelineColorBlendAttachmentState &colorBlendAttachment) const {
     VkPipelineColorBlendStateCreateInfo colorBlendInfo{};
     colorBlendInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
 
     colorBlendInfo.logicOpEnable = VK_FALSE;
     colorBlendInfo.logicOp = VK_LOGIC_OP_COPY;
     colorBlendInfo.attachmentCount = 1;
-    colorBlendInfo.pAttachments = &color_blend_attachment;
+    colorBlendInfo.pAttachments = &colorBlendAttachment;
 
     colorBlendInfo.blendConstants[0] = 0.0f;
     colorBlendInfo.blendConstants[1] = 0.0f;
@@ -3,34 +3,31 @@
 #include <vulkan/vulkan_core.h>
 
 #include <array>
+#include <atomic>
+#include <filesystem>
 #include <glm/matrix.hpp>
 #include <optional>
 #include <renderer/graphics/ressources/Mesh.hpp>
 #include <span>
+#include <string>
 #include <vector>
 
 #include "renderer/Device.hpp"
+#include "renderer/graphics/PipelineDesc.hpp"
 #include "renderer/graphics/ressources/Buffer.hpp"
 #include "renderer/sync/CommandPool.hpp"
 #include "renderer/sync/Fence.hpp"
 #include "utility.hpp"
 
 class Device;
-class Swapchain;
 
 class CommandBuffer;
 class RenderPass;
+class ShaderLibrary;
 
 class DescriptorSetLayout;
 class PushConstants;
 
-struct VertexInputDescription {
-    std::vector<VkVertexInputBindingDescription> bindings;
-    std::vector<VkVertexInputAttributeDescription> attributes;
-
-    VkPipelineVertexInputStateCreateFlags flags = 0;
-};
-
 struct AllocatedBuffer {
     VkBuffer buffer;
     VmaAllocation allocation;
@@ -38,31 +35,20 @@ struct AllocatedBuffer {
 
 enum class DrawPrimitive;
 
-struct UniformObject {
-    alignas(16) glm::mat4 model;
-    alignas(16) glm::mat4 view;
-    alignas(16) glm::mat4 proj;
-};
-
 class GraphicsPipeline : public NoCopy, public NoMove {
   public:
     struct PipelineInfo {
-        PipelineInfo(
-            std::shared_ptr<Device> _device, std::shared_ptr<Swapchain> _swapchain, std::shared_ptr<RenderPass> _render_pass,
-            std::shared_ptr<DescriptorSetLayout> _descriptor_set_layout = nullptr, std::unique_ptr<VertexInputDescription> &&_input_info = nullptr)
-            : device(std::move(_device)),
-              swapchain(std::move(_swapchain)),
-              render_pass(std::move(_render_pass)),
-              input_info(std::move(_input_info)),
-              descriptor_set_layout(std::move(_descriptor_set_layout)) {}
+        PipelineInfo(std::shared_ptr<Device> _device, VkExtent2D _extent, std::shared_ptr<ShaderLibrary> _shader_library, PipelineDesc _desc)
+            : device(std::move(_device)), extent(_extent), shader_library(std::move(_shader_library)), desc(std::move(_desc)) {}
 
         std::shared_ptr<Device> device;
-        std::shared_ptr<Swapchain> swapchain;
-        std::shared_ptr<RenderPass> render_pass;
+        // size of the static viewport and scissor, the swapchain extent or the one of an offscreen target
+        VkExtent2D extent;
+        std::shared_ptr<ShaderLibrary> shader_library;
 
-        std::unique_ptr<VertexInputDescription> input_info;
+        PipelineDesc desc;
+        VkPipelineCache pipeline_cache = nullptr;
 
-        std::shared_ptr<DescriptorSetLayout> descriptor_set_layout;
         std::shared_ptr<PushConstants> push_constants;
     };
 
@@ -71,7 +57,18 @@ class GraphicsPipeline : public NoCopy, public NoMove {
     ~GraphicsPipeline();
 
     void bind(const CommandBuffer &commandBuffer) const;
+    // the range covers the push_constant_size bytes of the description, in the vertex stage
+    void pushConstants(const CommandBuffer &commandBuffer, const void *data, std::uint32_t size) const;
 
+    // recreates the pipeline from the current shader files, safe to call from a background thread
+    void rebuild();
+    // swaps in the last rebuilt pipeline, must be called at a frame boundary, returns the retired pipeline or nullptr
+    [[nodiscard]] VkPipeline applyRebuild();
+
+    [[nodiscard]] bool usesShader(const std::filesystem::path &filepath) const;
+
+    [[nodiscard]] const std::shared_ptr<Device> &getDevice() const { return pipeline_info.device; }
+    [[nodiscard]] const PipelineDesc &getDesc() const { return pipeline_info.desc; }
     [[nodiscard]] VkPipeline getPipeline() const { return graphics_pipeline; }
     [[nodiscard]] VkPipelineLayout getPipelineLayout() const { return pipeline_layout; }
 
@@ -97,8 +94,10 @@ class GraphicsPipeline : public NoCopy, public NoMove {
     [[nodiscard]] static const std::vector<std::uint16_t> defaultMeshRectangleIndices() { return std::vector<std::uint16_t>{0, 1, 3, 0, 2, 1}; }
 
   private:
+    [[nodiscard]] VkPipeline createPipeline() const;
+
     [[nodiscard]] VkPipelineViewportStateCreateInfo createViewportState(const VkViewport &viewport, const VkRect2D &scissor) const;
-    [[nodiscard]] VkPipelineColorBlendStateCreateInfo createColorBlendState() const;
+    [[nodiscard]] VkPipelineColorBlendStateCreateInfo createColorBlendState(const VkPipelineColorBlendAttachmentState &colorBlendAttachment) const;
 
     [[nodiscard]] VkPipelineLayoutCreateInfo createPipelineLayout(
         nostd::observer_ptr<VkDescriptorSetLayout> descriptorSetLayout = nullptr, nostd::observer_ptr<PushConstants> pushConstants = nullptr) const;
@@ -109,12 +108,5 @@ class GraphicsPipeline : public NoCopy, public NoMove {
     VkPipeline graphics_pipeline = nullptr;
     VkPipelineLayout pipeline_layout = nullptr;
 
-    std::vector<VkPipelineShaderStageCreateInfo> shader_stages;
-
-    VkPipelineVertexInputStateCreateInfo vertex_input_info;
-    VkPipelineInputAssemblyStateCreateInfo input_assembly;
-
-    VkPipelineRasterizationStateCreateInfo rasterizer;
-    VkPipelineColorBlendAttachmentState color_blend_attachment;
-    VkPipelineMultisampleStateCreateInfo multisampling;
+    std::atomic<VkPipeline> rebuilt_pipeline = nullptr;
 };
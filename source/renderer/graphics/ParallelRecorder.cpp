@@ -0,0 +1,88 @@
+#include "renderer/graphics/ParallelRecorder.hpp"
+
+#include <exception>
+#include <vector>
+
+#include "jobs/JobSystem.hpp"
+#include "renderer/Device.hpp"
+#include "renderer/sync/CommandBuffer.hpp"
+#include "renderer/sync/CommandPool.hpp"
+
+namespace {
+    // below this many draws per batch the scheduling cost outweighs the recording time
+    constexpr std::uint32_t min_draws_per_batch = 64;
+}  // namespace
+
+ParallelRecorder::ParallelRecorder(std::shared_ptr<Device> _device, std::shared_ptr<JobSystem> _job_system, std::uint32_t _frame_count)
+    : device(std::move(_device)), job_system(std::move(_job_system)) {
+    thread_frames.resize(job_system->getThreadSlotCount());
+
+    for (auto &frames : thread_frames) {
+        frames.resize(_frame_count);
+        for (auto &frame : frames) {
+            frame.pool = std::make_unique<CommandPool>(device, QueueFamilyType::GRAPHICS);
+        }
+    }
+}
+
+ParallelRecorder::~ParallelRecorder() = default;
+
+std::span<const VkCommandBuffer> ParallelRecorder::record(
+    std::uint32_t frame_index, const VkCommandBufferInheritanceInfo &inheritance, std::uint32_t draw_count, const RecordFunction &record_function) {
+    // resetting whole pools is cheaper than resetting their command buffers one by one
+    for (auto &frames : thread_frames) {
+        frames[frame_index].pool->reset();
+        frames[frame_index].used = 0;
+    }
+
+    const auto slots = job_system->getThreadSlotCount();
+    const auto batchSize = std::max(min_draws_per_batch, (draw_count + slots - 1) / slots);
+    const auto batchCount = (draw_count + batchSize - 1) / batchSize;
+
+    recorded.assign(batchCount, nullptr);
+    std::vector<std::exception_ptr> errors(batchCount);
+
+    JobCounter counter;
+    for (std::uint32_t batch = 0; batch < batchCount; ++batch) {
+        job_system->schedule(
+            [&, batch] {
+                try {
+                    const auto first = batch * batchSize;
+                    const auto last = std::min(draw_count, first + batchSize);
+
+                    const auto cmd = CommandBuffer(acquireBuffer(frame_index));
+
+                    cmd.begin(inheritance);
+                    record_function(cmd, first, last);
+                    cmd.end();
+
+                    recorded[batch] = cmd.getCommandBuffer();
+                } catch (...) {
+                    errors[batch] = std::current_exception();
+                }
+            },
+            &counter);
+    }
+
+    // the render thread records batches too while waiting
+    job_system->wait(counter);
+
+    // a failed batch would silently drop its draws from the frame
+    for (const auto &error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    return recorded;
+}
+
+VkCommandBuffer ParallelRecorder::acquireBuffer(std::uint32_t frame_index) {
+    auto &frame = thread_frames[job_system->getThreadIndex()][frame_index];
+
+    if (frame.used == frame.buffers.size()) {
+        frame.buffers.push_back(frame.pool->acquireCommandBuffer(VK_COMMAND_BUFFER_LEVEL_SECONDARY));
+    }
+
+    return frame.buffers[frame.used++];
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "utility.hpp"
+
+class Device;
+class CommandPool;
+class CommandBuffer;
+class JobSystem;
+
+// Splits a frame's draws into jobs, each recording a secondary command buffer that the primary executes inside the render pass.
+// Every thread of the job system owns one command pool per frame in flight, so no pool is ever shared between threads.
+class ParallelRecorder final : public NoCopy, public NoMove {
+  public:
+    // records the draws [first, last) into cmd, secondary command buffers don't inherit any bound state
+    using RecordFunction = std::function<void(const CommandBuffer &cmd, std::uint32_t first, std::uint32_t last)>;
+
+  public:
+    ParallelRecorder(std::shared_ptr<Device> _device, std::shared_ptr<JobSystem> _job_system, std::uint32_t _frame_count);
+    ~ParallelRecorder();
+
+    // blocks until every batch is recorded, the previous submission of frame_index must have completed
+    // returns the recorded secondary command buffers in draw order, an exception thrown by a batch is rethrown here
+    [[nodiscard]] std::span<const VkCommandBuffer> record(
+        std::uint32_t frame_index, const VkCommandBufferInheritanceInfo &inheritance, std::uint32_t draw_count, const RecordFunction &record_function);
+
+  private:
+    struct ThreadFrame {
+        std::unique_ptr<CommandPool> pool;
+
+        // a thread can record several batches in one frame, buffers are reused once the pool has been reset
+        std::vector<VkCommandBuffer> buffers;
+        std::size_t used = 0;
+    };
+
+    [[nodiscard]] VkCommandBuffer acquireBuffer(std::uint32_t frame_index);
+
+  private:
+    std::shared_ptr<Device> device;
+    std::shared_ptr<JobSystem> job_system;
+
+    // indexed by [thread slot][frame]
+    std::vector<std::vector<ThreadFrame>> thread_frames;
+
+    std::vector<VkCommandBuffer> recorded;
+};
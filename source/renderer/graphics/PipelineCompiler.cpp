@@ -0,0 +1,44 @@
+#include "renderer/graphics/PipelineCompiler.hpp"
+
+#include <fmt/color.h>
+
+#include "renderer/graphics/GraphicsPipeline.hpp"
+#include "renderer/graphics/PipelineRegistry.hpp"
+
+PipelineCompiler::PipelineCompiler(std::shared_ptr<PipelineRegistry> _registry, std::shared_ptr<JobSystem> _job_system)
+    : registry(std::move(_registry)), job_system(std::move(_job_system)) {}
+
+PipelineCompiler::~PipelineCompiler() {
+    // jobs reference the compiler, every compilation has to be over before it goes away
+    job_system->wait(compilations);
+}
+
+PipelineHandle PipelineCompiler::compile(const PipelineDesc &desc) {
+    auto lock = std::scoped_lock(mutex);
+
+    if (auto it = requests.find(desc); it != requests.end()) {
+        return PipelineHandle(it->second);
+    }
+
+    auto state = std::make_shared<PipelineHandle::State>();
+    state->desc = desc;
+
+    requests.emplace(desc, state);
+
+    job_system->schedule(
+        [this, state] {
+            try {
+                state->pipeline = registry->get(state->desc);
+            } catch (const std::exception &e) {
+                // draws using this handle keep falling back instead of taking the whole renderer down
+                state->failed.store(true, std::memory_order_release);
+                fmt::print(fmt::fg(fmt::color::orange_red) | fmt::emphasis::bold, "[pipeline compiler] : {}\n", e.what());
+                return;
+            }
+
+            state->ready.store(true, std::memory_order_release);
+        },
+        &compilations);
+
+    return PipelineHandle(std::move(state));
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "jobs/JobSystem.hpp"
+#include "renderer/graphics/PipelineDesc.hpp"
+#include "utility.hpp"
+
+class GraphicsPipeline;
+class PipelineRegistry;
+
+// Cheap to copy, polled by the render thread every frame without blocking.
+class PipelineHandle {
+    friend class PipelineCompiler;
+
+    struct State {
+        PipelineDesc desc;
+
+        std::shared_ptr<GraphicsPipeline> pipeline;
+        std::atomic<bool> ready{false};
+        std::atomic<bool> failed{false};
+    };
+
+  public:
+    PipelineHandle() = default;
+
+    [[nodiscard]] bool isValid() const { return state != nullptr; }
+    [[nodiscard]] bool isReady() const { return state && state->ready.load(std::memory_order_acquire); }
+    [[nodiscard]] bool hasFailed() const { return state && state->failed.load(std::memory_order_acquire); }
+
+    [[nodiscard]] const PipelineDesc &getDesc() const { return state->desc; }
+
+    // nullptr while the pipeline is still compiling or if its compilation failed
+    [[nodiscard]] std::shared_ptr<GraphicsPipeline> get() const { return isReady() ? state->pipeline : nullptr; }
+
+  private:
+    explicit PipelineHandle(std::shared_ptr<State> _state) : state(std::move(_state)) {}
+
+    std::shared_ptr<State> state;
+};
+
+// Builds pipeline descriptions as jobs through the registry, so they all share its VkPipelineCache.
+// Requesting a description that is already queued or built returns the same handle.
+class PipelineCompiler final : public NoCopy, public NoMove {
+  public:
+    PipelineCompiler(std::shared_ptr<PipelineRegistry> _registry, std::shared_ptr<JobSystem> _job_system);
+    ~PipelineCompiler();
+
+    [[nodiscard]] PipelineHandle compile(const PipelineDesc &desc);
+
+    [[nodiscard]] bool isIdle() const { return compilations.isDone(); }
+
+  private:
+    std::shared_ptr<PipelineRegistry> registry;
+    std::shared_ptr<JobSystem> job_system;
+
+    std::mutex mutex;
+    std::unordered_map<PipelineDesc, std::shared_ptr<PipelineHandle::State>, PipelineDescHash> requests;
+
+    JobCounter compilations;
+};
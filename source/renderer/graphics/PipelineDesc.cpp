@@ -0,0 +1,81 @@
+#include "renderer/graphics/PipelineDesc.hpp"
+
+#include <algorithm>
+#include <span>
+
+#include "renderer/graphics/RenderPass.hpp"
+#include "utility.hpp"
+
+namespace {
+    std::uint64_t hashString(const std::string &value, std::uint64_t hash) {
+        hash = util::fnv1a(value.size(), hash);
+        return util::fnv1a(std::as_bytes(std::span(value)), hash);
+    }
+
+    std::uint64_t renderPassCompatibility(const std::shared_ptr<RenderPass> &render_pass) { return render_pass ? render_pass->getCompatibilityHash() : 0; }
+}  // namespace
+
+bool VertexInputDescription::operator==(const VertexInputDescription &other) const {
+    const auto sameBinding = [](const VkVertexInputBindingDescription &lhs, const VkVertexInputBindingDescription &rhs) {
+        return lhs.binding == rhs.binding && lhs.stride == rhs.stride && lhs.inputRate == rhs.inputRate;
+    };
+    const auto sameAttribute = [](const VkVertexInputAttributeDescription &lhs, const VkVertexInputAttributeDescription &rhs) {
+        return lhs.location == rhs.location && lhs.binding == rhs.binding && lhs.format == rhs.format && lhs.offset == rhs.offset;
+    };
+
+    return flags == other.flags && std::ranges::equal(bindings, other.bindings, sameBinding) && std::ranges::equal(attributes, other.attributes, sameAttribute);
+}
+
+bool PipelineDesc::operator==(const PipelineDesc &other) const {
+    return vertex_shader_path == other.vertex_shader_path && fragment_shader_path == other.fragment_shader_path && vertex_input == other.vertex_input && raster == other.raster &&
+           blend == other.blend && depth == other.depth && renderPassCompatibility(render_pass) == renderPassCompatibility(other.render_pass) && subpass == other.subpass &&
+           descriptor_set_layout == other.descriptor_set_layout && push_constant_size == other.push_constant_size;
+}
+
+std::uint64_t PipelineDesc::hash() const {
+    // hash field by field, hashing whole structs would also hash their padding
+    auto hash = util::fnv1a_offset_basis;
+
+    hash = hashString(vertex_shader_path, hash);
+    hash = hashString(fragment_shader_path, hash);
+
+    hash = util::fnv1a(vertex_input.flags, hash);
+    for (const auto &binding : vertex_input.bindings) {
+        hash = util::fnv1a(binding.binding, hash);
+        hash = util::fnv1a(binding.stride, hash);
+        hash = util::fnv1a(binding.inputRate, hash);
+    }
+    for (const auto &attribute : vertex_input.attributes) {
+        hash = util::fnv1a(attribute.location, hash);
+        hash = util::fnv1a(attribute.binding, hash);
+        hash = util::fnv1a(attribute.format, hash);
+        hash = util::fnv1a(attribute.offset, hash);
+    }
+
+    hash = util::fnv1a(raster.topology, hash);
+    hash = util::fnv1a(raster.polygon_mode, hash);
+    hash = util::fnv1a(raster.cull_mode, hash);
+    hash = util::fnv1a(raster.front_face, hash);
+    hash = util::fnv1a(raster.samples, hash);
+
+    hash = util::fnv1a(blend.enable, hash);
+    hash = util::fnv1a(blend.src_color_factor, hash);
+    hash = util::fnv1a(blend.dst_color_factor, hash);
+    hash = util::fnv1a(blend.color_op, hash);
+    hash = util::fnv1a(blend.src_alpha_factor, hash);
+    hash = util::fnv1a(blend.dst_alpha_factor, hash);
+    hash = util::fnv1a(blend.alpha_op, hash);
+    hash = util::fnv1a(blend.write_mask, hash);
+
+    hash = util::fnv1a(depth.test_enable, hash);
+    hash = util::fnv1a(depth.write_enable, hash);
+    hash = util::fnv1a(depth.compare_op, hash);
+
+    hash = util::fnv1a(renderPassCompatibility(render_pass), hash);
+    hash = util::fnv1a(subpass, hash);
+
+    hash = util::fnv1a(descriptor_set_layout.get(), hash);
+    hash = util::fnv1a(push_constant_size, hash);
+
+    return hash;
+}
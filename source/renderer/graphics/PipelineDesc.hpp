@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class RenderPass;
+class DescriptorSetLayout;
+
+struct VertexInputDescription {
+    std::vector<VkVertexInputBindingDescription> bindings;
+    std::vector<VkVertexInputAttributeDescription> attributes;
+
+    VkPipelineVertexInputStateCreateFlags flags = 0;
+
+    bool operator==(const VertexInputDescription &other) const;
+};
+
+struct RasterState {
+    VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_STRIP;
+    VkPolygonMode polygon_mode = VK_POLYGON_MODE_FILL;
+    VkCullModeFlags cull_mode = VK_CULL_MODE_FRONT_BIT;
+    VkFrontFace front_face = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+
+    bool operator==(const RasterState &) const = default;
+};
+
+struct BlendState {
+    bool enable = false;
+
+    VkBlendFactor src_color_factor = VK_BLEND_FACTOR_SRC_ALPHA;
+    VkBlendFactor dst_color_factor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    VkBlendOp color_op = VK_BLEND_OP_ADD;
+
+    VkBlendFactor src_alpha_factor = VK_BLEND_FACTOR_ONE;
+    VkBlendFactor dst_alpha_factor = VK_BLEND_FACTOR_ZERO;
+    VkBlendOp alpha_op = VK_BLEND_OP_ADD;
+
+    VkColorComponentFlags write_mask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+    bool operator==(const BlendState &) const = default;
+};
+
+// opaque geometry by default, transparent pipelines should keep the test but disable writes
+struct DepthState {
+    bool test_enable = true;
+    bool write_enable = true;
+    VkCompareOp compare_op = VK_COMPARE_OP_LESS_OR_EQUAL;
+
+    bool operator==(const DepthState &) const = default;
+};
+
+// Everything a graphics pipeline is built from. Two equal descriptions always produce interchangeable pipelines.
+struct PipelineDesc {
+    std::string vertex_shader_path = "vert.spv";
+    std::string fragment_shader_path = "frag.spv";
+
+    VertexInputDescription vertex_input;
+
+    RasterState raster;
+    BlendState blend;
+    DepthState depth;
+
+    // pipelines only depend on the render pass layout, compatible render passes share the same compatibility hash
+    std::shared_ptr<RenderPass> render_pass;
+    std::uint32_t subpass = 0;
+
+    std::shared_ptr<DescriptorSetLayout> descriptor_set_layout;
+    // size of the vertex stage push constants, 0 for none
+    std::uint32_t push_constant_size = 0;
+
+    bool operator==(const PipelineDesc &other) const;
+
+    // only depends on the description content (and the identity of the descriptor set layout)
+    [[nodiscard]] std::uint64_t hash() const;
+};
+
+struct PipelineDescHash {
+    std::size_t operator()(const PipelineDesc &desc) const noexcept { return static_cast<std::size_t>(desc.hash()); }
+};
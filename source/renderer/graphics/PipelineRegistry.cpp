@@ -0,0 +1,70 @@
+#include "renderer/graphics/PipelineRegistry.hpp"
+
+#include <stdexcept>
+
+#include "renderer/Device.hpp"
+#include "renderer/graphics/GraphicsPipeline.hpp"
+#include "renderer/graphics/ShaderHotReloader.hpp"
+
+PipelineRegistry::PipelineRegistry(
+    std::shared_ptr<Device> _device, VkExtent2D _extent, std::shared_ptr<ShaderLibrary> _shader_library, nostd::observer_ptr<ShaderHotReloader> _shader_reloader)
+    : device(std::move(_device)), extent(_extent), shader_library(std::move(_shader_library)), shader_reloader(_shader_reloader) {
+    VkPipelineCacheCreateInfo pipelineCacheInfo{};
+    pipelineCacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+
+    pipelineCacheInfo.initialDataSize = 0;
+    pipelineCacheInfo.pInitialData = nullptr;
+
+    if (vkCreatePipelineCache(device->getDevice(), &pipelineCacheInfo, nullptr, &pipeline_cache) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create pipeline cache!");
+    }
+}
+
+PipelineRegistry::~PipelineRegistry() {
+    pipelines.clear();
+    vkDestroyPipelineCache(device->getDevice(), pipeline_cache, nullptr);
+}
+
+std::shared_ptr<GraphicsPipeline> PipelineRegistry::get(const PipelineDesc &desc) {
+    auto lock = std::unique_lock(mutex);
+    if (auto it = pipelines.find(desc); it != pipelines.end()) {
+        // built or being built by another thread, waited for rather than compiled again
+        auto pipeline = it->second;
+        lock.unlock();
+        return pipeline.get();
+    }
+
+    std::promise<std::shared_ptr<GraphicsPipeline>> promise;
+    pipelines.emplace(desc, promise.get_future().share());
+    lock.unlock();
+
+    // build outside of the lock so different descriptions compile in parallel
+    std::shared_ptr<GraphicsPipeline> pipeline;
+    try {
+        auto info = GraphicsPipeline::PipelineInfo(device, extent, shader_library, desc);
+        info.pipeline_cache = pipeline_cache;
+
+        pipeline = std::make_shared<GraphicsPipeline>(std::move(info));
+    } catch (...) {
+        // the callers already waiting get the error, the next get() tries again
+        promise.set_exception(std::current_exception());
+
+        lock.lock();
+        pipelines.erase(desc);
+        throw;
+    }
+
+    lock.lock();
+    if (shader_reloader) {
+        shader_reloader->track(pipeline);
+    }
+    lock.unlock();
+
+    promise.set_value(pipeline);
+    return pipeline;
+}
+
+std::size_t PipelineRegistry::getPipelineCount() const {
+    auto lock = std::scoped_lock(mutex);
+    return pipelines.size();
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "renderer/graphics/PipelineDesc.hpp"
+#include "utility.hpp"
+
+class Device;
+class ShaderLibrary;
+class ShaderHotReloader;
+
+class GraphicsPipeline;
+
+// Returns the already built pipeline of an equal description, so material variants never compile the same pipeline twice.
+// Every pipeline is created through one shared VkPipelineCache, get() can be called from several threads at once
+// and a caller asking for a pipeline another thread is building waits for it.
+class PipelineRegistry final : public NoCopy, public NoMove {
+  public:
+    PipelineRegistry(
+        std::shared_ptr<Device> _device, VkExtent2D _extent, std::shared_ptr<ShaderLibrary> _shader_library,
+        nostd::observer_ptr<ShaderHotReloader> _shader_reloader = nullptr);
+    ~PipelineRegistry();
+
+    [[nodiscard]] std::shared_ptr<GraphicsPipeline> get(const PipelineDesc &desc);
+
+    // including the pipelines still being built
+    [[nodiscard]] std::size_t getPipelineCount() const;
+    [[nodiscard]] VkPipelineCache getPipelineCache() const { return pipeline_cache; }
+
+  private:
+    std::shared_ptr<Device> device;
+    VkExtent2D extent;
+    std::shared_ptr<ShaderLibrary> shader_library;
+
+    nostd::observer_ptr<ShaderHotReloader> shader_reloader;
+
+    VkPipelineCache pipeline_cache = nullptr;
+
+    mutable std::mutex mutex;
+    std::unordered_map<PipelineDesc, std::shared_future<std::shared_ptr<GraphicsPipeline>>, PipelineDescHash> pipelines;
+};
@@ -7,10 +7,14 @@
 #include "renderer/graphics/Framebuffer.hpp"
 #include "renderer/sync/CommandBuffer.hpp"
 
-RenderPass::RenderPass(std::shared_ptr<Device> _device, std::shared_ptr<Swapchain> _swapchain) : device(std::move(_device)), swapchain(std::move(_swapchain)) {
+RenderPass::RenderPass(std::shared_ptr<Device> _device, const Swapchain &swapchain, VkFormat _depth_format)
+    : RenderPass(std::move(_device), swapchain.getFormat(), VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, _depth_format) {}
+
+RenderPass::RenderPass(std::shared_ptr<Device> _device, VkFormat color_format, VkImageLayout color_final_layout, VkFormat _depth_format)
+    : device(std::move(_device)), depth_format(_depth_format) {
     // color attachment
     VkAttachmentDescription color_attachment{};
-    color_attachment.format = swapchain->getFormat();
+    color_attachment.format = color_format;
     color_attachment.samples = VK_SAMPLE_COUNT_1_BIT;
 
     color_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
@@ -20,10 +24,28 @@ RenderPass::RenderPass(std::shared_ptr<Device> _device, std::shared_ptr<Swapchai
     color_attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 
     color_attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    color_attachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    color_attachment.finalLayout = color_final_layout;
 
     attachments.push_back(color_attachment);
 
+    // depth attachment, only needed while the subpass runs so it is never stored
+    if (hasDepthAttachment()) {
+        VkAttachmentDescription depth_attachment{};
+        depth_attachment.format = depth_format;
+        depth_attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+
+        depth_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+        depth_attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+
+        depth_attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+        depth_attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+
+        depth_attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        depth_attachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+        attachments.push_back(depth_attachment);
+    }
+
     // subpass
     VkSubpassDescription subpass{};
     subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
@@ -35,6 +57,12 @@ RenderPass::RenderPass(std::shared_ptr<Device> _device, std::shared_ptr<Swapchai
     subpass.colorAttachmentCount = 1;
     subpass.pColorAttachments = &attachmentReference;
 
+    VkAttachmentReference depthAttachmentReference{};
+    depthAttachmentReference.attachment = 1;
+    depthAttachmentReference.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    subpass.pDepthStencilAttachment = hasDepthAttachment() ? &depthAttachmentReference : nullptr;
+
     subpasses.push_back(subpass);
 
     // subpass dependency
@@ -47,6 +75,14 @@ RenderPass::RenderPass(std::shared_ptr<Device> _device, std::shared_ptr<Swapchai
     dependency.srcAccessMask = 0;
     dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
 
+    // every frame in flight shares the depth image, wait for the previous frame's depth writes before clearing it
+    if (hasDepthAttachment()) {
+        dependency.srcStageMask |= VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        dependency.dstStageMask |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+        dependency.srcAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        dependency.dstAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    }
+
     // renderpass
     VkRenderPassCreateInfo renderPassInfo{};
     renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
@@ -62,11 +98,18 @@ RenderPass::RenderPass(std::shared_ptr<Device> _device, std::shared_ptr<Swapchai
     if (vkCreateRenderPass(device->getDevice(), &renderPassInfo, nullptr, &render_pass) != VK_SUCCESS) {
         throw std::runtime_error("failed to create render pass!");
     }
+
+    // render passes are compatible when their attachments have matching formats and sample counts
+    compatibility_hash = util::fnv1a(subpasses.size());
+    for (const auto &attachment : attachments) {
+        compatibility_hash = util::fnv1a(attachment.format, compatibility_hash);
+        compatibility_hash = util::fnv1a(attachment.samples, compatibility_hash);
+    }
 }
 
 RenderPass::~RenderPass() { vkDestroyRenderPass(device->getDevice(), render_pass, nullptr); }
 
-void RenderPass::begin(const CommandBuffer &commandBuffer, const Framebuffer &framebuffer, VkClearValue clearValue) {
+void RenderPass::begin(const CommandBuffer &commandBuffer, const Framebuffer &framebuffer, std::span<const VkClearValue> clearValues, VkSubpassContents contents) {
     VkRenderPassBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
 
@@ -74,12 +117,12 @@ void RenderPass::begin(const CommandBuffer &commandBuffer, const Framebuffer &fr
     beginInfo.framebuffer = framebuffer.getFramebuffer();
     beginInfo.renderArea.offset.x = 0;
     beginInfo.renderArea.offset.y = 0;
-    beginInfo.renderArea.extent = swapchain->getExtent();
+    beginInfo.renderArea.extent = framebuffer.getExtent();
 
-    beginInfo.clearValueCount = 1;
-    beginInfo.pClearValues = &clearValue;
+    beginInfo.clearValueCount = static_cast<std::uint32_t>(clearValues.size());
+    beginInfo.pClearValues = clearValues.data();
 
-    vkCmdBeginRenderPass(commandBuffer.getCommandBuffer(), &beginInfo, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBeginRenderPass(commandBuffer.getCommandBuffer(), &beginInfo, contents);
 }
 
 void RenderPass::end(const CommandBuffer &commandBuffer) { vkCmdEndRenderPass(commandBuffer.getCommandBuffer()); }
@@ -2,6 +2,7 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <cstdint>
 #include <memory>
 #include <span>
 #include <vector>
@@ -16,24 +17,37 @@ class CommandBuffer;
 
 class RenderPass final : public NoCopy, public NoMove {
   public:
-    RenderPass(std::shared_ptr<Device> _device, std::shared_ptr<Swapchain> _swapchain);
+    // the depth attachment is left out when _depth_format is VK_FORMAT_UNDEFINED
+    RenderPass(std::shared_ptr<Device> _device, const Swapchain &swapchain, VkFormat _depth_format = VK_FORMAT_UNDEFINED);
+    // offscreen pass, the color attachment ends in color_final_layout instead of being presented
+    RenderPass(std::shared_ptr<Device> _device, VkFormat color_format, VkImageLayout color_final_layout, VkFormat _depth_format = VK_FORMAT_UNDEFINED);
     ~RenderPass();
 
-    void begin(const CommandBuffer &commandBuffer, const Framebuffer &framebuffer, VkClearValue clearValue);
+    // one clear value per attachment, in attachment order
+    // renders the whole framebuffer, with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS the subpass can only execute secondary command buffers
+    void begin(
+        const CommandBuffer &commandBuffer, const Framebuffer &framebuffer, std::span<const VkClearValue> clearValues,
+        VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE);
     void end(const CommandBuffer &commandBuffer);
 
   public:
     [[nodiscard]] const VkRenderPass &getPass() const { return render_pass; }
+    [[nodiscard]] std::uint64_t getCompatibilityHash() const { return compatibility_hash; }
     [[nodiscard]] std::span<const VkSubpassDescription> getSubpasses() const { return subpasses; }
 
     [[nodiscard]] std::size_t getAttachmentCount() const { return attachments.size(); }
     [[nodiscard]] std::span<const VkAttachmentDescription> getAttachments() const { return attachments; }
 
+    [[nodiscard]] bool hasDepthAttachment() const { return depth_format != VK_FORMAT_UNDEFINED; }
+    [[nodiscard]] VkFormat getDepthFormat() const { return depth_format; }
+
   private:
     std::shared_ptr<Device> device;
-    std::shared_ptr<Swapchain> swapchain;
 
     VkRenderPass render_pass = nullptr;
+    std::uint64_t compatibility_hash = 0;
+
+    VkFormat depth_format = VK_FORMAT_UNDEFINED;
 
     std::vector<VkAttachmentDescription> attachments;
     std::vector<VkSubpassDescription> subpasses;
@@ -2,32 +2,54 @@
 
 #include <fmt/color.h>
 
+#include <algorithm>
 #include <memory>
-
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
+
+#include "config.hpp"
+#include "jobs/JobSystem.hpp"
+#include "profiling/CpuProfiler.hpp"
+#include "profiling/RenderStats.hpp"
 #include "renderer/Device.hpp"
+#include "renderer/MemoryBudget.hpp"
 #include "renderer/Instance.hpp"
 #include "renderer/Swapchain.hpp"
 #include "renderer/graphics/DescriptorSetLayout.hpp"
 #include "renderer/graphics/Framebuffer.hpp"
+#include "renderer/graphics/GpuCuller.hpp"
+#include "renderer/graphics/GpuProfiler.hpp"
 #include "renderer/graphics/GraphicsPipeline.hpp"
+#include "renderer/graphics/ParallelRecorder.hpp"
+#include "renderer/graphics/PipelineCompiler.hpp"
+#include "renderer/graphics/PipelineRegistry.hpp"
 #include "renderer/graphics/RenderPass.hpp"
 #include "renderer/graphics/Shader.hpp"
+#include "renderer/graphics/ShaderHotReloader.hpp"
+#include "renderer/graphics/ShaderLibrary.hpp"
 #include "renderer/graphics/ressources/Buffer.hpp"
 #include "renderer/graphics/ressources/DecriptorSet.hpp"
 #include "renderer/graphics/ressources/DescriptorPool.hpp"
+#include "renderer/graphics/ressources/Image.hpp"
+#include "renderer/sync/AsyncCompute.hpp"
 #include "renderer/sync/CommandBuffer.hpp"
 #include "renderer/sync/CommandPool.hpp"
-#include "renderer/sync/Fence.hpp"
 #include "renderer/sync/Semaphore.hpp"
+#include "renderer/sync/TimelineSemaphore.hpp"
 #include "window.hpp"
 
 namespace {
     struct FrameData {
         FrameData(const std::shared_ptr<Device> &d)
-            : presentSemaphore(*d), renderSemaphore(*d), renderFence(d), commandPool(d, QueueFamilyType::GRAPHICS), commandBuffer(*d, commandPool) {}
+            : presentSemaphore(*d), renderSemaphore(*d), commandPool(d, QueueFamilyType::GRAPHICS), commandBuffer(*d, commandPool) {}
 
+        // the swapchain only works with binary semaphores
         Semaphore presentSemaphore, renderSemaphore;
-        Fence renderFence;
+
+        // timeline value signaled by the last submission recorded in this frame's command buffer
+        std::uint64_t submitted_value = 0;
 
         CommandPool commandPool;
         CommandBuffer commandBuffer;
@@ -35,127 +57,515 @@ namespace {
 
     constexpr std::uint32_t FRAME_OVERLAP = 2;
 
-    FrameData &getCurrentFrame(std::span<FrameData> frames, std::uint32_t frameNumber) { return frames[frameNumber % FRAME_OVERLAP]; }
+    FrameData &getCurrentFrame(std::span<FrameData> frames, std::uint64_t frameNumber) { return frames[frameNumber % FRAME_OVERLAP]; }
 }  // namespace
 
 Renderer::Renderer(std::shared_ptr<Window> _window) {
     renderer_info.window = std::move(_window);
+    renderer_info.job_system = std::make_shared<JobSystem>();
     renderer_info.instance = std::make_shared<Instance>(*renderer_info.window, "blank title");
     renderer_info.device = std::make_shared<Device>(renderer_info.instance);
     renderer_info.swapchain = std::make_shared<Swapchain>(renderer_info.instance, renderer_info.device, *renderer_info.window);
-    renderer_info.render_pass = std::make_shared<RenderPass>(renderer_info.device, renderer_info.swapchain);
+    renderer_info.render_pass = std::make_shared<RenderPass>(renderer_info.device, *renderer_info.swapchain, renderer_info.device->findDepthFormat());
+    renderer_info.shader_library = std::make_shared<ShaderLibrary>(renderer_info.device);
+    renderer_info.timeline = std::make_shared<TimelineSemaphore>(renderer_info.device);
+
+    if constexpr (config::enable_shader_hot_reload) {
+        shader_reloader = std::make_unique<ShaderHotReloader>(renderer_info.shader_library, config::shader_directory);
+    }
+
+    renderer_info.pipeline_registry = std::make_shared<PipelineRegistry>(
+        renderer_info.device, renderer_info.swapchain->getExtent(), renderer_info.shader_library, nostd::make_observer(shader_reloader.get()));
+    renderer_info.pipeline_compiler = std::make_shared<PipelineCompiler>(renderer_info.pipeline_registry, renderer_info.job_system);
+
+    std::vector<ShaderResource> shaderResources;
+    shaderResources.emplace_back(0, ShaderResourceType::BUFFER_UNIFORM, 1, ShaderStage::VERTEX_SHADER, ShaderResourceMode::STATIC, "camera");
+    shaderResources.emplace_back(1, ShaderResourceType::BUFFER_STORAGE, 1, ShaderStage::VERTEX_SHADER, ShaderResourceMode::STATIC, "objects");
+
+    renderer_info.descriptor_set_layout = std::make_shared<DescriptorSetLayout>(renderer_info.device, shaderResources);
+
+    if constexpr (config::enable_frustum_culling) {
+        culler = std::make_unique<FrustumCuller>(renderer_info.job_system);
+    }
+
+    if constexpr (config::enable_gpu_profiler) {
+        gpu_profiler = std::make_unique<GpuProfiler>(renderer_info.device, FRAME_OVERLAP, config::enable_pipeline_statistics);
+    }
+
+    if (config::enable_async_compute && renderer_info.device->hasDedicatedComputeQueue()) {
+        async_compute = std::make_unique<AsyncCompute>(renderer_info.device);
+    }
 }
 
-Renderer::~Renderer() { DeletionQueue::flush(); }
+Renderer::~Renderer() {
+    // both build pipelines off the render thread, stop them before anything they use is destroyed
+    renderer_info.pipeline_compiler.reset();
+    shader_reloader.reset();
+    deletion_queue.flush();
 
-void Renderer::createGraphicsPipeline() {
-    auto vertexInputDescription = std::make_unique<VertexInputDescription>(Vertex::getVertexInputDescription());
+    depth_image.reset();
+    gpu_culler.reset();
+    async_compute.reset();
+    gpu_profiler.reset();
+
+    DeletionQueue::flush();
+}
+
+PipelineDesc Renderer::getDefaultPipelineDesc() const {
+    PipelineDesc desc{};
+    desc.vertex_input = Vertex::getVertexInputDescription();
+    desc.render_pass = renderer_info.render_pass;
+    desc.descriptor_set_layout = renderer_info.descriptor_set_layout;
+
+    return desc;
+}
+
+PipelineDesc Renderer::getQuantizedPipelineDesc(VertexQuantization quantization) const {
+    auto desc = getDefaultPipelineDesc();
+
+    switch (quantization) {
+        case VertexQuantization::NONE:
+            return desc;
+
+        case VertexQuantization::SNORM16:
+            desc.vertex_input = QuantizedVertex::getVertexInputDescription();
+            break;
+
+        case VertexQuantization::FLOAT16:
+            desc.vertex_input = HalfQuantizedVertex::getVertexInputDescription();
+            break;
+    }
+
+    desc.vertex_shader_path = "quantized.spv";
+    desc.push_constant_size = sizeof(VertexDequantization);
+
+    return desc;
+}
+
+PipelineHandle Renderer::compilePipeline(const PipelineDesc &desc) { return renderer_info.pipeline_compiler->compile(desc); }
 
-    renderer_info.graphics_pipeline = std::make_shared<GraphicsPipeline>(GraphicsPipeline::PipelineInfo(
-	renderer_info.device, renderer_info.swapchain, renderer_info.render_pass, renderer_info.descriptor_set_layout, std::move(vertexInputDescription)));
+void Renderer::createGraphicsPipeline() {
+    // the fallback of every draw, so it is the only pipeline built synchronously
+    renderer_info.graphics_pipeline = renderer_info.pipeline_registry->get(getDefaultPipelineDesc());
 
-    uniform_buffers.reserve(renderer_info.swapchain->getImageViewCount());
-    desciptor_sets.reserve(renderer_info.swapchain->getImageViewCount());
     framebuffers.reserve(renderer_info.swapchain->getImageViewCount());
 
+    // a single depth image is enough, the render pass dependency orders its use between frames
+    depth_image = std::make_unique<Image>(
+        renderer_info.device, renderer_info.swapchain->getExtent(), renderer_info.render_pass->getDepthFormat(), VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT);
+
     for (std::uint32_t i = 0; i < renderer_info.swapchain->getImageViewCount(); ++i) {
-        framebuffers.push_back(
-            std::make_unique<Framebuffer>(renderer_info.device, *renderer_info.render_pass, renderer_info.swapchain->getImageViews()[i], renderer_info.swapchain->getExtent()));
+        const std::array attachments = {renderer_info.swapchain->getImageViews()[i], depth_image->getImageView()};
+        framebuffers.push_back(std::make_unique<Framebuffer>(renderer_info.device, *renderer_info.render_pass, attachments, renderer_info.swapchain->getExtent()));
+    }
+}
+
+void Renderer::setupGpuCulling() {
+    const auto isBlended = [&](std::uint32_t i) { return draw_pipelines[i].handle.isValid() && draw_pipelines[i].handle.getDesc().blend.enable; };
+
+    // draws sharing the index and vertex buffers and the pipeline become one indirect draw
+    const auto batchKey = [&](std::uint32_t i) {
+        const auto pipelineKey = draw_pipelines[i].handle.isValid() ? draw_pipelines[i].handle.getDesc().hash() : 0;
+        return std::tuple(meshes[i].getVertexBuffer().buffer, meshes[i].getIndexBuffer().buffer, pipelineKey);
+    };
+
+    std::vector<std::uint32_t> gpuDraws;
+    cpu_draws.clear();
+
+    for (std::uint32_t i = 0; i < meshes.size(); ++i) {
+        // blended draws have to be sorted back to front, which the gpu culler doesn't do
+        if (isBlended(i) || meshes[i].getIndexCount() == 0) {
+            cpu_draws.push_back(i);
+        } else {
+            gpuDraws.push_back(i);
+        }
+    }
+
+    std::ranges::stable_sort(gpuDraws, [&](std::uint32_t lhs, std::uint32_t rhs) { return batchKey(lhs) < batchKey(rhs); });
+
+    std::vector<GpuCuller::Object> objects;
+    std::vector<std::uint32_t> batchFirst;
+    objects.reserve(gpuDraws.size());
+
+    for (std::uint32_t i = 0; i < gpuDraws.size(); ++i) {
+        const auto draw = gpuDraws[i];
+
+        if (i == 0 || batchKey(draw) != batchKey(gpuDraws[i - 1])) {
+            batchFirst.push_back(i);
+            gpu_batch_draws.push_back(draw);
+        }
+
+        const auto &bounds = meshes[draw].getBounds();
+        objects.push_back(GpuCuller::Object{
+            .bounds = glm::vec4(bounds.center, bounds.radius),
+            .transform = draw_transforms[draw],
+            .batch = static_cast<std::uint32_t>(batchFirst.size() - 1),
+            .index_count = meshes[draw].getIndexCount(),
+            .first_index = meshes[draw].getFirstIndex(),
+            .vertex_offset = meshes[draw].getVertexOffset(),
+        });
+    }
+
+    gpu_culler = std::make_unique<GpuCuller>(renderer_info.device, renderer_info.shader_library, renderer_info.pipeline_registry->getPipelineCache(), FRAME_OVERLAP);
+    gpu_culler->upload(objects, batchFirst, object_buffers);
+}
+
+void Renderer::cullDraws(const Frustum &frustum) {
+    CPU_ZONE("cull draws");
+
+    draw_visibility.assign(cpu_draws.size(), 1);
+    if (!culler) {
+        return;
+    }
+
+    draw_bounds.resize(cpu_draws.size());
+    for (std::size_t c = 0; c < cpu_draws.size(); ++c) {
+        const auto i = cpu_draws[c];
+        const auto &bounds = meshes[i].getBounds();
+        const auto &world = transforms.getWorldMatrix(draw_transforms[i]);
+
+        const auto center = world * math::Vector4f({bounds.center.x, bounds.center.y, bounds.center.z, 1.f});
+
+        // the largest axis scale keeps the sphere enclosing under non uniform scaling
+        float maxScaleSquared = 0.f;
+        for (std::size_t axis = 0; axis < 3; ++axis) {
+            maxScaleSquared = std::max(maxScaleSquared, world(0, axis) * world(0, axis) + world(1, axis) * world(1, axis) + world(2, axis) * world(2, axis));
+        }
+
+        draw_bounds.set(c, glm::vec3(center[0], center[1], center[2]), bounds.radius * std::sqrt(maxScaleSquared));
+    }
+
+    culler->cull(frustum, draw_bounds, draw_visibility);
+}
+
+void Renderer::sortDraws() {
+    CPU_ZONE("sort draws");
+
+    draw_order.clear();
+    for (std::size_t c = 0; c < cpu_draws.size(); ++c) {
+        if (draw_visibility[c]) {
+            draw_order.push_back(cpu_draws[c]);
+        }
     }
+
+    const auto isBlended = [&](std::uint32_t i) { return draw_pipelines[i].handle.isValid() && draw_pipelines[i].handle.getDesc().blend.enable; };
+
+    // the camera looks down -z in view space, a greater z is closer to it
+    const auto viewDepth = [&](std::uint32_t i) {
+        const auto &world = transforms.getWorldMatrix(draw_transforms[i]);
+        return (camera.view * glm::vec4(world(0, 3), world(1, 3), world(2, 3), 1.f)).z;
+    };
+
+    const auto firstBlended = std::stable_partition(draw_order.begin(), draw_order.end(), [&](std::uint32_t i) { return !isBlended(i); });
+
+    std::stable_sort(draw_order.begin(), firstBlended, [&](std::uint32_t lhs, std::uint32_t rhs) { return viewDepth(lhs) > viewDepth(rhs); });
+    std::stable_sort(firstBlended, draw_order.end(), [&](std::uint32_t lhs, std::uint32_t rhs) { return viewDepth(lhs) < viewDepth(rhs); });
 }
 
 void Renderer::begin() { fmt::print("begin renderer\n"); }
 
-void Renderer::draw(const Mesh &_mesh, const UniformObject &_uniform_data) {
+void Renderer::draw(const Mesh &_mesh, TransformId _transform) {
+    if (_transform >= transforms.size()) {
+        throw std::runtime_error("draw references a transform that does not exist!");
+    }
+    if (_mesh.getVertexInput() != getVertexInput<Vertex>()) {
+        throw std::runtime_error("draw of a mesh the default pipeline can't read, it needs a pipeline built for its vertex layout!");
+    }
+
     meshes.push_back(_mesh);
-    uniforms_data.push_back(_uniform_data);
+    draw_transforms.push_back(_transform);
+    draw_pipelines.emplace_back();
 }
 
-void Renderer::end() {
-    std::vector<ShaderResource> shaderResources;
-    shaderResources.emplace_back(0, ShaderResourceType::BUFFER_UNIFORM, 1, ShaderStage::VERTEX_SHADER, ShaderResourceMode::STATIC, "mvp");
+void Renderer::draw(const Mesh &_mesh, TransformId _transform, PipelineHandle _pipeline) {
+    if (!_pipeline.isValid()) {
+        return draw(_mesh, _transform);
+    }
 
-    renderer_info.descriptor_set_layout = std::make_shared<DescriptorSetLayout>(renderer_info.device, shaderResources);
-    createGraphicsPipeline();
+    if (_transform >= transforms.size()) {
+        throw std::runtime_error("draw references a transform that does not exist!");
+    }
+
+    meshes.push_back(_mesh);
+    draw_transforms.push_back(_transform);
+
+    // the mesh is laid out for the requested pipeline, the default one can only stand in if it reads the same vertices
+    const auto &desc = _pipeline.getDesc();
+    const bool canFallback = _mesh.getVertexInput() == getVertexInput<Vertex>() && desc.descriptor_set_layout == renderer_info.descriptor_set_layout;
+
+    draw_pipelines.push_back(DrawPipeline{std::move(_pipeline), canFallback});
+}
+
+void Renderer::setCamera(const glm::mat4 &view, const glm::mat4 &proj) {
+    camera.view = view;
+    camera.proj = proj;
+}
+
+const GraphicsPipeline *Renderer::resolvePipeline(const DrawPipeline &draw_pipeline) const {
+    if (!draw_pipeline.handle.isValid()) {
+        return renderer_info.graphics_pipeline.get();
+    }
+
+    if (draw_pipeline.handle.isReady()) {
+        return draw_pipeline.handle.get().get();
+    }
 
-    renderer_info.descritptor_pool =
-        std::make_shared<DescriptorPool>(renderer_info.device, *renderer_info.descriptor_set_layout, renderer_info.swapchain->getImageViewCount() * meshes.size());
+    return draw_pipeline.can_fallback ? renderer_info.graphics_pipeline.get() : nullptr;
+}
+
+void Renderer::uploadFrameData(std::uint32_t frame_index) {
+    CPU_ZONE("upload");
+
+    transforms.update();
+
+    // a single copy of every world matrix instead of one uniform write per draw
+    object_buffers[frame_index].write(std::as_bytes(transforms.getWorldMatrices()));
+    camera_buffers[frame_index].update(camera);
+}
 
-    const auto l1 = [&] {
-        std::vector<Buffer> buffers{};
-        buffers.reserve(meshes.size());
+void Renderer::recordDraws(const CommandBuffer &cmd, std::uint32_t first, std::uint32_t last, std::uint32_t frame_index) {
+    const GraphicsPipeline *boundPipeline = nullptr;
+    const auto batchCount = static_cast<std::uint32_t>(gpu_batch_draws.size());
 
-        for (std::uint32_t i = 0; i < meshes.size(); ++i) {
-            buffers.push_back(Buffer::createUniformBuffer(sizeof(UniformObject), renderer_info.device));
+    // summed locally, a single update of the shared counters per call
+    std::uint64_t draws = 0;
+    std::uint64_t instances = 0;
+    std::uint64_t triangles = 0;
+
+    for (auto item = first; item < last; ++item) {
+        const bool isBatch = item < batchCount;
+        const auto i = isBatch ? gpu_batch_draws[item] : draw_order[item - batchCount];
+
+        // pipelines still compiling never stall the frame
+        const auto *pipeline = resolvePipeline(draw_pipelines[i]);
+        if (pipeline == nullptr) {
+            continue;
+        }
+
+        if (pipeline != boundPipeline) {
+            pipeline->bind(cmd);
+            descriptor_sets[frame_index].bind(*pipeline, cmd);
+            boundPipeline = pipeline;
         }
-        return buffers;
-    };
 
-    const auto l2 = [&] {
-        std::vector<DescriptorSet> ds{};
-        ds.reserve(meshes.size());
+        meshes[i].bind(cmd);
 
-        for (std::uint32_t i = 0; i < meshes.size(); ++i) {
-            ds.emplace_back(renderer_info.device, renderer_info.descritptor_pool, renderer_info.descriptor_set_layout);
+        // quantized vertices are decoded in the vertex shader, the meshes of a batch share the vertex buffer and so its dequantization
+        if (pipeline->getDesc().push_constant_size >= sizeof(VertexDequantization)) {
+            const auto &dequantization = meshes[i].getDequantization();
+            pipeline->pushConstants(cmd, &dequantization, sizeof(dequantization));
         }
-        return ds;
+
+        if (isBatch) {
+            gpu_culler->drawBatch(cmd, frame_index, item);
+
+            instances += gpu_culler->getBatchObjectCount(item);
+            triangles += gpu_culler->getBatchTriangleCount(item);
+        } else {
+            // the first instance selects the world matrix in the object buffer
+            vkCmdDrawIndexed(cmd.getCommandBuffer(), meshes[i].getIndexCount(), 1, meshes[i].getFirstIndex(), meshes[i].getVertexOffset(), draw_transforms[i]);
+
+            instances += 1;
+            triangles += meshes[i].getIndexCount() / 3;
+        }
+        draws += 1;
+    }
+
+    RenderStats::add(RenderCounter::DRAWS, draws);
+    RenderStats::add(RenderCounter::INSTANCES, instances);
+    RenderStats::add(RenderCounter::TRIANGLES, triangles);
+}
+
+void Renderer::recordFrame(const CommandBuffer &cmd, std::uint32_t frame_index, std::uint32_t swapchain_image_index, const Frustum &frustum) {
+    CPU_ZONE("record");
+
+    cmd.reset();
+    cmd.begin();
+
+    // the previous submission of this slot has completed, its timestamps are read back without waiting
+    auto frameScope = GpuProfiler::invalid_scope;
+    if (gpu_profiler) {
+        gpu_profiler->beginFrame(cmd, frame_index);
+        frameScope = gpu_profiler->begin(cmd, "frame");
+    }
+
+    if (gpu_culler && async_compute) {
+        gpu_culler->acquire(cmd, frame_index, *async_compute);
+    } else if (gpu_culler) {
+        const GpuProfiler::Scope cullingScope(gpu_profiler.get(), cmd, "gpu culling");
+        gpu_culler->record(cmd, frame_index, frustum);
+    }
+
+    const std::array<VkClearValue, 2> clearValues = {
+        VkClearValue{.color = {{0.f, 0.f, 0.f, 1.f}}},
+        VkClearValue{.depthStencil = {1.f, 0}},
     };
+    sortDraws();
+    const auto itemCount = static_cast<std::uint32_t>(gpu_batch_draws.size() + draw_order.size());
 
-    for (std::uint32_t i = 0; i < renderer_info.swapchain->getImageViewCount(); ++i) {
-        uniform_buffers.push_back(l1());
-        desciptor_sets.emplace_back(l2());
+    const auto renderPassScope = gpu_profiler ? gpu_profiler->begin(cmd, "render pass") : GpuProfiler::invalid_scope;
+
+    // the query stays active while the secondary command buffers execute, which needs inherited queries
+    auto statisticsScope = GpuProfiler::invalid_scope;
+    if (gpu_profiler && (!recorder || gpu_profiler->getInheritedStatistics() != 0)) {
+        statisticsScope = gpu_profiler->beginStatistics(cmd, "render pass");
+    }
+
+    if (recorder) {
+        renderer_info.render_pass->begin(cmd, *framebuffers[swapchain_image_index], clearValues, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+
+        VkCommandBufferInheritanceInfo inheritance{};
+        inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+        inheritance.renderPass = renderer_info.render_pass->getPass();
+        inheritance.subpass = 0;
+        inheritance.framebuffer = framebuffers[swapchain_image_index]->getFramebuffer();
+        inheritance.pipelineStatistics = statisticsScope != GpuProfiler::invalid_scope ? gpu_profiler->getInheritedStatistics() : 0;
+
+        const auto secondaryCommandBuffers = recorder->record(
+            frame_index, inheritance, itemCount,
+            [&](const CommandBuffer &secondary, std::uint32_t first, std::uint32_t last) { recordDraws(secondary, first, last, frame_index); });
+
+        cmd.execute(secondaryCommandBuffers);
+    } else {
+        renderer_info.render_pass->begin(cmd, *framebuffers[swapchain_image_index], clearValues);
+        recordDraws(cmd, 0, itemCount, frame_index);
+    }
+
+    renderer_info.render_pass->end(cmd);
+
+    if (gpu_profiler) {
+        gpu_profiler->endStatistics(cmd, statisticsScope);
+        gpu_profiler->end(cmd, renderPassScope);
+        gpu_profiler->end(cmd, frameScope);
+    }
+
+    cmd.end();
+}
+
+void Renderer::end() {
+    createGraphicsPipeline();
+
+    if constexpr (config::enable_parallel_recording) {
+        recorder = std::make_unique<ParallelRecorder>(renderer_info.device, renderer_info.job_system, FRAME_OVERLAP);
+    }
+
+    renderer_info.descritptor_pool = std::make_shared<DescriptorPool>(renderer_info.device, *renderer_info.descriptor_set_layout, FRAME_OVERLAP);
+
+    // the store can't grow once rendering starts, its size is final here
+    const auto objectBufferSize = std::max<std::size_t>(transforms.size(), 1) * sizeof(math::Matrix4f);
+
+    // the world matrices are also read by the culling on the compute queue
+    std::vector<std::uint32_t> objectQueueFamilies = {renderer_info.device->getQueueFamilyIndex(QueueFamilyType::GRAPHICS)};
+    if (async_compute) {
+        objectQueueFamilies.push_back(renderer_info.device->getQueueFamilyIndex(QueueFamilyType::COMPUTE));
+    }
+
+    for (std::uint32_t i = 0; i < FRAME_OVERLAP; ++i) {
+        camera_buffers.push_back(Buffer::createUniformBuffer(sizeof(CameraData), renderer_info.device));
+        object_buffers.push_back(Buffer::createStorageBuffer(objectBufferSize, renderer_info.device, objectQueueFamilies));
+
+        auto &set = descriptor_sets.emplace_back(renderer_info.device, renderer_info.descritptor_pool, renderer_info.descriptor_set_layout);
+        set.update(0, camera_buffers.back());
+        set.update(1, object_buffers.back());
+    }
+
+    cpu_draws.resize(meshes.size());
+    std::iota(cpu_draws.begin(), cpu_draws.end(), 0);
+
+    if (config::enable_gpu_culling && renderer_info.device->supportsMultiDrawIndirect() && renderer_info.device->supportsDrawIndirectFirstInstance()) {
+        setupGpuCulling();
     }
 
     std::array frames = {FrameData(renderer_info.device), FrameData(renderer_info.device)};
+    auto &timeline = *renderer_info.timeline;
+
     while (!renderer_info.window->shouldClose()) {
-        const auto &commandBuffer = getCurrentFrame(frames, frame_number).commandBuffer;
+        CPU_ZONE("frame");
 
-        renderer_info.window->updateEvents();
+        auto &frame = getCurrentFrame(frames, frame_number);
+        const auto frameIndex = static_cast<std::uint32_t>(frame_number % FRAME_OVERLAP);
+        const auto &commandBuffer = frame.commandBuffer;
 
-        getCurrentFrame(frames, frame_number).renderFence.wait(std::numeric_limits<std::uint64_t>::max());
-        getCurrentFrame(frames, frame_number).renderFence.reset();
+        renderer_info.window->updateEvents();
+        renderer_info.job_system->runMainThreadJobs();
 
-        auto swapchainImageIndex = renderer_info.swapchain->acquireNextImage(getCurrentFrame(frames, frame_number).presentSemaphore);
+        // the command buffer and buffers of this slot can only be reused once its last submission has completed
+        {
+            CPU_ZONE("fence wait");
+            const RenderStats::Timer waitTimer(RenderCounter::FENCE_WAIT_NS);
+            timeline.wait(frame.submitted_value);
+        }
+        renderer_info.device->getMemoryBudget().update(static_cast<std::uint32_t>(frame_number));
+        uploadFrameData(frameIndex);
 
-        commandBuffer.reset();
-        commandBuffer.begin();
+        const auto frustum = Frustum::fromViewProjection(camera.proj * camera.view);
 
-        VkClearValue clearValue{
-            .color = {{0.f, 0.f, 0.f, 1.f}},
-        };
-        renderer_info.render_pass->begin(commandBuffer, *framebuffers[swapchainImageIndex], clearValue);
+        // submitted first so the compute queue culls while the cpu culls and records the rest of the frame
+        std::uint64_t computeValue = 0;
+        if (gpu_culler && async_compute) {
+            CPU_ZONE("compute submit");
+            computeValue = async_compute->submit([&](const CommandBuffer &cmd) { gpu_culler->recordAsync(cmd, frameIndex, frustum, *async_compute); });
+        }
 
-        renderer_info.graphics_pipeline->bind(commandBuffer);
+        cullDraws(frustum);
 
-        for (std::uint32_t i = 0; i < meshes.size(); ++i) {
-            desciptor_sets[swapchainImageIndex][i].bind(*renderer_info.graphics_pipeline, commandBuffer);
-            desciptor_sets[swapchainImageIndex][i].update(uniform_buffers[swapchainImageIndex][i]);
+        deletion_queue.collect(timeline.getCompletedValue());
+        if (shader_reloader) {
+            // pipelines replaced now were used at most by the submissions already made
+            shader_reloader->applyRebuilds(deletion_queue, timeline.getPendingValue());
+        }
 
-            meshes[i].bind(commandBuffer);
-            uniform_buffers[swapchainImageIndex][i].update(uniforms_data[i]);
+        std::uint32_t swapchainImageIndex = 0;
+        {
+            CPU_ZONE("acquire");
+            const RenderStats::Timer acquireTimer(RenderCounter::ACQUIRE_WAIT_NS);
+            swapchainImageIndex = renderer_info.swapchain->acquireNextImage(frame.presentSemaphore);
+        }
 
-            vkCmdDrawIndexed(commandBuffer.getCommandBuffer(), static_cast<std::uint32_t>(meshes[i].getIndices().size()), 1, 0, 0, 0);
+        const auto submitValue = timeline.nextValue();
+        recordFrame(commandBuffer, frameIndex, swapchainImageIndex, frustum);
+
+        // binary semaphores ignore their value, the timeline one is signaled alongside the render semaphore
+        const std::array<VkSemaphore, 2> signalSemaphores = {frame.renderSemaphore.getSemaphore(), timeline.getSemaphore()};
+        const std::array<std::uint64_t, 2> signalValues = {0, submitValue};
+
+        // the indirect draws read what the compute submission of this frame wrote
+        std::vector<VkSemaphore> waitSemaphores = {frame.presentSemaphore.getSemaphore()};
+        std::vector<std::uint64_t> waitValues = {0};
+        std::vector<VkPipelineStageFlags> waitStages = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
+        if (computeValue != 0) {
+            waitSemaphores.push_back(async_compute->getTimeline().getSemaphore());
+            waitValues.push_back(computeValue);
+            waitStages.push_back(VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT);
         }
 
-        renderer_info.render_pass->end(commandBuffer);
-        commandBuffer.end();
+        VkTimelineSemaphoreSubmitInfo timelineInfo{};
+        timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+
+        timelineInfo.waitSemaphoreValueCount = static_cast<std::uint32_t>(waitValues.size());
+        timelineInfo.pWaitSemaphoreValues = waitValues.data();
+        timelineInfo.signalSemaphoreValueCount = static_cast<std::uint32_t>(signalValues.size());
+        timelineInfo.pSignalSemaphoreValues = signalValues.data();
 
         VkSubmitInfo submit{};
         submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submit.pNext = &timelineInfo;
 
-        VkPipelineStageFlags waitStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        submit.pWaitDstStageMask = &waitStages;
+        submit.waitSemaphoreCount = static_cast<std::uint32_t>(waitSemaphores.size());
+        submit.pWaitSemaphores = waitSemaphores.data();
+        submit.pWaitDstStageMask = waitStages.data();
 
-        submit.waitSemaphoreCount = 1;
-        submit.pWaitSemaphores = &getCurrentFrame(frames, frame_number).presentSemaphore.getSemaphore();
-
-        submit.signalSemaphoreCount = 1;
-        submit.pSignalSemaphores = &getCurrentFrame(frames, frame_number).renderSemaphore.getSemaphore();
+        submit.signalSemaphoreCount = static_cast<std::uint32_t>(signalSemaphores.size());
+        submit.pSignalSemaphores = signalSemaphores.data();
 
         submit.commandBufferCount = 1;
         submit.pCommandBuffers = &commandBuffer.getCommandBuffer();
 
-        vkQueueSubmit(renderer_info.device->getQueue(QueueFamilyType::GRAPHICS), 1, &submit, getCurrentFrame(frames, frame_number).renderFence.getFence());
+        {
+            CPU_ZONE("submit");
+            renderer_info.device->submit(QueueFamilyType::GRAPHICS, submit, nullptr);
+        }
+        frame.submitted_value = submitValue;
 
         VkPresentInfoKHR presentInfo{};
         presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -164,19 +574,35 @@ void Renderer::end() {
         presentInfo.pSwapchains = &renderer_info.swapchain->getSwapchain();
 
         presentInfo.waitSemaphoreCount = 1;
-        presentInfo.pWaitSemaphores = &getCurrentFrame(frames, frame_number).renderSemaphore.getSemaphore();
+        presentInfo.pWaitSemaphores = &frame.renderSemaphore.getSemaphore();
 
         presentInfo.pImageIndices = &swapchainImageIndex;
 
-        vkQueuePresentKHR(renderer_info.device->getQueue(QueueFamilyType::PRESENT), &presentInfo);
+        {
+            CPU_ZONE("present");
+            renderer_info.device->present(presentInfo);
+        }
 
-        if (frame_number < 1) {
-            frame_number++;
-        } else {
-            frame_number = 0;
+        // also picks up the work done off the render thread for this frame, e.g. the parallel recording
+        {
+            const auto stats = RenderStats::collect();
+            std::scoped_lock lock(frame_stats_mutex);
+            frame_stats = stats;
         }
+
+        frame_number++;
     }
 
-    getCurrentFrame(frames, 0).renderFence.wait(std::numeric_limits<std::uint64_t>::max());
-    getCurrentFrame(frames, 1).renderFence.wait(std::numeric_limits<std::uint64_t>::max());
+    timeline.wait(timeline.getPendingValue());
+
+    deletion_queue.flush();
+
+    if constexpr (config::enable_cpu_profiler) {
+        CpuProfiler::exportChromeTrace(config::cpu_trace_path);
+    }
+}
+
+FrameStats Renderer::getFrameStats() const {
+    std::scoped_lock lock(frame_stats_mutex);
+    return frame_stats;
 }
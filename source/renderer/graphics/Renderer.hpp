@@ -1,10 +1,18 @@
 #pragma once
 
+#include <glm/mat4x4.hpp>
 #include <memory>
+#include <mutex>
 #include <span>
 
+#include "profiling/RenderStats.hpp"
+#include "renderer/graphics/PipelineCompiler.hpp"
+#include "renderer/graphics/PipelineDesc.hpp"
 #include "renderer/graphics/ressources/Buffer.hpp"
 #include "renderer/graphics/ressources/Mesh.hpp"
+#include "scene/FrustumCuller.hpp"
+#include "scene/TransformStore.hpp"
+#include "utility.hpp"
 
 class Instance;
 class Device;
@@ -17,14 +25,32 @@ class DescriptorPool;
 class DescriptorSet;
 
 class Buffer;
+class Image;
 
 class GraphicsPipeline;
+class PipelineRegistry;
+class ShaderLibrary;
+class ShaderHotReloader;
+class TimelineSemaphore;
 struct VertexInputDescription;
 struct ShaderResource;
 
+class ParallelRecorder;
+class GpuCuller;
+class AsyncCompute;
+class GpuProfiler;
+class CommandBuffer;
+
 class Window;
+class JobSystem;
 enum class DrawPrimitive;
 
+// per-frame uniform, model matrices live in the object storage buffer
+struct CameraData {
+    alignas(16) glm::mat4 view;
+    alignas(16) glm::mat4 proj;
+};
+
 class Renderer {
   public:
     struct RendererInfo {
@@ -33,11 +59,20 @@ class Renderer {
         std::shared_ptr<Swapchain> swapchain{nullptr};
         std::shared_ptr<RenderPass> render_pass{nullptr};
 
+        // signaled by every graphics submission
+        std::shared_ptr<TimelineSemaphore> timeline{nullptr};
+
         std::shared_ptr<Window> window{nullptr};
 
+        // shared by every subsystem running work off the render thread
+        std::shared_ptr<JobSystem> job_system{nullptr};
+
         std::shared_ptr<DescriptorSetLayout> descriptor_set_layout{nullptr};
         std::shared_ptr<DescriptorPool> descritptor_pool{nullptr};
 
+        std::shared_ptr<ShaderLibrary> shader_library{nullptr};
+        std::shared_ptr<PipelineRegistry> pipeline_registry{nullptr};
+        std::shared_ptr<PipelineCompiler> pipeline_compiler{nullptr};
         std::shared_ptr<GraphicsPipeline> graphics_pipeline{nullptr};
     };
 
@@ -46,24 +81,94 @@ class Renderer {
     ~Renderer();
 
     void begin();
-    void draw(const Mesh &_mesh, const UniformObject &_uniform_data);
+    void draw(const Mesh &_mesh, TransformId _transform);
+    // the draw is rendered with the default pipeline, or skipped if their vertex inputs differ, until _pipeline is ready
+    void draw(const Mesh &_mesh, TransformId _transform, PipelineHandle _pipeline);
     void end();
 
+    // uploaded once per frame, shared by every draw
+    void setCamera(const glm::mat4 &view, const glm::mat4 &proj);
+
+    [[nodiscard]] TransformStore &getTransforms() { return transforms; }
+    [[nodiscard]] const TransformStore &getTransforms() const { return transforms; }
+
+    // starting point for custom pipelines, compatible with the renderer's render pass and descriptor set layout
+    [[nodiscard]] PipelineDesc getDefaultPipelineDesc() const;
+    // the default description reading quantized vertices, quantized.spv dequantizes them with the push constants of each draw
+    [[nodiscard]] PipelineDesc getQuantizedPipelineDesc(VertexQuantization quantization) const;
+    [[nodiscard]] PipelineHandle compilePipeline(const PipelineDesc &desc);
+
     [[nodiscard]] const auto &getInfo() const { return renderer_info; }
 
+    // counters of the last rendered frame, a copy as end() keeps rendering while another thread reads them
+    [[nodiscard]] FrameStats getFrameStats() const;
+
+    // null when disabled, measures the "frame" and "render pass" scopes, and "gpu culling" when it runs on the graphics queue
+    // the pipeline statistics of the "render pass" are collected with config::enable_pipeline_statistics
+    [[nodiscard]] const GpuProfiler *getGpuProfiler() const { return gpu_profiler.get(); }
+
   private:
+    struct DrawPipeline {
+        PipelineHandle handle;
+        bool can_fallback = true;
+    };
+
     void createGraphicsPipeline();
+    // moves the opaque draws that can be batched to the gpu culler, the others stay in cpu_draws
+    void setupGpuCulling();
+    // flags the cpu draws whose bounding sphere is outside the camera frustum, sortDraws() leaves them out
+    void cullDraws(const Frustum &frustum);
+    void sortDraws();
+    // records the items [first, last), gpu batches come first and are followed by draw_order
+    // every call binds its own state so it can run on any thread
+    void recordDraws(const CommandBuffer &cmd, std::uint32_t first, std::uint32_t last, std::uint32_t frame_index);
+    // records the whole frame into the primary command buffer of frame_index, draws are recorded in parallel when a recorder is available
+    void recordFrame(const CommandBuffer &cmd, std::uint32_t frame_index, std::uint32_t swapchain_image_index, const Frustum &frustum);
+    // writes the camera and every world matrix into the buffers of frame_index, whose previous submission has completed
+    void uploadFrameData(std::uint32_t frame_index);
+    [[nodiscard]] const GraphicsPipeline *resolvePipeline(const DrawPipeline &draw_pipeline) const;
 
   private:
     RendererInfo renderer_info;
 
     std::vector<Mesh> meshes;
 
-    std::vector<UniformObject> uniforms_data;
-    std::vector<std::vector<Buffer>> uniform_buffers;
+    std::vector<TransformId> draw_transforms;
+    std::vector<DrawPipeline> draw_pipelines;
+
+    TransformStore transforms;
+    CameraData camera{glm::mat4(1.f), glm::mat4(1.f)};
+
+    // draws culled and sorted on the cpu, bounds and visibility are indexed like it
+    std::vector<std::uint32_t> cpu_draws;
+    std::unique_ptr<FrustumCuller> culler;
+    BoundingSpheres draw_bounds;
+    std::vector<std::uint8_t> draw_visibility;
+
+    std::unique_ptr<GpuCuller> gpu_culler;
+    // runs the gpu culling on a dedicated compute queue, overlapping the graphics work of the previous frame
+    std::unique_ptr<AsyncCompute> async_compute;
+    // the draw whose mesh and pipeline stand for each gpu batch
+    std::vector<std::uint32_t> gpu_batch_draws;
 
-    std::vector<std::vector<DescriptorSet>> desciptor_sets;
+    // opaque draws front to back so early depth testing rejects hidden fragments, then blended draws back to front
+    std::vector<std::uint32_t> draw_order;
+
+    // one of each per frame in flight, the object buffer holds every world matrix and draws index it with their first instance
+    std::vector<Buffer> camera_buffers;
+    std::vector<Buffer> object_buffers;
+    std::vector<DescriptorSet> descriptor_sets;
     std::vector<std::unique_ptr<Framebuffer>> framebuffers;
+    std::unique_ptr<Image> depth_image;
+
+    std::unique_ptr<ParallelRecorder> recorder;
+    std::unique_ptr<GpuProfiler> gpu_profiler;
+
+    DeferredDeletionQueue deletion_queue;
+    std::unique_ptr<ShaderHotReloader> shader_reloader;
+
+    std::uint64_t frame_number{0};
 
-    std::uint32_t frame_number{0};
+    mutable std::mutex frame_stats_mutex;
+    FrameStats frame_stats{};
 };
@@ -2,41 +2,49 @@
 
 #include <fmt/format.h>
 
-#include <fstream>
 #include <stdexcept>
 
+#include "io/MappedFile.hpp"
 #include "renderer/Device.hpp"
 
 namespace {
-    std::vector<char> readFile(const std::string_view filename) {
-        std::ifstream file(filename.data(), std::ios::ate | std::ios::binary);
-        if (!file.is_open()) {
-            throw std::fstream::failure(fmt::format("couldn't load spir-v file at : {}\n", filename));
-        }
-
-        auto fileSize = static_cast<std::size_t>(file.tellg());
-        std::vector<char> buffer(fileSize);
-
-        file.seekg(0);
-        file.read(buffer.data(), fileSize);
-        file.close();
-
-        return buffer;
-    }
+    constexpr std::uint32_t spirv_magic = 0x07230203;
 }  // namespace
 
 ShaderModule::ShaderModule(std::shared_ptr<Device> _device, const std::string_view filename, ShaderStage shaderStage) : device(std::move(_device)), shader_stage(shaderStage) {
-    shader_module = create(readFile(filename));
+    const auto file = MappedFile(filename);
+    shader_module = create(validateSpirv(file.getData(), filename));
+}
+
+ShaderModule::ShaderModule(std::shared_ptr<Device> _device, std::span<const std::uint32_t> code, ShaderStage shaderStage) : device(std::move(_device)), shader_stage(shaderStage) {
+    shader_module = create(code);
 }
 
 ShaderModule::~ShaderModule() { vkDestroyShaderModule(device->getDevice(), shader_module, nullptr); }
 
-VkShaderModule ShaderModule::create(std::span<const char> code) {
+std::span<const std::uint32_t> ShaderModule::validateSpirv(std::span<const std::byte> code, std::string_view filename) {
+    if (code.size() < sizeof(std::uint32_t) || code.size() % sizeof(std::uint32_t) != 0) {
+        throw std::runtime_error(fmt::format("spir-v file {} has an invalid size of {} bytes!", filename, code.size()));
+    }
+
+    if (reinterpret_cast<std::uintptr_t>(code.data()) % alignof(std::uint32_t) != 0) {
+        throw std::runtime_error(fmt::format("spir-v code of {} is not 4 bytes aligned!", filename));
+    }
+
+    auto words = std::span<const std::uint32_t>(reinterpret_cast<const std::uint32_t *>(code.data()), code.size() / sizeof(std::uint32_t));
+    if (words.front() != spirv_magic) {
+        throw std::runtime_error(fmt::format("{} is not a spir-v file (magic {:#010x})!", filename, words.front()));
+    }
+
+    return words;
+}
+
+VkShaderModule ShaderModule::create(std::span<const std::uint32_t> code) {
     VkShaderModuleCreateInfo shaderModuleInfo{};
     shaderModuleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
 
-    shaderModuleInfo.codeSize = code.size();
-    shaderModuleInfo.pCode = reinterpret_cast<const uint32_t *>(code.data());
+    shaderModuleInfo.codeSize = code.size_bytes();
+    shaderModuleInfo.pCode = code.data();
 
     VkShaderModule shaderModule = nullptr;
     if (vkCreateShaderModule(device->getDevice(), &shaderModuleInfo, nullptr, &shaderModule) != VK_SUCCESS) {
@@ -2,6 +2,8 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <span>
 #include <string>
@@ -15,6 +17,7 @@ class Device;
 enum class ShaderStage {
     VERTEX_SHADER,
     FRAGMENT_SHADER,
+    COMPUTE_SHADER,
 };
 
 enum class ShaderResourceType {
@@ -45,13 +48,17 @@ struct ShaderResource {
 class ShaderModule : public NoCopy, public NoMove {
   public:
     ShaderModule(std::shared_ptr<Device> _device, std::string_view filename, ShaderStage shader_stage);
+    ShaderModule(std::shared_ptr<Device> _device, std::span<const std::uint32_t> code, ShaderStage shader_stage);
     ~ShaderModule();
 
     [[nodiscard]] constexpr ShaderStage getStage() const { return shader_stage; }
     [[nodiscard]] VkShaderModule getShaderModule() const { return shader_module; }
 
+    // checks the spir-v magic number and the word alignment, throws on malformed code
+    [[nodiscard]] static std::span<const std::uint32_t> validateSpirv(std::span<const std::byte> code, std::string_view filename);
+
   private:
-    VkShaderModule create(std::span<const char> code);
+    VkShaderModule create(std::span<const std::uint32_t> code);
 
   private:
     std::shared_ptr<Device> device;
@@ -0,0 +1,170 @@
+#include "renderer/graphics/ShaderHotReloader.hpp"
+
+#include <fmt/color.h>
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+
+#include "renderer/Device.hpp"
+#include "renderer/graphics/GraphicsPipeline.hpp"
+#include "renderer/graphics/ShaderLibrary.hpp"
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    using namespace std::chrono_literals;
+
+    // editors and compilers usually write a file in several steps, wait for the writes to settle before rebuilding
+    constexpr auto debounce_delay = 50ms;
+    constexpr auto poll_interval = 250ms;
+
+    bool isSpirvFile(const std::filesystem::path &filepath) { return filepath.extension() == ".spv"; }
+}  // namespace
+
+ShaderHotReloader::ShaderHotReloader(std::shared_ptr<ShaderLibrary> _shader_library, std::filesystem::path _directory)
+    : shader_library(std::move(_shader_library)), directory(std::move(_directory)) {
+    watcher = std::jthread([this](std::stop_token stop_token) { watch(std::move(stop_token)); });
+}
+
+ShaderHotReloader::~ShaderHotReloader() {
+    watcher.request_stop();
+    if (watcher.joinable()) {
+        watcher.join();
+    }
+}
+
+void ShaderHotReloader::track(const std::shared_ptr<GraphicsPipeline> &pipeline) {
+    auto lock = std::scoped_lock(mutex);
+
+    std::erase_if(pipelines, [](const auto &tracked) { return tracked.expired(); });
+    pipelines.push_back(pipeline);
+}
+
+void ShaderHotReloader::applyRebuilds(DeferredDeletionQueue &deletion_queue, std::uint64_t retire_value) {
+    auto lock = std::scoped_lock(mutex);
+
+    for (const auto &pipeline : rebuilt_pipelines) {
+        if (auto retired = pipeline->applyRebuild(); retired != nullptr) {
+            deletion_queue.push_function(retire_value, [dev = pipeline->getDevice()->getDevice(), retired] { vkDestroyPipeline(dev, retired, nullptr); });
+            fmt::print("[shader reload] : reloaded {} and {}\n", pipeline->getDesc().vertex_shader_path, pipeline->getDesc().fragment_shader_path);
+        }
+    }
+
+    rebuilt_pipelines.clear();
+}
+
+void ShaderHotReloader::rebuild(const std::vector<std::filesystem::path> &changed_files) {
+    for (const auto &file : changed_files) {
+        shader_library->invalidate(file);
+    }
+
+    std::vector<std::shared_ptr<GraphicsPipeline>> affected;
+    {
+        auto lock = std::scoped_lock(mutex);
+        for (const auto &tracked : pipelines) {
+            auto pipeline = tracked.lock();
+            if (pipeline && std::ranges::any_of(changed_files, [&](const auto &file) { return pipeline->usesShader(file); })) {
+                affected.push_back(std::move(pipeline));
+            }
+        }
+    }
+
+    for (auto &pipeline : affected) {
+        try {
+            pipeline->rebuild();
+
+            auto lock = std::scoped_lock(mutex);
+            rebuilt_pipelines.push_back(std::move(pipeline));
+        } catch (const std::exception &e) {
+            // keep rendering with the previous pipeline until the shader is fixed
+            fmt::print(fmt::fg(fmt::color::orange_red) | fmt::emphasis::bold, "[shader reload] : {}\n", e.what());
+        }
+    }
+}
+
+#ifdef __linux__
+void ShaderHotReloader::watch(std::stop_token stop_token) {
+    const int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0 || inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        fmt::print(fmt::fg(fmt::color::orange_red) | fmt::emphasis::bold, "[shader reload] : couldn't watch {}\n", directory.string());
+        if (fd >= 0) {
+            close(fd);
+        }
+        return;
+    }
+
+    alignas(inotify_event) char buffer[4096];
+
+    while (!stop_token.stop_requested()) {
+        pollfd pollInfo{.fd = fd, .events = POLLIN, .revents = 0};
+        if (poll(&pollInfo, 1, static_cast<int>(poll_interval.count())) <= 0) {
+            continue;
+        }
+
+        std::this_thread::sleep_for(debounce_delay);
+
+        std::vector<std::filesystem::path> changed;
+        for (auto length = read(fd, buffer, sizeof(buffer)); length > 0; length = read(fd, buffer, sizeof(buffer))) {
+            for (char *it = buffer; it < buffer + length;) {
+                const auto *event = reinterpret_cast<const inotify_event *>(it);
+
+                if (event->len > 0) {
+                    auto file = directory / event->name;
+                    if (isSpirvFile(file) && std::ranges::find(changed, file) == changed.end()) {
+                        changed.push_back(std::move(file));
+                    }
+                }
+
+                it += sizeof(inotify_event) + event->len;
+            }
+        }
+
+        if (!changed.empty()) {
+            rebuild(changed);
+        }
+    }
+
+    close(fd);
+}
+#else
+void ShaderHotReloader::watch(std::stop_token stop_token) {
+    std::map<std::filesystem::path, std::filesystem::file_time_type> write_times;
+
+    const auto scan = [&](std::vector<std::filesystem::path> *changed) {
+        std::error_code error;
+        for (const auto &entry : std::filesystem::directory_iterator(directory, error)) {
+            if (!entry.is_regular_file() || !isSpirvFile(entry.path())) {
+                continue;
+            }
+
+            const auto writeTime = entry.last_write_time(error);
+            auto [it, inserted] = write_times.try_emplace(entry.path(), writeTime);
+            if (!inserted && it->second != writeTime) {
+                it->second = writeTime;
+                if (changed != nullptr) {
+                    changed->push_back(entry.path());
+                }
+            }
+        }
+    };
+
+    scan(nullptr);
+
+    while (!stop_token.stop_requested()) {
+        std::this_thread::sleep_for(poll_interval);
+
+        std::vector<std::filesystem::path> changed;
+        scan(&changed);
+
+        if (!changed.empty()) {
+            std::this_thread::sleep_for(debounce_delay);
+            rebuild(changed);
+        }
+    }
+}
+#endif
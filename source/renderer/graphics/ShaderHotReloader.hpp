@@ -0,0 +1,39 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "utility.hpp"
+
+class GraphicsPipeline;
+class ShaderLibrary;
+
+// Watches a directory of spir-v files and rebuilds the pipelines using a changed shader on its own thread.
+// Rebuilt pipelines are only swapped in when the render thread calls applyRebuilds() at a frame boundary.
+class ShaderHotReloader final : public NoCopy, public NoMove {
+  public:
+    ShaderHotReloader(std::shared_ptr<ShaderLibrary> _shader_library, std::filesystem::path _directory);
+    ~ShaderHotReloader();
+
+    void track(const std::shared_ptr<GraphicsPipeline> &pipeline);
+
+    // retired pipelines are handed to the deletion queue and destroyed once the gpu has reached retire_value
+    void applyRebuilds(DeferredDeletionQueue &deletion_queue, std::uint64_t retire_value);
+
+  private:
+    void watch(std::stop_token stop_token);
+    void rebuild(const std::vector<std::filesystem::path> &changed_files);
+
+  private:
+    std::shared_ptr<ShaderLibrary> shader_library;
+    std::filesystem::path directory;
+
+    std::mutex mutex;
+    std::vector<std::weak_ptr<GraphicsPipeline>> pipelines;
+    std::vector<std::shared_ptr<GraphicsPipeline>> rebuilt_pipelines;
+
+    std::jthread watcher;
+};
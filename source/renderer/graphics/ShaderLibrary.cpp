@@ -0,0 +1,54 @@
+#include "renderer/graphics/ShaderLibrary.hpp"
+
+#include <algorithm>
+
+#include "io/MappedFile.hpp"
+#include "renderer/Device.hpp"
+#include "renderer/graphics/Shader.hpp"
+
+ShaderLibrary::ShaderLibrary(std::shared_ptr<Device> _device) : device(std::move(_device)) {}
+
+ShaderLibrary::~ShaderLibrary() = default;
+
+std::shared_ptr<ShaderModule> ShaderLibrary::load(std::string_view filepath, ShaderStage stage) {
+    auto pathKey = PathKey{std::string(filepath), stage};
+
+    auto lock = std::scoped_lock(mutex);
+
+    if (auto it = paths_lookup.find(pathKey); it != paths_lookup.end()) {
+        return modules.at(it->second);
+    }
+
+    const auto file = MappedFile(filepath);
+    const auto code = ShaderModule::validateSpirv(file.getData(), filepath);
+
+    const auto moduleKey = ModuleKey{util::fnv1a(std::as_bytes(code)), code.size_bytes(), stage};
+
+    auto it = modules.find(moduleKey);
+    if (it == modules.end()) {
+        it = modules.emplace(moduleKey, std::make_shared<ShaderModule>(device, code, stage)).first;
+    }
+
+    paths_lookup.emplace(std::move(pathKey), moduleKey);
+
+    return it->second;
+}
+
+void ShaderLibrary::invalidate(const std::filesystem::path &filepath) {
+    std::error_code error;
+    const auto target = std::filesystem::weakly_canonical(filepath, error);
+
+    auto lock = std::scoped_lock(mutex);
+
+    std::erase_if(paths_lookup, [&](const auto &entry) { return std::filesystem::weakly_canonical(entry.first.filepath, error) == target; });
+
+    // pipelines keep working after their modules are destroyed, so unreferenced modules can go right away
+    std::erase_if(modules, [&](const auto &module) {
+        return std::ranges::none_of(paths_lookup, [&](const auto &entry) { return entry.second == module.first; });
+    });
+}
+
+std::size_t ShaderLibrary::getModuleCount() const {
+    auto lock = std::scoped_lock(mutex);
+    return modules.size();
+}
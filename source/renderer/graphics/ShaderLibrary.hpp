@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "utility.hpp"
+
+class Device;
+class ShaderModule;
+
+enum class ShaderStage;
+
+// Caches shader modules by file path and by spir-v content, so pipelines sharing a shader only read and compile it once.
+class ShaderLibrary final : public NoCopy, public NoMove {
+  public:
+    explicit ShaderLibrary(std::shared_ptr<Device> _device);
+    ~ShaderLibrary();
+
+    [[nodiscard]] std::shared_ptr<ShaderModule> load(std::string_view filepath, ShaderStage stage);
+
+    // forgets the cached modules of a file so the next load reads it from disk again
+    void invalidate(const std::filesystem::path &filepath);
+
+    [[nodiscard]] std::size_t getModuleCount() const;
+
+  private:
+    struct ModuleKey {
+        std::uint64_t content_hash;
+        std::size_t code_size;
+        ShaderStage stage;
+
+        bool operator==(const ModuleKey &) const = default;
+    };
+
+    struct ModuleKeyHash {
+        std::size_t operator()(const ModuleKey &key) const noexcept { return key.content_hash ^ (key.code_size << 1) ^ static_cast<std::size_t>(key.stage); }
+    };
+
+    struct PathKey {
+        std::string filepath;
+        ShaderStage stage;
+
+        bool operator==(const PathKey &) const = default;
+    };
+
+    struct PathKeyHash {
+        std::size_t operator()(const PathKey &key) const noexcept { return std::hash<std::string>{}(key.filepath) ^ static_cast<std::size_t>(key.stage); }
+    };
+
+  private:
+    std::shared_ptr<Device> device;
+
+    mutable std::mutex mutex;
+    std::unordered_map<PathKey, ModuleKey, PathKeyHash> paths_lookup;
+    std::unordered_map<ModuleKey, std::shared_ptr<ShaderModule>, ModuleKeyHash> modules;
+};
@@ -1,41 +1,93 @@
 #include "renderer/graphics/ressources/Buffer.hpp"
 
+#include <algorithm>
 #include <cstring>
 #include <renderer/sync/CommandBuffer.hpp>
 #include <stdexcept>
+#include <vector>
 
+#include "profiling/RenderStats.hpp"
 #include "renderer/Device.hpp"
+#include "renderer/MemoryBudget.hpp"
 #include "renderer/graphics/GraphicsPipeline.hpp"
 #include "renderer/graphics/ressources/Mesh.hpp"
 #include "renderer/sync/CommandBuffer.hpp"
 
-Buffer::Buffer(std::shared_ptr<Device> _device, const Type _type, VkDeviceSize bufferSize, VkBufferUsageFlags bufferUsage, VmaMemoryUsage memoryUsage)
+namespace {
+    MemoryCategory getMemoryCategory(Buffer::Type type) {
+        switch (type) {
+            case Buffer::Type::VBO:
+                return MemoryCategory::VERTEX_BUFFER;
+
+            case Buffer::Type::IBO:
+                return MemoryCategory::INDEX_BUFFER;
+
+            case Buffer::Type::UBO:
+                return MemoryCategory::UNIFORM_BUFFER;
+
+            case Buffer::Type::SSBO:
+                return MemoryCategory::STORAGE_BUFFER;
+
+            default:
+                return MemoryCategory::STAGING_BUFFER;
+        }
+    }
+}  // namespace
+
+Buffer::Buffer(
+    std::shared_ptr<Device> _device, const Type _type, VkDeviceSize bufferSize, VkBufferUsageFlags bufferUsage, VmaMemoryUsage memoryUsage, VmaAllocationCreateFlags allocationFlags,
+    std::span<const std::uint32_t> queueFamilies)
     : device(std::move(_device)), bufferSize(bufferSize), type(_type) {
     VkBufferCreateInfo bufferInfo{};
     bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
 
     bufferInfo.size = bufferSize;
-    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     bufferInfo.usage = bufferUsage;
 
+    std::vector<std::uint32_t> uniqueFamilies(queueFamilies.begin(), queueFamilies.end());
+    std::sort(uniqueFamilies.begin(), uniqueFamilies.end());
+    uniqueFamilies.erase(std::unique(uniqueFamilies.begin(), uniqueFamilies.end()), uniqueFamilies.end());
+
+    if (uniqueFamilies.size() > 1) {
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = static_cast<std::uint32_t>(uniqueFamilies.size());
+        bufferInfo.pQueueFamilyIndices = uniqueFamilies.data();
+    } else {
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    }
+
     VmaAllocationCreateInfo allocationInfo{};
     allocationInfo.usage = memoryUsage;
+    allocationInfo.flags = allocationFlags;
 
-    if (vmaCreateBuffer(device->getAllocator(), &bufferInfo, &allocationInfo, &buffer, &allocation, nullptr) != VK_SUCCESS) {
+    VmaAllocationInfo allocationResult{};
+    if (vmaCreateBuffer(device->getAllocator(), &bufferInfo, &allocationInfo, &buffer, &allocation, &allocationResult) != VK_SUCCESS) {
         throw std::runtime_error("failed to create buffer!");
     } else {
-        DeletionQueue::push_function([allocator = device->getAllocator(), buf = buffer, alloc = allocation]() { vmaDestroyBuffer(allocator, buf, alloc); });
+        mapped_data = allocationResult.pMappedData;
+        RenderStats::add(RenderCounter::ALLOCATIONS);
+
+        auto &budget = device->getMemoryBudget();
+        const auto category = getMemoryCategory(type);
+        budget.track(category, allocationResult.size);
+
+        DeletionQueue::push_function([allocator = device->getAllocator(), buf = buffer, alloc = allocation, &budget, category, size = allocationResult.size]() {
+            vmaDestroyBuffer(allocator, buf, alloc);
+            budget.untrack(category, size);
+        });
     }
 }
 
-void Buffer::bind(const CommandBuffer &cmd) const {
+void Buffer::bind(const CommandBuffer &cmd, VkIndexType index_type) const {
     switch (this->type) {
         case Type::VBO:
             vkCmdBindVertexBuffers(cmd.getCommandBuffer(), 0, 1, &buffer, 0);
+            RenderStats::add(RenderCounter::VERTEX_BUFFER_BINDS);
             break;
 
         case Type::IBO:
-			vkCmdBindIndexBuffer(cmd.getCommandBuffer(), buffer, 0, VK_INDEX_TYPE_UINT16);
+			vkCmdBindIndexBuffer(cmd.getCommandBuffer(), buffer, 0, index_type);
+            RenderStats::add(RenderCounter::INDEX_BUFFER_BINDS);
             break;
 
         default:
@@ -43,24 +95,29 @@ void Buffer::bind(const CommandBuffer &cmd) const {
     }
 }
 
-void Buffer::update(const UniformObject &ubo) {
-    if (this->type != Type::UBO) {
-        throw std::runtime_error("cannot update a non ubo buffer!");
+void Buffer::write(std::span<const std::byte> data, VkDeviceSize offset) {
+    if (mapped_data == nullptr) {
+        throw std::runtime_error("cannot write to a buffer that is not persistently mapped!");
     }
 
-    void *data;
-    vmaMapMemory(device->getAllocator(), allocation, &data);
-    std::memcpy(data, &ubo, sizeof(ubo));
-    vmaUnmapMemory(device->getAllocator(), allocation);
+    if (offset + data.size() > bufferSize) {
+        throw std::runtime_error("write out of the buffer bounds!");
+    }
+
+    std::memcpy(static_cast<std::byte *>(mapped_data) + offset, data.data(), data.size());
+    // host visible memory isn't always coherent, the flush is a no-op when it is
+    vmaFlushAllocation(device->getAllocator(), allocation, offset, data.size());
+    RenderStats::add(RenderCounter::BYTES_UPLOADED, data.size());
 }
 
-Buffer Buffer::createVertexBuffer(std::span<const Vertex> vertices, const std::shared_ptr<Device> &device) {
-    const VkDeviceSize bufferSize = vertices.size() * sizeof(Vertex);
+Buffer Buffer::createVertexBuffer(std::span<const std::byte> vertices, const std::shared_ptr<Device> &device) {
+    const VkDeviceSize bufferSize = vertices.size();
     auto stagingBuffer = Buffer(device, Type::STAGING, bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
 
     void *data;
     vmaMapMemory(device->getAllocator(), stagingBuffer.getAllocation(), &data);
     std::memcpy(data, vertices.data(), bufferSize);
+    RenderStats::add(RenderCounter::BYTES_UPLOADED, bufferSize);
     vmaUnmapMemory(device->getAllocator(), stagingBuffer.getAllocation());
 
     auto vertexBuffer = Buffer(device, Type::VBO, bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
@@ -69,13 +126,14 @@ Buffer Buffer::createVertexBuffer(std::span<const Vertex> vertices, const std::s
     return vertexBuffer;
 }
 
-Buffer Buffer::createIndexBuffer(std::span<const std::uint16_t> indices, const std::shared_ptr<Device> &device) {
-    const VkDeviceSize bufferSize = indices.size() * sizeof(std::uint16_t);
+Buffer Buffer::createIndexBuffer(std::span<const std::byte> indices, const std::shared_ptr<Device> &device) {
+    const VkDeviceSize bufferSize = indices.size();
     auto stagingBuffer = Buffer(device, Type::STAGING, bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
 
     void *data;
     vmaMapMemory(device->getAllocator(), stagingBuffer.getAllocation(), &data);
     std::memcpy(data, indices.data(), bufferSize);
+    RenderStats::add(RenderCounter::BYTES_UPLOADED, bufferSize);
     vmaUnmapMemory(device->getAllocator(), stagingBuffer.getAllocation());
 
     auto indexBuffer = Buffer(device, Type::IBO, bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
@@ -84,21 +142,15 @@ Buffer Buffer::createIndexBuffer(std::span<const std::uint16_t> indices, const s
     return indexBuffer;
 }
 
-Buffer Buffer::createUniformBuffer(std::uint32_t bufferSize, const std::shared_ptr<Device> &device) {
-    auto stagingBuffer = Buffer(device, Type::STAGING, bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
-
-    auto uniformBuffer = Buffer(device, Type::UBO, bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
-    copy(stagingBuffer, uniformBuffer, device);
+Buffer Buffer::createUniformBuffer(VkDeviceSize bufferSize, const std::shared_ptr<Device> &device) {
+    return Buffer(device, Type::UBO, bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU, VMA_ALLOCATION_CREATE_MAPPED_BIT);
+}
 
-    return uniformBuffer;
+Buffer Buffer::createStorageBuffer(VkDeviceSize bufferSize, const std::shared_ptr<Device> &device, std::span<const std::uint32_t> queueFamilies) {
+    return Buffer(device, Type::SSBO, bufferSize, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU, VMA_ALLOCATION_CREATE_MAPPED_BIT, queueFamilies);
 }
 
 void Buffer::copy(const Buffer &src, const Buffer &dest, const std::shared_ptr<Device> &device) {
-    const auto commandPool = CommandPool(device, QueueFamilyType::GRAPHICS);
-    const auto cmd = CommandBuffer(*device, commandPool);
-
-    cmd.begin();
-
     VkBufferCopy bufferCopy;
     bufferCopy.dstOffset = 0;
     bufferCopy.srcOffset = 0;
@@ -108,15 +160,5 @@ void Buffer::copy(const Buffer &src, const Buffer &dest, const std::shared_ptr<D
         bufferCopy.size = src.bufferSize;
     }
 
-    vkCmdCopyBuffer(cmd.getCommandBuffer(), src.getBuffer(), dest.getBuffer(), 1, &bufferCopy);
-
-    cmd.end();
-
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &cmd.getCommandBuffer();
-
-    vkQueueSubmit(device->getQueue(QueueFamilyType::GRAPHICS), 1, &submitInfo, nullptr);
+    device->immediateSubmit([&](const CommandBuffer &cmd) { vkCmdCopyBuffer(cmd.getCommandBuffer(), src.getBuffer(), dest.getBuffer(), 1, &bufferCopy); });
 }
@@ -3,6 +3,8 @@
 #include <vendor/vk_mem_alloc.h>
 #include <vulkan/vulkan_core.h>
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <span>
 
@@ -11,32 +13,46 @@
 class Device;
 class CommandBuffer;
 
-struct Vertex;
-struct UniformObject;
-
 class Buffer final {
   public:
     enum class Type {
         VBO,
         IBO,
         UBO,
+        SSBO,
 		STAGING,
     };
 
   public:
-    Buffer(std::shared_ptr<Device> _device, const Type _type, VkDeviceSize bufferSize, VkBufferUsageFlags bufferUsage, VmaMemoryUsage memoryUsage);
+    // VMA_ALLOCATION_CREATE_MAPPED_BIT in allocationFlags keeps the buffer persistently mapped for write()
+    // a buffer used by several distinct queueFamilies is shared concurrently and needs no ownership transfer
+    Buffer(
+        std::shared_ptr<Device> _device, const Type _type, VkDeviceSize bufferSize, VkBufferUsageFlags bufferUsage, VmaMemoryUsage memoryUsage,
+        VmaAllocationCreateFlags allocationFlags = 0, std::span<const std::uint32_t> queueFamilies = {});
 
     [[nodiscard]] auto getBuffer() const { return buffer; }
     [[nodiscard]] auto getAllocation() const { return allocation; }
 
     [[nodiscard]] Type getType() const { return type; }
+    [[nodiscard]] VkDeviceSize getSize() const { return bufferSize; }
+
+    // index buffers don't know the type of their indices
+    void bind(const CommandBuffer &cmd, VkIndexType index_type = VK_INDEX_TYPE_UINT16) const;
+
+    // copies into the persistent mapping, the caller makes sure the gpu no longer reads this range
+    void write(std::span<const std::byte> data, VkDeviceSize offset = 0);
 
-    void bind(const CommandBuffer &cmd) const;
-    void update(const UniformObject &ubo);
+    template <typename T>
+    void update(const T &value) {
+        write(std::as_bytes(std::span(&value, 1)));
+    }
 
-    static Buffer createVertexBuffer(std::span<const Vertex> vertices, const std::shared_ptr<Device> &device);
-    static Buffer createIndexBuffer(std::span<const std::uint16_t> indices, const std::shared_ptr<Device> &device);
-    static Buffer createUniformBuffer(std::uint32_t bufferSize, const std::shared_ptr<Device> &device);
+    // the raw bytes of the vertices or indices, whatever their layout or index type
+    static Buffer createVertexBuffer(std::span<const std::byte> vertices, const std::shared_ptr<Device> &device);
+    static Buffer createIndexBuffer(std::span<const std::byte> indices, const std::shared_ptr<Device> &device);
+    // host visible and persistently mapped, they are rewritten by the cpu every frame
+    static Buffer createUniformBuffer(VkDeviceSize bufferSize, const std::shared_ptr<Device> &device);
+    static Buffer createStorageBuffer(VkDeviceSize bufferSize, const std::shared_ptr<Device> &device, std::span<const std::uint32_t> queueFamilies = {});
 
     static void copy(const Buffer &src, const Buffer &dest, const std::shared_ptr<Device> &device);
 
@@ -48,4 +64,5 @@ class Buffer final {
     VkDeviceSize bufferSize;
 
     VmaAllocation allocation;
+    void *mapped_data = nullptr;
 };
@@ -2,10 +2,12 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <cstdint>
 #include <memory>
 
 class Device;
 class GraphicsPipeline;
+class ComputePipeline;
 class CommandBuffer;
 
 class DescriptorPool;
@@ -22,7 +24,9 @@ class DescriptorSet final {
     DescriptorSet &operator=(DescriptorSet &&other) noexcept;
 
     void bind(const GraphicsPipeline &pipeline, const CommandBuffer &cmd) const;
-    void update(const Buffer &buffer) const;
+    void bind(const ComputePipeline &pipeline, const CommandBuffer &cmd) const;
+    // points binding at the whole buffer
+    void update(std::uint32_t binding, const Buffer &buffer) const;
 
     [[nodiscard]] VkDescriptorSet getSet() const { return descriptor_set; }
 
@@ -1,6 +1,9 @@
+#include <algorithm>
 #include <stdexcept>
 
+#include "profiling/RenderStats.hpp"
 #include "renderer/Device.hpp"
+#include "renderer/graphics/ComputePipeline.hpp"
 #include "renderer/graphics/DescriptorSetLayout.hpp"
 #include "renderer/graphics/GraphicsPipeline.hpp"
 #include "renderer/graphics/Shader.hpp"
@@ -58,29 +61,40 @@ DescriptorSet &DescriptorSet::operator=(DescriptorSet &&other) noexcept {
 
 void DescriptorSet::bind(const GraphicsPipeline &pipeline, const CommandBuffer &cmd) const {
     vkCmdBindDescriptorSets(cmd.getCommandBuffer(), VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline.getPipelineLayout(), 0, 1, &descriptor_set, 0, nullptr);
+    RenderStats::add(RenderCounter::DESCRIPTOR_BINDS);
 }
 
-void DescriptorSet::update(const Buffer &buffer) const {
-    for (auto binding : layout->getBindings()) {
-        VkDescriptorBufferInfo bufferInfo{};
-        bufferInfo.buffer = buffer.getBuffer();
-        bufferInfo.offset = 0;
-        bufferInfo.range = sizeof(UniformObject);
+void DescriptorSet::bind(const ComputePipeline &pipeline, const CommandBuffer &cmd) const {
+    vkCmdBindDescriptorSets(cmd.getCommandBuffer(), VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.getPipelineLayout(), 0, 1, &descriptor_set, 0, nullptr);
+    RenderStats::add(RenderCounter::DESCRIPTOR_BINDS);
+}
 
-        VkWriteDescriptorSet writeDescriptorSet{};
-        writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+void DescriptorSet::update(std::uint32_t binding, const Buffer &buffer) const {
+    const auto &bindings = layout->getBindings();
+    const auto it = std::ranges::find(bindings, binding, &VkDescriptorSetLayoutBinding::binding);
+    if (it == bindings.end()) {
+        throw std::runtime_error("descriptor set layout has no such binding!");
+    }
 
-        writeDescriptorSet.dstSet = descriptor_set;
-        writeDescriptorSet.dstBinding = binding.binding;
-        writeDescriptorSet.dstArrayElement = 0;
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = buffer.getBuffer();
+    bufferInfo.offset = 0;
+    bufferInfo.range = VK_WHOLE_SIZE;
 
-        writeDescriptorSet.descriptorCount = binding.descriptorCount;
-        writeDescriptorSet.descriptorType = binding.descriptorType;
+    VkWriteDescriptorSet writeDescriptorSet{};
+    writeDescriptorSet.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
 
-        writeDescriptorSet.pBufferInfo = &bufferInfo;
-        writeDescriptorSet.pImageInfo = nullptr;
-        writeDescriptorSet.pTexelBufferView = nullptr;
+    writeDescriptorSet.dstSet = descriptor_set;
+    writeDescriptorSet.dstBinding = it->binding;
+    writeDescriptorSet.dstArrayElement = 0;
 
-        vkUpdateDescriptorSets(device->getDevice(), 1, &writeDescriptorSet, 0, nullptr);
-    }
+    writeDescriptorSet.descriptorCount = 1;
+    writeDescriptorSet.descriptorType = it->descriptorType;
+
+    writeDescriptorSet.pBufferInfo = &bufferInfo;
+    writeDescriptorSet.pImageInfo = nullptr;
+    writeDescriptorSet.pTexelBufferView = nullptr;
+
+    vkUpdateDescriptorSets(device->getDevice(), 1, &writeDescriptorSet, 0, nullptr);
+    RenderStats::add(RenderCounter::DESCRIPTOR_WRITES);
 }
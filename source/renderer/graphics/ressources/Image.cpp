@@ -2,46 +2,86 @@
 
 #include <vendor/stb_image.h>
 
+#include <fmt/format.h>
+
+#include <cstring>
 #include <stdexcept>
+#include <string>
 #include <string_view>
 #include <utility>
 
+#include "profiling/RenderStats.hpp"
 #include "renderer/Device.hpp"
 #include "renderer/graphics/ressources/Buffer.hpp"
 #include "renderer/sync/CommandBuffer.hpp"
-#include "renderer/sync/CommandPool.hpp"
 #include "utility.hpp"
 
-Image::Image(std::shared_ptr<Device> device, std::string_view filepath) : m_device{std::move(device)} {
-    int textWidth, textHeight, textChannels;
-    stbi_uc *pixels = stbi_load(filepath.data(), &textWidth, &textHeight, &textChannels, STBI_rgb_alpha);
+DecodedImage::DecodedImage(unsigned char *_pixels, int _width, int _height)
+    : pixels(_pixels), width(static_cast<std::uint32_t>(_width)), height(static_cast<std::uint32_t>(_height)) {}
 
-    VkDeviceSize imageSize = textWidth * textHeight * 4;
+DecodedImage DecodedImage::fromFile(std::string_view filepath) {
+    const auto path = std::string(filepath);
 
+    int width, height, channels;
+    stbi_uc *pixels = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
     if (!pixels) {
-        throw std::runtime_error("failed to load texture image!");
-    } else {
-        imageWidth = textWidth;
-        imageHeight = textHeight;
+        throw std::runtime_error(fmt::format("failed to load texture image {} : {}!", path, stbi_failure_reason()));
+    }
+
+    return {pixels, width, height};
+}
+
+DecodedImage DecodedImage::fromMemory(std::span<const std::byte> encoded) {
+    int width, height, channels;
+    stbi_uc *pixels =
+        stbi_load_from_memory(reinterpret_cast<const stbi_uc *>(encoded.data()), static_cast<int>(encoded.size()), &width, &height, &channels, STBI_rgb_alpha);
+    if (!pixels) {
+        throw std::runtime_error(fmt::format("failed to decode texture image : {}!", stbi_failure_reason()));
     }
 
+    return {pixels, width, height};
+}
+
+DecodedImage::~DecodedImage() { stbi_image_free(pixels); }
+
+DecodedImage::DecodedImage(DecodedImage &&other) noexcept
+    : pixels(std::exchange(other.pixels, nullptr)), width(std::exchange(other.width, 0)), height(std::exchange(other.height, 0)) {}
+
+DecodedImage &DecodedImage::operator=(DecodedImage &&other) noexcept {
+    if (this != &other) {
+        stbi_image_free(pixels);
+
+        pixels = std::exchange(other.pixels, nullptr);
+        width = std::exchange(other.width, 0);
+        height = std::exchange(other.height, 0);
+    }
+    return *this;
+}
+
+std::span<const std::byte> DecodedImage::getPixels() const { return {reinterpret_cast<const std::byte *>(pixels), static_cast<std::size_t>(width) * height * 4}; }
+
+Image::Image(std::shared_ptr<Device> device, std::string_view filepath) : Image(std::move(device), DecodedImage::fromFile(filepath)) {}
+
+Image::Image(std::shared_ptr<Device> device, const DecodedImage &decoded)
+    : m_device{std::move(device)}, imageWidth(decoded.getExtent().width), imageHeight(decoded.getExtent().height) {
+    const auto pixels = decoded.getPixels();
+    const auto imageSize = static_cast<VkDeviceSize>(pixels.size());
+
     auto stagingBuffer = Buffer(m_device, Buffer::Type::STAGING, imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY);
 
     void *data;
-    void *pixel_ptr = pixels;
 
     vmaMapMemory(m_device->getAllocator(), stagingBuffer.getAllocation(), &data);
-    std::memcpy(data, pixel_ptr, imageSize);
+    std::memcpy(data, pixels.data(), imageSize);
+    RenderStats::add(RenderCounter::BYTES_UPLOADED, imageSize);
     vmaUnmapMemory(m_device->getAllocator(), stagingBuffer.getAllocation());
 
-    stbi_image_free(pixels);
-
     VkImageCreateInfo imageInfo{};
     imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
 
     imageInfo.imageType = VK_IMAGE_TYPE_2D;
-    imageInfo.extent.width = static_cast<std::uint32_t>(textWidth);
-    imageInfo.extent.height = static_cast<std::uint32_t>(textHeight);
+    imageInfo.extent.width = imageWidth;
+    imageInfo.extent.height = imageHeight;
     imageInfo.extent.depth = 1;
     imageInfo.mipLevels = 1;
     imageInfo.arrayLayers = 1;
@@ -58,9 +98,14 @@ Image::Image(std::shared_ptr<Device> device, std::string_view filepath) : m_devi
     VmaAllocationCreateInfo allocInfo{};
     allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
 
-    if (vmaCreateImage(m_device->getAllocator(), &imageInfo, &allocInfo, &image, &textureAllocation, nullptr) != VK_SUCCESS) {
+    VmaAllocationInfo allocationResult{};
+    if (vmaCreateImage(m_device->getAllocator(), &imageInfo, &allocInfo, &image, &textureAllocation, &allocationResult) != VK_SUCCESS) {
         throw std::runtime_error("failed to create image!");
     } else {
+        RenderStats::add(RenderCounter::ALLOCATIONS);
+
+        allocation_size = allocationResult.size;
+        m_device->getMemoryBudget().track(memory_category, allocation_size);
         transitionLayout(VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
         copy(stagingBuffer);
@@ -69,18 +114,77 @@ Image::Image(std::shared_ptr<Device> device, std::string_view filepath) : m_devi
     }
 }
 
+Image::Image(std::shared_ptr<Device> device, VkExtent2D extent, VkFormat _format, VkImageUsageFlags usage)
+    : m_device{std::move(device)}, format(_format), imageWidth(extent.width), imageHeight(extent.height) {
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width = extent.width;
+    imageInfo.extent.height = extent.height;
+    imageInfo.extent.depth = 1;
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+
+    imageInfo.format = format;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+
+    imageInfo.usage = usage;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.flags = 0;
+
+    VmaAllocationCreateInfo allocInfo{};
+    allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+    // attachments are large and long lived, give them their own memory block
+    allocInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+
+    VmaAllocationInfo allocationResult{};
+    if (vmaCreateImage(m_device->getAllocator(), &imageInfo, &allocInfo, &image, &textureAllocation, &allocationResult) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create attachment image!");
+    }
+    RenderStats::add(RenderCounter::ALLOCATIONS);
+
+    memory_category = MemoryCategory::ATTACHMENT;
+    allocation_size = allocationResult.size;
+    m_device->getMemoryBudget().track(memory_category, allocation_size);
+
+    VkImageViewCreateInfo imageViewInfo{};
+    imageViewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+
+    imageViewInfo.image = image;
+    imageViewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    imageViewInfo.format = format;
+
+    imageViewInfo.subresourceRange.aspectMask = (usage & VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT) ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+    imageViewInfo.subresourceRange.baseMipLevel = 0;
+    imageViewInfo.subresourceRange.levelCount = 1;
+    imageViewInfo.subresourceRange.baseArrayLayer = 0;
+    imageViewInfo.subresourceRange.layerCount = 1;
+
+    if (vkCreateImageView(m_device->getDevice(), &imageViewInfo, nullptr, &image_view) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create attachment image view!");
+    }
+}
+
 Image::~Image() {
-    DeletionQueue::push_function([allocator = m_device->getAllocator(), img = image, textureAlloc = textureAllocation] { vmaDestroyImage(allocator, img, textureAlloc); });
+    DeletionQueue::push_function(
+        [allocator = m_device->getAllocator(), img = image, textureAlloc = textureAllocation, &budget = m_device->getMemoryBudget(), category = memory_category,
+         size = allocation_size] {
+            vmaDestroyImage(allocator, img, textureAlloc);
+            budget.untrack(category, size);
+        });
+
+    // the deletion queue runs in reverse order, the view goes before its image
+    if (image_view != nullptr) {
+        DeletionQueue::push_function([dev = m_device->getDevice(), view = image_view] { vkDestroyImageView(dev, view, nullptr); });
+    }
 }
 
 void Image::bind() const { vmaBindImageMemory(m_device->getAllocator(), textureAllocation, image); }
 
 void Image::copy(const Buffer &stagingBuffer) {
-    const auto commandPool = CommandPool(m_device, QueueFamilyType::GRAPHICS);
-    const auto cmd = CommandBuffer(*m_device, commandPool);
-
-    cmd.begin();
-
     VkBufferImageCopy region{};
     region.bufferOffset = 0;
     region.bufferRowLength = 0;
@@ -98,26 +202,12 @@ void Image::copy(const Buffer &stagingBuffer) {
         1,
     };
 
-    vkCmdCopyBufferToImage(cmd.getCommandBuffer(), stagingBuffer.getBuffer(), image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-    cmd.end();
-
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &cmd.getCommandBuffer();
-
-    vkQueueSubmit(m_device->getQueue(QueueFamilyType::GRAPHICS), 1, &submitInfo, nullptr);
-    vkQueueWaitIdle(m_device->getQueue(QueueFamilyType::GRAPHICS));
+    m_device->immediateSubmit([&](const CommandBuffer &cmd) {
+        vkCmdCopyBufferToImage(cmd.getCommandBuffer(), stagingBuffer.getBuffer(), image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+    });
 }
 
 void Image::transitionLayout(VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout) {
-    const auto cmdPool = CommandPool(m_device, QueueFamilyType::GRAPHICS);
-    const auto cmd = CommandBuffer(*m_device, cmdPool);
-
-    cmd.begin();
-
     VkImageMemoryBarrier barrier{};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
 
@@ -156,16 +246,6 @@ void Image::transitionLayout(VkFormat format, VkImageLayout oldLayout, VkImageLa
         throw std::invalid_argument("unsupported layout transition!");
     }
 
-    vkCmdPipelineBarrier(cmd.getCommandBuffer(), sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-    cmd.end();
-
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &cmd.getCommandBuffer();
-
-    vkQueueSubmit(m_device->getQueue(QueueFamilyType::GRAPHICS), 1, &submitInfo, nullptr);
-    vkQueueWaitIdle(m_device->getQueue(QueueFamilyType::GRAPHICS));
+    m_device->immediateSubmit(
+        [&](const CommandBuffer &cmd) { vkCmdPipelineBarrier(cmd.getCommandBuffer(), sourceStage, destinationStage, 0, 0, nullptr, 0, nullptr, 1, &barrier); });
 }
@@ -3,17 +3,48 @@
 #include <vendor/vk_mem_alloc.h>
 #include <vulkan/vulkan_core.h>
 
+#include <cstddef>
 #include <memory>
+#include <span>
 #include <string_view>
 
+#include "renderer/MemoryBudget.hpp"
 #include "utility.hpp"
 
 class Device;
 class Buffer;
 
+// RGBA8 pixels decoded by stb_image. Decoding doesn't touch the device, so it can run in a job ahead of the upload.
+class DecodedImage final : public NoCopy {
+  public:
+    static DecodedImage fromFile(std::string_view filepath);
+    // from the encoded bytes of a png, jpeg..., e.g. an image embedded in a model
+    static DecodedImage fromMemory(std::span<const std::byte> encoded);
+
+    ~DecodedImage();
+
+    DecodedImage(DecodedImage &&other) noexcept;
+    DecodedImage &operator=(DecodedImage &&other) noexcept;
+
+    [[nodiscard]] std::span<const std::byte> getPixels() const;
+    [[nodiscard]] VkExtent2D getExtent() const { return {width, height}; }
+
+  private:
+    DecodedImage(unsigned char *_pixels, int _width, int _height);
+
+  private:
+    unsigned char *pixels = nullptr;
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+};
+
 class Image final : public NoCopy, public NoMove {
   public:
     Image(std::shared_ptr<Device> device, std::string_view filepath);
+    // sampled texture uploaded from pixels decoded beforehand
+    Image(std::shared_ptr<Device> device, const DecodedImage &decoded);
+    // render target living on the gpu only, with a view over the whole image
+    Image(std::shared_ptr<Device> device, VkExtent2D extent, VkFormat format, VkImageUsageFlags usage);
     ~Image();
 
     void bind() const;
@@ -23,12 +54,20 @@ class Image final : public NoCopy, public NoMove {
 
     [[nodiscard]] auto getImage() const { return image; }
     [[nodiscard]] auto getImageAllocation() const { return textureAllocation; }
+    [[nodiscard]] const VkImageView &getImageView() const { return image_view; }
+    [[nodiscard]] auto getFormat() const { return format; }
 
   private:
     std::shared_ptr<Device> m_device;
 
     VkImage image{nullptr};
     VmaAllocation textureAllocation{nullptr};
+    VkImageView image_view{nullptr};
+
+    VkFormat format{VK_FORMAT_R8G8B8A8_SRGB};
+
+    MemoryCategory memory_category{MemoryCategory::TEXTURE};
+    VkDeviceSize allocation_size{0};
 
     std::uint32_t imageWidth, imageHeight;
 };
@@ -1,32 +1,341 @@
 #include "renderer/graphics/ressources/Mesh.hpp"
 
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/packing.hpp>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "io/MappedFile.hpp"
+#include "io/MeshFile.hpp"
+#include "profiling/RenderStats.hpp"
+#include "renderer/graphics/PipelineDesc.hpp"
 #include "renderer/Device.hpp"
 #include "renderer/graphics/ressources/Buffer.hpp"
 #include "renderer/sync/CommandBuffer.hpp"
 
-Mesh::Mesh(DrawPrimitive _primitive, std::shared_ptr<Device> _device, std::span<const Vertex> _vertices, std::span<std::uint16_t> _indices)
-    : device(std::move(_device)), primitive(_primitive), vertices(_vertices.begin(), _vertices.end()), indices(_indices.begin(), _indices.end()) {
-    if (!vertices.empty()) {
-		const auto &vbo = Buffer::createVertexBuffer(vertices, device);
-		vertexBuffer.buffer = vbo.getBuffer();
-		vertexBuffer.allocation = vbo.getAllocation();
+namespace {
+    // reads the position at location 0 of every vertex, whatever the layout, quantized positions are read as they are stored
+    MeshBounds computeBounds(std::span<const std::byte> vertex_data, const VertexInputDescription &vertex_input) {
+        const auto stride = vertex_input.bindings.front().stride;
+        const auto vertexCount = vertex_data.size() / stride;
+        if (vertexCount == 0) {
+            return {};
+        }
+
+        const auto position = std::ranges::find(vertex_input.attributes, 0u, &VkVertexInputAttributeDescription::location);
+        if (position == vertex_input.attributes.end()) {
+            throw std::runtime_error("mesh positions must be at location 0!");
+        }
+
+        const auto read = [&](std::size_t vertex) {
+            const auto *data = vertex_data.data() + vertex * stride + position->offset;
+
+            glm::vec3 value{0.f};
+            std::array<std::uint16_t, 3> packed{};
+
+            switch (position->format) {
+                case VK_FORMAT_R32G32_SFLOAT:
+                    std::memcpy(&value, data, 2 * sizeof(float));
+                    break;
+
+                case VK_FORMAT_R32G32B32_SFLOAT:
+                    std::memcpy(&value, data, 3 * sizeof(float));
+                    break;
+
+                case VK_FORMAT_R16G16B16A16_SNORM:
+                    std::memcpy(packed.data(), data, sizeof(packed));
+                    value = {glm::unpackSnorm1x16(packed[0]), glm::unpackSnorm1x16(packed[1]), glm::unpackSnorm1x16(packed[2])};
+                    break;
+
+                case VK_FORMAT_R16G16B16A16_SFLOAT:
+                    std::memcpy(packed.data(), data, sizeof(packed));
+                    value = {glm::unpackHalf1x16(packed[0]), glm::unpackHalf1x16(packed[1]), glm::unpackHalf1x16(packed[2])};
+                    break;
+
+                default:
+                    throw std::runtime_error("mesh positions must be floats, half floats or snorm16 at location 0!");
+            }
+
+            return value;
+        };
+
+        MeshBounds bounds{read(0), read(0)};
+        for (std::size_t vertex = 1; vertex < vertexCount; ++vertex) {
+            const auto value = read(vertex);
+            bounds.min = glm::min(bounds.min, value);
+            bounds.max = glm::max(bounds.max, value);
+        }
+
+        // the sphere around the box is looser than the minimal one but is found in a single pass
+        bounds.center = (bounds.min + bounds.max) * 0.5f;
+        bounds.radius = glm::length(bounds.max - bounds.center);
+
+        return bounds;
+    }
+
+    // the unit vector projected on the octahedron, whose lower half is folded over the upper one
+    glm::vec2 encodeOctahedral(const glm::vec3 &normal) {
+        const auto length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+        if (length == 0.f) {
+            return glm::vec2(0.f);
+        }
+
+        const auto projected = normal / length;
+        if (projected.z >= 0.f) {
+            return glm::vec2(projected.x, projected.y);
+        }
+
+        return glm::vec2(
+            (1.f - std::abs(projected.y)) * (projected.x >= 0.f ? 1.f : -1.f), (1.f - std::abs(projected.x)) * (projected.y >= 0.f ? 1.f : -1.f));
+    }
+
+    template <typename V>
+    std::vector<V> quantizeVertices(std::span<const Vertex> vertices, const VertexDequantization &dequantization) {
+        std::vector<V> quantized;
+        quantized.reserve(vertices.size());
+
+        // the engine's vertices have no normal, they face +z like its 2d geometry
+        for (const auto &vertex : vertices) {
+            quantized.push_back(V::quantize(vertex.position, glm::vec3(0.f, 0.f, 1.f), glm::vec4(vertex.color, 1.f), dequantization));
+        }
+
+        return quantized;
+    }
+
+    // the file must describe the single interleaved binding of the vertex type
+    bool matchesVertexLayout(const MeshFileView &view, const VertexInputDescription &description) {
+        if (view.header.vertex_stride != description.bindings.front().stride || view.attributes.size() != description.attributes.size()) {
+            return false;
+        }
+
+        return std::ranges::all_of(description.attributes, [&](const VkVertexInputAttributeDescription &expected) {
+            return std::ranges::any_of(view.attributes, [&](const MeshFileAttribute &attribute) {
+                return attribute.location == expected.location && attribute.format == static_cast<std::uint32_t>(expected.format) && attribute.offset == expected.offset;
+            });
+        });
     }
-    if (!indices.empty()) {
-		const auto &ibo = Buffer::createIndexBuffer(indices, device);
-        indexBuffer.buffer = ibo.getBuffer();
-        indexBuffer.allocation = ibo.getAllocation();
+
+    // the vertex types a mesh file can be laid out as
+    const VertexInputDescription *findVertexLayout(const MeshFileView &view) {
+        for (const auto *description : {&getVertexInput<Vertex>(), &getVertexInput<SpriteVertex>()}) {
+            if (matchesVertexLayout(view, *description)) {
+                return description;
+            }
+        }
+        return nullptr;
     }
+}  // namespace
+
+std::uint32_t SpriteVertex::packColor(const glm::vec4 &color) {
+    const auto bytes = glm::round(glm::clamp(color, 0.f, 1.f) * 255.f);
+    return static_cast<std::uint32_t>(bytes.r) | static_cast<std::uint32_t>(bytes.g) << 8 | static_cast<std::uint32_t>(bytes.b) << 16 |
+           static_cast<std::uint32_t>(bytes.a) << 24;
+}
+
+VertexDequantization makeVertexDequantization(const MeshBounds &bounds) {
+    const auto center = (bounds.min + bounds.max) * 0.5f;
+    return VertexDequantization{.scale = glm::vec4(bounds.max - center, 1.f), .offset = glm::vec4(center, 0.f)};
+}
+
+template <VkFormat position_format>
+    requires(position_format == VK_FORMAT_R16G16B16A16_SNORM || position_format == VK_FORMAT_R16G16B16A16_SFLOAT)
+BasicQuantizedVertex<position_format> BasicQuantizedVertex<position_format>::quantize(
+    const glm::vec3 &position, const glm::vec3 &normal, const glm::vec4 &color, const VertexDequantization &dequantization) {
+    BasicQuantizedVertex vertex{};
+
+    for (glm::length_t axis = 0; axis < 3; ++axis) {
+        // a flat axis has a zero scale, all of its positions are the offset
+        const auto scale = dequantization.scale[axis];
+        const auto relative = scale != 0.f ? std::clamp((position[axis] - dequantization.offset[axis]) / scale, -1.f, 1.f) : 0.f;
+
+        if constexpr (position_format == VK_FORMAT_R16G16B16A16_SNORM) {
+            vertex.position[axis] = glm::packSnorm1x16(relative);
+        } else {
+            vertex.position[axis] = glm::packHalf1x16(relative);
+        }
+    }
+
+    const auto octahedral = encodeOctahedral(normal);
+    vertex.normal = {glm::packSnorm1x16(octahedral.x), glm::packSnorm1x16(octahedral.y)};
+    vertex.color = SpriteVertex::packColor(color);
+
+    return vertex;
+}
+
+template QuantizedVertex QuantizedVertex::quantize(const glm::vec3 &, const glm::vec3 &, const glm::vec4 &, const VertexDequantization &);
+template HalfQuantizedVertex HalfQuantizedVertex::quantize(const glm::vec3 &, const glm::vec3 &, const glm::vec4 &, const VertexDequantization &);
+
+Mesh::Mesh(
+    DrawPrimitive _primitive, std::shared_ptr<Device> _device, std::span<const std::byte> vertex_data, const VertexInputDescription &_vertex_input,
+    std::span<const std::uint16_t> _indices)
+    : primitive(_primitive),
+      device(std::move(_device)),
+      vertex_input(&_vertex_input),
+      vertex_count(static_cast<std::uint32_t>(vertex_data.size() / _vertex_input.bindings.front().stride)),
+      index_count(static_cast<std::uint32_t>(_indices.size())),
+      index_type(VK_INDEX_TYPE_UINT16),
+      bounds(computeBounds(vertex_data, _vertex_input)) {
+    upload(vertex_data, std::as_bytes(_indices));
+}
+
+Mesh::Mesh(
+    DrawPrimitive _primitive, std::shared_ptr<Device> _device, std::span<const std::byte> vertex_data, const VertexInputDescription &_vertex_input,
+    std::span<const std::uint32_t> _indices)
+    : primitive(_primitive),
+      device(std::move(_device)),
+      vertex_input(&_vertex_input),
+      vertex_count(static_cast<std::uint32_t>(vertex_data.size() / _vertex_input.bindings.front().stride)),
+      index_count(static_cast<std::uint32_t>(_indices.size())),
+      bounds(computeBounds(vertex_data, _vertex_input)) {
+    // 16 bit indices halve the index buffer and its fetches, 32 bits are only kept for meshes addressing more than 65536 vertices
+    if (std::ranges::all_of(_indices, [](std::uint32_t index) { return index <= std::numeric_limits<std::uint16_t>::max(); })) {
+        const auto narrowed = std::vector<std::uint16_t>(_indices.begin(), _indices.end());
+
+        index_type = VK_INDEX_TYPE_UINT16;
+        upload(vertex_data, std::as_bytes(std::span(narrowed)));
+    } else {
+        index_type = VK_INDEX_TYPE_UINT32;
+        upload(vertex_data, std::as_bytes(_indices));
+    }
+}
+
+Mesh::Mesh(
+    std::shared_ptr<Device> _device, AllocatedBuffer vertex_buffer, AllocatedBuffer index_buffer, const MeshRange &range, const MeshBounds &_bounds,
+    const VertexInputDescription &_vertex_input, VkIndexType _index_type, const VertexDequantization &_dequantization)
+    : primitive(DrawPrimitive::TRIANGLE),
+      device(std::move(_device)),
+      vertex_input(&_vertex_input),
+      vertexBuffer(vertex_buffer),
+      vertex_count(range.vertex_count),
+      vertex_offset(range.vertex_offset),
+      indexBuffer(index_buffer),
+      index_count(range.index_count),
+      first_index(range.first_index),
+      index_type(_index_type),
+      bounds(_bounds),
+      dequantization(_dequantization) {}
+
+void Mesh::upload(std::span<const std::byte> vertex_data, std::span<const std::byte> index_data) {
+    if (!vertex_data.empty()) {
+        const auto vbo = Buffer::createVertexBuffer(vertex_data, device);
+        vertexBuffer = {vbo.getBuffer(), vbo.getAllocation()};
+    }
+    if (!index_data.empty()) {
+        const auto ibo = Buffer::createIndexBuffer(index_data, device);
+        indexBuffer = {ibo.getBuffer(), ibo.getAllocation()};
+    }
+}
+
+Mesh Mesh::load(std::shared_ptr<Device> device, std::string_view filepath) {
+    const auto file = MappedFile(filepath);
+    const auto view = parseMeshFile(file.getData());
+    const auto &header = view.header;
+
+    const auto *vertexInput = findVertexLayout(view);
+    if (vertexInput == nullptr) {
+        throw std::runtime_error(fmt::format("mesh file {} doesn't match any vertex layout!", filepath));
+    }
+
+    Mesh mesh;
+    mesh.device = std::move(device);
+    mesh.primitive = DrawPrimitive::TRIANGLE;
+    mesh.vertex_input = vertexInput;
+    mesh.index_type = header.index_size == sizeof(std::uint32_t) ? VK_INDEX_TYPE_UINT32 : VK_INDEX_TYPE_UINT16;
+
+    mesh.vertex_count = header.vertex_count;
+    mesh.index_count = header.index_count;
+
+    mesh.bounds.min = {header.bounds_min[0], header.bounds_min[1], header.bounds_min[2]};
+    mesh.bounds.max = {header.bounds_max[0], header.bounds_max[1], header.bounds_max[2]};
+    mesh.bounds.center = {header.bounds_center[0], header.bounds_center[1], header.bounds_center[2]};
+    mesh.bounds.radius = header.bounds_radius;
+
+    const auto vertexSize = static_cast<VkDeviceSize>(view.vertex_data.size());
+    const auto indexSize = static_cast<VkDeviceSize>(view.index_data.size());
+    if (vertexSize == 0) {
+        return mesh;
+    }
+
+    // a single staging buffer and submission for both blobs, the mapping is the only source of the copy
+    auto stagingBuffer = Buffer(
+        mesh.device, Buffer::Type::STAGING, vertexSize + indexSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY, VMA_ALLOCATION_CREATE_MAPPED_BIT);
+    stagingBuffer.write(view.vertex_data);
+    stagingBuffer.write(view.index_data, vertexSize);
+
+    const auto vbo = Buffer(mesh.device, Buffer::Type::VBO, vertexSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+    mesh.vertexBuffer = {vbo.getBuffer(), vbo.getAllocation()};
+
+    std::optional<Buffer> ibo;
+    if (indexSize > 0) {
+        ibo.emplace(mesh.device, Buffer::Type::IBO, indexSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+        mesh.indexBuffer = {ibo->getBuffer(), ibo->getAllocation()};
+    }
+
+    mesh.device->immediateSubmit([&](const CommandBuffer &cmd) {
+        const VkBufferCopy vertexCopy{.srcOffset = 0, .dstOffset = 0, .size = vertexSize};
+        vkCmdCopyBuffer(cmd.getCommandBuffer(), stagingBuffer.getBuffer(), vbo.getBuffer(), 1, &vertexCopy);
+
+        if (ibo) {
+            const VkBufferCopy indexCopy{.srcOffset = vertexSize, .dstOffset = 0, .size = indexSize};
+            vkCmdCopyBuffer(cmd.getCommandBuffer(), stagingBuffer.getBuffer(), ibo->getBuffer(), 1, &indexCopy);
+        }
+    });
+
+    return mesh;
+}
+
+template <MeshIndex I>
+Mesh Mesh::quantize(
+    DrawPrimitive primitive, std::shared_ptr<Device> device, std::span<const Vertex> vertices, std::span<const I> indices, VertexQuantization quantization) {
+    if (quantization == VertexQuantization::NONE) {
+        return Mesh(primitive, std::move(device), vertices, indices);
+    }
+
+    const auto bounds = computeBounds(std::as_bytes(vertices), getVertexInput<Vertex>());
+    const auto dequantization = makeVertexDequantization(bounds);
+
+    auto mesh = quantization == VertexQuantization::SNORM16 ? Mesh(primitive, std::move(device), quantizeVertices<QuantizedVertex>(vertices, dequantization), indices)
+                                                            : Mesh(primitive, std::move(device), quantizeVertices<HalfQuantizedVertex>(vertices, dequantization), indices);
+
+    // the bounds of the stored positions are relative to the box, culling needs the model space ones
+    mesh.bounds = bounds;
+    mesh.dequantization = dequantization;
+
+    return mesh;
+}
+
+Mesh Mesh::quantized(
+    DrawPrimitive primitive, std::shared_ptr<Device> device, std::span<const Vertex> vertices, std::span<const std::uint16_t> indices,
+    VertexQuantization quantization) {
+    return quantize(primitive, std::move(device), vertices, indices, quantization);
+}
+
+Mesh Mesh::quantized(
+    DrawPrimitive primitive, std::shared_ptr<Device> device, std::span<const Vertex> vertices, std::span<const std::uint32_t> indices,
+    VertexQuantization quantization) {
+    return quantize(primitive, std::move(device), vertices, indices, quantization);
 }
 
 void Mesh::bind(const CommandBuffer &cmd) const {
-    if (!vertices.empty()) {
+    if (vertex_count > 0) {
         VkDeviceSize offset = 0;
         vkCmdBindVertexBuffers(cmd.getCommandBuffer(), 0, 1, &vertexBuffer.buffer, &offset);
+        RenderStats::add(RenderCounter::VERTEX_BUFFER_BINDS);
     }
 
-    if (!indices.empty()) {
+    if (index_count > 0) {
         VkDeviceSize offset = 0;
-        vkCmdBindIndexBuffer(cmd.getCommandBuffer(), indexBuffer.buffer, offset, VK_INDEX_TYPE_UINT16);
+        vkCmdBindIndexBuffer(cmd.getCommandBuffer(), indexBuffer.buffer, offset, index_type);
+        RenderStats::add(RenderCounter::INDEX_BUFFER_BINDS);
     }
 }
 
@@ -3,10 +3,20 @@
 #include <vendor/vk_mem_alloc.h>
 #include <vulkan/vulkan_core.h>
 
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <glm/vec2.hpp>
 #include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
 #include <memory>
+#include <ranges>
 #include <span>
-#include <vector>
+#include <string_view>
+#include <type_traits>
+
+#include "renderer/graphics/PipelineDesc.hpp"
 
 class Device;
 class CommandBuffer;
@@ -16,8 +26,14 @@ enum class DrawPrimitive {
     RECTANGLE,
 };
 
+// A vertex type describes its single interleaved binding, position at location 0 and color at location 1 like the default shaders.
+template <typename T>
+concept VertexLayout = std::is_trivially_copyable_v<T> && requires {
+    { T::getVertexInputDescription() } -> std::same_as<VertexInputDescription>;
+};
 
-struct VertexInputDescription;
+template <typename T>
+concept MeshIndex = std::same_as<T, std::uint16_t> || std::same_as<T, std::uint32_t>;
 
 struct Vertex {
     glm::vec3 position;
@@ -26,16 +42,106 @@ struct Vertex {
     static VertexInputDescription getVertexInputDescription();
 };
 
+// 2d vertex for sprites and ui, 12 bytes instead of the 24 of Vertex
+struct SpriteVertex {
+    glm::vec2 position;
+    // RGBA8 with red in the lowest byte
+    std::uint32_t color;
+
+    static VertexInputDescription getVertexInputDescription();
+    [[nodiscard]] static std::uint32_t packColor(const glm::vec4 &color);
+};
+
+static_assert(sizeof(SpriteVertex) == 12);
+
+// how imported geometry stores its vertices, quantized meshes need a pipeline built from Renderer::getQuantizedPipelineDesc()
+enum class VertexQuantization {
+    NONE,
+    SNORM16,
+    FLOAT16,
+};
+
+// maps quantized positions, in [-1, 1] over the box they were quantized in, back to model space
+// pushed to the vertex shader as is, hence the vec4s
+struct VertexDequantization {
+    glm::vec4 scale{1.f};
+    glm::vec4 offset{0.f};
+
+    [[nodiscard]] glm::vec3 apply(const glm::vec3 &position) const { return glm::vec3(scale) * position + glm::vec3(offset); }
+};
+
+// 16 bytes instead of the 24 of Vertex, with a normal, the position is decoded by the VertexDequantization of its mesh
+template <VkFormat position_format>
+    requires(position_format == VK_FORMAT_R16G16B16A16_SNORM || position_format == VK_FORMAT_R16G16B16A16_SFLOAT)
+struct BasicQuantizedVertex {
+    // xyz as snorm16 or half floats, w is padding
+    std::array<std::uint16_t, 4> position;
+    // unit normal octahedrally encoded as two snorm16
+    std::array<std::uint16_t, 2> normal;
+    // RGBA8 with red in the lowest byte
+    std::uint32_t color;
+
+    static VertexInputDescription getVertexInputDescription();
+    // positions outside of the box the dequantization was made for are clamped
+    [[nodiscard]] static BasicQuantizedVertex quantize(
+        const glm::vec3 &position, const glm::vec3 &normal, const glm::vec4 &color, const VertexDequantization &dequantization);
+};
+
+using QuantizedVertex = BasicQuantizedVertex<VK_FORMAT_R16G16B16A16_SNORM>;
+using HalfQuantizedVertex = BasicQuantizedVertex<VK_FORMAT_R16G16B16A16_SFLOAT>;
+
+static_assert(sizeof(QuantizedVertex) == 16);
+
+// built once per layout, meshes point to it instead of holding a copy
+template <VertexLayout V>
+[[nodiscard]] const VertexInputDescription &getVertexInput() {
+    static const auto description = V::getVertexInputDescription();
+    return description;
+}
+
+// axis aligned box and bounding sphere of the vertices, in model space
+struct MeshBounds {
+    glm::vec3 min{0.f};
+    glm::vec3 max{0.f};
+
+    glm::vec3 center{0.f};
+    float radius = 0.f;
+};
+
+// quantizes to [-1, 1] over the box of the bounds, a flat axis stays flat
+[[nodiscard]] VertexDequantization makeVertexDequantization(const MeshBounds &bounds);
+
+// where a mesh lies in vertex and index buffers shared with other meshes, e.g. the primitives of a model
+struct MeshRange {
+    std::int32_t vertex_offset = 0;
+    std::uint32_t vertex_count = 0;
+
+    std::uint32_t first_index = 0;
+    std::uint32_t index_count = 0;
+};
+
 class Mesh {
   public:
     struct AllocatedBuffer {
-        VkBuffer buffer;
-        VmaAllocation allocation;
+        VkBuffer buffer{};
+        VmaAllocation allocation{};
     };
 
   public:
     Mesh() = default;
-    Mesh(DrawPrimitive _primitive, std::shared_ptr<Device> _device, std::span<const Vertex> _vertices = {}, std::span<std::uint16_t> _indices = {});
+
+    // any contiguous range of vertices of a VertexLayout, 32 bit indices are narrowed to 16 bits whenever they all fit
+    template <std::ranges::contiguous_range Vertices, std::ranges::contiguous_range Indices = std::span<const std::uint16_t>>
+        requires VertexLayout<std::ranges::range_value_t<Vertices>> && MeshIndex<std::ranges::range_value_t<Indices>>
+    Mesh(DrawPrimitive _primitive, std::shared_ptr<Device> _device, const Vertices &_vertices, const Indices &_indices = {})
+        : Mesh(_primitive, std::move(_device), std::as_bytes(std::span(_vertices)), ::getVertexInput<std::ranges::range_value_t<Vertices>>(), std::span(_indices)) {}
+
+    // draws a range of buffers owned by someone else, meshes sharing their buffers are batched into the same indirect draw
+    // the vertex input must outlive the mesh, e.g. getVertexInput(), and meshes sharing a vertex buffer must share its dequantization
+    Mesh(
+        std::shared_ptr<Device> _device, AllocatedBuffer vertex_buffer, AllocatedBuffer index_buffer, const MeshRange &range, const MeshBounds &_bounds,
+        const VertexInputDescription &_vertex_input = ::getVertexInput<Vertex>(), VkIndexType _index_type = VK_INDEX_TYPE_UINT16,
+        const VertexDequantization &_dequantization = {});
 
     virtual ~Mesh() = default;
 
@@ -45,6 +151,18 @@ class Mesh {
     Mesh(Mesh &&) noexcept = default;
     Mesh &operator=(Mesh &&) noexcept = default;
 
+    // uploads a file cooked with writeMeshFile(), copied from its mapping straight into staging memory
+    // the file must be laid out like one of the engine's vertex types
+    [[nodiscard]] static Mesh load(std::shared_ptr<Device> device, std::string_view filepath);
+
+    // quantizes the vertices relative to their bounds before the upload, NONE uploads them as they are
+    [[nodiscard]] static Mesh quantized(
+        DrawPrimitive primitive, std::shared_ptr<Device> device, std::span<const Vertex> vertices, std::span<const std::uint16_t> indices,
+        VertexQuantization quantization);
+    [[nodiscard]] static Mesh quantized(
+        DrawPrimitive primitive, std::shared_ptr<Device> device, std::span<const Vertex> vertices, std::span<const std::uint32_t> indices,
+        VertexQuantization quantization);
+
     void bind(const CommandBuffer &cmd) const;
 
   public:
@@ -54,20 +172,53 @@ class Mesh {
     [[nodiscard]] const auto &getIndexBuffer() const { return indexBuffer; }
     [[nodiscard]] auto &getIndexBuffer() { return indexBuffer; }
 
-    [[nodiscard]] std::span<const Vertex> getVertices() const { return vertices; }
-    [[nodiscard]] std::span<Vertex> getVertices() { return vertices; }
+    // the geometry only lives on the gpu
+    [[nodiscard]] std::uint32_t getVertexCount() const { return vertex_count; }
+    [[nodiscard]] std::uint32_t getIndexCount() const { return index_count; }
+
+    // to draw with, the buffers are bound from their start
+    [[nodiscard]] std::uint32_t getFirstIndex() const { return first_index; }
+    [[nodiscard]] std::int32_t getVertexOffset() const { return vertex_offset; }
+
+    // a pipeline drawing the mesh must be built with this vertex input
+    [[nodiscard]] const VertexInputDescription &getVertexInput() const { return *vertex_input; }
+    [[nodiscard]] VkIndexType getIndexType() const { return index_type; }
 
-    [[nodiscard]] std::span<const std::uint16_t> getIndices() const { return indices; }
-    [[nodiscard]] std::span<std::uint16_t> getIndices() { return indices; }
+    // bounds are in model space even for quantized vertices
+    [[nodiscard]] const MeshBounds &getBounds() const { return bounds; }
+    // identity unless the vertices are quantized
+    [[nodiscard]] const VertexDequantization &getDequantization() const { return dequantization; }
 
     DrawPrimitive primitive;
 
+  private:
+    Mesh(
+        DrawPrimitive _primitive, std::shared_ptr<Device> _device, std::span<const std::byte> vertex_data, const VertexInputDescription &_vertex_input,
+        std::span<const std::uint16_t> _indices);
+    Mesh(
+        DrawPrimitive _primitive, std::shared_ptr<Device> _device, std::span<const std::byte> vertex_data, const VertexInputDescription &_vertex_input,
+        std::span<const std::uint32_t> _indices);
+
+    void upload(std::span<const std::byte> vertex_data, std::span<const std::byte> index_data);
+
+    template <MeshIndex I>
+    [[nodiscard]] static Mesh quantize(
+        DrawPrimitive primitive, std::shared_ptr<Device> device, std::span<const Vertex> vertices, std::span<const I> indices, VertexQuantization quantization);
+
   private:
     std::shared_ptr<Device> device;
 
+    const VertexInputDescription *vertex_input = &::getVertexInput<Vertex>();
+
     AllocatedBuffer vertexBuffer;
-    std::vector<Vertex> vertices;
+    std::uint32_t vertex_count = 0;
+    std::int32_t vertex_offset = 0;
 
     AllocatedBuffer indexBuffer;
-    std::vector<std::uint16_t> indices;
+    std::uint32_t index_count = 0;
+    std::uint32_t first_index = 0;
+    VkIndexType index_type = VK_INDEX_TYPE_UINT16;
+
+    MeshBounds bounds;
+    VertexDequantization dequantization;
 };
@@ -0,0 +1,362 @@
+#include "renderer/graphics/ressources/Model.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <exception>
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+
+#include "io/Gltf.hpp"
+#include "jobs/JobSystem.hpp"
+#include "renderer/Device.hpp"
+#include "renderer/graphics/ressources/Buffer.hpp"
+#include "renderer/sync/CommandBuffer.hpp"
+
+namespace {
+    // converted vertices and indices go through these to the staging buffer, the model is never held whole in a temporary vector
+    constexpr std::uint32_t vertex_chunk_size = 1024;
+    constexpr std::uint32_t index_chunk_size = 4096;
+
+    constexpr std::uint32_t no_accessor = std::numeric_limits<std::uint32_t>::max();
+
+    // the engine's Vertex made of a POSITION accessor and the base color of the primitive, quantized vertices also keep its NORMAL
+    struct VertexStream {
+        std::uint32_t position = 0;
+        std::uint32_t normal = no_accessor;
+        std::uint32_t color = no_accessor;
+        glm::vec3 color_factor{1.f};
+
+        std::uint32_t first_vertex = 0;
+        std::uint32_t vertex_count = 0;
+    };
+
+    // an index accessor, or the indices of a non-indexed primitive generated for its vertex stream
+    struct IndexStream {
+        std::uint32_t indices = no_accessor;
+
+        std::uint32_t first_index = 0;
+        std::uint32_t index_count = 0;
+        std::uint32_t max_index = 0;
+    };
+
+    struct PrimitiveRange {
+        std::uint32_t vertex_stream = 0;
+        std::uint32_t index_stream = 0;
+        std::optional<std::uint32_t> texture;
+        MeshBounds bounds;
+    };
+
+    MeshBounds makeBounds(glm::vec3 min, glm::vec3 max) {
+        MeshBounds bounds{min, max};
+        bounds.center = (min + max) * 0.5f;
+        bounds.radius = glm::length(max - bounds.center);
+        return bounds;
+    }
+
+    // POSITION accessors must have their min and max, a reader pass is only needed for files breaking that rule
+    MeshBounds computeBounds(const GltfAsset &asset, std::uint32_t position) {
+        const auto &accessor = asset.accessors[position];
+        if (accessor.min.size() == 3 && accessor.max.size() == 3) {
+            return makeBounds({accessor.min[0], accessor.min[1], accessor.min[2]}, {accessor.max[0], accessor.max[1], accessor.max[2]});
+        }
+
+        const auto reader = GltfAccessorReader(asset, position);
+        if (reader.getCount() == 0) {
+            return {};
+        }
+
+        const auto read = [&](std::uint32_t i) { return glm::vec3(reader.readFloat(i, 0), reader.readFloat(i, 1), reader.readFloat(i, 2)); };
+
+        auto min = read(0);
+        auto max = min;
+        for (std::uint32_t i = 1; i < reader.getCount(); ++i) {
+            min = glm::min(min, read(i));
+            max = glm::max(max, read(i));
+        }
+
+        return makeBounds(min, max);
+    }
+
+    template <typename V>
+    void writeVertices(const GltfAsset &asset, const VertexStream &stream, const VertexDequantization &dequantization, Buffer &staging) {
+        const auto positions = GltfAccessorReader(asset, stream.position);
+        const auto normals = stream.normal != no_accessor ? std::optional(GltfAccessorReader(asset, stream.normal)) : std::nullopt;
+        const auto colors = stream.color != no_accessor ? std::optional(GltfAccessorReader(asset, stream.color)) : std::nullopt;
+
+        std::array<V, vertex_chunk_size> chunk;
+        for (std::uint32_t first = 0; first < stream.vertex_count; first += vertex_chunk_size) {
+            const auto count = std::min(vertex_chunk_size, stream.vertex_count - first);
+
+            for (std::uint32_t i = 0; i < count; ++i) {
+                const auto vertex = first + i;
+
+                const glm::vec3 position{positions.readFloat(vertex, 0), positions.readFloat(vertex, 1), positions.readFloat(vertex, 2)};
+                auto color = stream.color_factor;
+                if (colors) {
+                    color *= glm::vec3(colors->readFloat(vertex, 0), colors->readFloat(vertex, 1), colors->readFloat(vertex, 2));
+                }
+
+                if constexpr (std::same_as<V, Vertex>) {
+                    chunk[i] = Vertex{.position = position, .color = color};
+                } else {
+                    // flat shaded primitives have no normals, they are given +z
+                    const auto normal = normals ? glm::vec3(normals->readFloat(vertex, 0), normals->readFloat(vertex, 1), normals->readFloat(vertex, 2))
+                                                : glm::vec3(0.f, 0.f, 1.f);
+                    chunk[i] = V::quantize(position, normal, glm::vec4(color, 1.f), dequantization);
+                }
+            }
+
+            const auto offset = (static_cast<VkDeviceSize>(stream.first_vertex) + first) * sizeof(V);
+            staging.write(std::as_bytes(std::span(chunk).first(count)), offset);
+        }
+    }
+
+    template <MeshIndex T>
+    void writeIndices(const GltfAsset &asset, IndexStream &stream, Buffer &staging, VkDeviceSize index_data_offset) {
+        const auto indices = stream.indices != no_accessor ? std::optional(GltfAccessorReader(asset, stream.indices)) : std::nullopt;
+
+        std::array<T, index_chunk_size> chunk;
+        for (std::uint32_t first = 0; first < stream.index_count; first += index_chunk_size) {
+            const auto count = std::min(index_chunk_size, stream.index_count - first);
+
+            for (std::uint32_t i = 0; i < count; ++i) {
+                const auto index = indices ? indices->readIndex(first + i) : first + i;
+
+                // an index too large for T is past the vertices of its stream, which is caught once every stream is written
+                chunk[i] = static_cast<T>(index);
+                stream.max_index = std::max(stream.max_index, index);
+            }
+
+            const auto offset = index_data_offset + (static_cast<VkDeviceSize>(stream.first_index) + first) * sizeof(T);
+            staging.write(std::as_bytes(std::span(chunk).first(count)), offset);
+        }
+    }
+}  // namespace
+
+Model Model::loadGltf(std::shared_ptr<Device> device, JobSystem &job_system, std::string_view filepath, VertexQuantization quantization) {
+    const auto asset = GltfAsset(filepath);
+
+    Model model;
+    model.textures.resize(asset.images.size());
+
+    // only the images used by a material are decoded, each by its own job
+    std::vector<bool> usedImages(asset.images.size(), false);
+    for (const auto &material : asset.materials) {
+        if (material.base_color_image) {
+            usedImages[*material.base_color_image] = true;
+        }
+    }
+
+    std::vector<std::optional<DecodedImage>> decodedImages(asset.images.size());
+    std::vector<std::exception_ptr> decodeErrors(asset.images.size());
+
+    JobCounter decoding;
+    for (std::uint32_t i = 0; i < asset.images.size(); ++i) {
+        if (!usedImages[i]) {
+            continue;
+        }
+
+        job_system.schedule(
+            [&, i] {
+                try {
+                    const auto &image = asset.images[i];
+                    decodedImages[i].emplace(image.path.empty() ? DecodedImage::fromMemory(image.data) : DecodedImage::fromFile(image.path));
+                } catch (...) {
+                    decodeErrors[i] = std::current_exception();
+                }
+            },
+            &decoding);
+    }
+
+    // the jobs reference the asset and the decoded images, they must be done before an exception leaves this scope
+    try {
+        std::vector<VertexStream> vertexStreams;
+        std::vector<IndexStream> indexStreams;
+        std::vector<PrimitiveRange> primitives;
+
+        std::map<std::tuple<std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t>, std::uint32_t> vertexStreamLookup;
+        std::map<std::pair<std::uint32_t, std::uint32_t>, std::uint32_t> indexStreamLookup;
+
+        std::uint32_t vertexCount = 0;
+        std::uint32_t indexCount = 0;
+
+        for (const auto &mesh : asset.meshes) {
+            model.groups.push_back(MeshGroup{mesh.name, static_cast<std::uint32_t>(primitives.size()), static_cast<std::uint32_t>(mesh.primitives.size())});
+
+            for (const auto &primitive : mesh.primitives) {
+                const auto position = primitive.findAttribute("POSITION");
+                if (primitive.mode != gltf_mode_triangles || !position) {
+                    throw std::runtime_error(fmt::format("glTF mesh {} has a primitive that isn't a list of positioned triangles!", mesh.name));
+                }
+
+                const auto color = primitive.findAttribute("COLOR_0").value_or(no_accessor);
+                // Vertex has no normal, they are only read for quantized vertices
+                const auto normal = quantization != VertexQuantization::NONE ? primitive.findAttribute("NORMAL").value_or(no_accessor) : no_accessor;
+
+                // the attributes are read for every position, a shorter accessor would be read past its buffer view
+                for (const auto &[semantic, accessor] : primitive.attributes) {
+                    if (asset.accessors.at(accessor).count != asset.accessors.at(*position).count) {
+                        throw std::runtime_error(fmt::format("glTF mesh {} has a {} attribute whose count differs from its positions!", mesh.name, semantic));
+                    }
+                }
+                const auto *material = primitive.material ? &asset.materials[*primitive.material] : nullptr;
+
+                // the base color factor is baked into the vertices, primitives with the same accessors but another material get their own stream
+                const auto vertexKey = std::tuple(*position, normal, color, primitive.material.value_or(no_accessor));
+                auto [vertexStream, newVertexStream] = vertexStreamLookup.try_emplace(vertexKey, static_cast<std::uint32_t>(vertexStreams.size()));
+                if (newVertexStream) {
+                    auto &stream = vertexStreams.emplace_back();
+                    stream.position = *position;
+                    stream.normal = normal;
+                    stream.color = color;
+                    stream.first_vertex = vertexCount;
+                    stream.vertex_count = asset.accessors[*position].count;
+
+                    if (material != nullptr) {
+                        stream.color_factor = {material->base_color_factor[0], material->base_color_factor[1], material->base_color_factor[2]};
+                    }
+
+                    vertexCount += stream.vertex_count;
+                }
+
+                // indices are relative to the vertex offset of the mesh, an index accessor is shared whatever the vertex stream
+                const auto indexKey = primitive.indices ? std::pair(*primitive.indices, 0u) : std::pair(no_accessor, vertexStream->second);
+                auto [indexStream, newIndexStream] = indexStreamLookup.try_emplace(indexKey, static_cast<std::uint32_t>(indexStreams.size()));
+                if (newIndexStream) {
+                    auto &stream = indexStreams.emplace_back();
+                    stream.indices = primitive.indices.value_or(no_accessor);
+                    stream.first_index = indexCount;
+                    stream.index_count = primitive.indices ? asset.accessors[*primitive.indices].count : vertexStreams[vertexStream->second].vertex_count;
+
+                    indexCount += stream.index_count;
+                }
+
+                primitives.push_back(PrimitiveRange{
+                    .vertex_stream = vertexStream->second,
+                    .index_stream = indexStream->second,
+                    .texture = material != nullptr ? material->base_color_image : std::nullopt,
+                    .bounds = computeBounds(asset, *position),
+                });
+            }
+        }
+
+        // the whole model shares one index buffer, it only uses 32 bit indices when one of its streams has more vertices than 16 bits address
+        const bool wideIndices = std::ranges::any_of(
+            vertexStreams, [](const VertexStream &stream) { return stream.vertex_count > std::numeric_limits<std::uint16_t>::max() + 1u; });
+        const auto indexType = wideIndices ? VK_INDEX_TYPE_UINT32 : VK_INDEX_TYPE_UINT16;
+
+        // the primitives share the vertex buffer and so its dequantization, positions are quantized over the box of the whole model
+        auto dequantization = VertexDequantization{};
+        const VertexInputDescription *vertexInput = &getVertexInput<Vertex>();
+        VkDeviceSize vertexStride = sizeof(Vertex);
+
+        if (quantization != VertexQuantization::NONE && !primitives.empty()) {
+            auto modelBounds = primitives.front().bounds;
+            for (const auto &primitive : primitives) {
+                modelBounds.min = glm::min(modelBounds.min, primitive.bounds.min);
+                modelBounds.max = glm::max(modelBounds.max, primitive.bounds.max);
+            }
+            dequantization = makeVertexDequantization(modelBounds);
+
+            vertexInput = quantization == VertexQuantization::SNORM16 ? &getVertexInput<QuantizedVertex>() : &getVertexInput<HalfQuantizedVertex>();
+            vertexStride = sizeof(QuantizedVertex);
+        }
+
+        const auto vertexSize = static_cast<VkDeviceSize>(vertexCount) * vertexStride;
+        const auto indexSize = static_cast<VkDeviceSize>(indexCount) * (wideIndices ? sizeof(std::uint32_t) : sizeof(std::uint16_t));
+
+        // empty primitives get no buffers, they draw nothing
+        Mesh::AllocatedBuffer vertexBuffer{nullptr, nullptr};
+        Mesh::AllocatedBuffer indexBuffer{nullptr, nullptr};
+
+        if (vertexSize > 0 && indexSize > 0) {
+            auto stagingBuffer = Buffer(
+                device, Buffer::Type::STAGING, vertexSize + indexSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY, VMA_ALLOCATION_CREATE_MAPPED_BIT);
+
+            for (const auto &stream : vertexStreams) {
+                switch (quantization) {
+                    case VertexQuantization::NONE:
+                        writeVertices<Vertex>(asset, stream, dequantization, stagingBuffer);
+                        break;
+
+                    case VertexQuantization::SNORM16:
+                        writeVertices<QuantizedVertex>(asset, stream, dequantization, stagingBuffer);
+                        break;
+
+                    case VertexQuantization::FLOAT16:
+                        writeVertices<HalfQuantizedVertex>(asset, stream, dequantization, stagingBuffer);
+                        break;
+                }
+            }
+            for (auto &stream : indexStreams) {
+                if (wideIndices) {
+                    writeIndices<std::uint32_t>(asset, stream, stagingBuffer, vertexSize);
+                } else {
+                    writeIndices<std::uint16_t>(asset, stream, stagingBuffer, vertexSize);
+                }
+            }
+
+            const auto vbo =
+                Buffer(device, Buffer::Type::VBO, vertexSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+            const auto ibo =
+                Buffer(device, Buffer::Type::IBO, indexSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+
+            device->immediateSubmit([&](const CommandBuffer &cmd) {
+                const VkBufferCopy vertexCopy{.srcOffset = 0, .dstOffset = 0, .size = vertexSize};
+                vkCmdCopyBuffer(cmd.getCommandBuffer(), stagingBuffer.getBuffer(), vbo.getBuffer(), 1, &vertexCopy);
+
+                const VkBufferCopy indexCopy{.srcOffset = vertexSize, .dstOffset = 0, .size = indexSize};
+                vkCmdCopyBuffer(cmd.getCommandBuffer(), stagingBuffer.getBuffer(), ibo.getBuffer(), 1, &indexCopy);
+            });
+
+            vertexBuffer = {vbo.getBuffer(), vbo.getAllocation()};
+            indexBuffer = {ibo.getBuffer(), ibo.getAllocation()};
+        }
+
+        model.meshes.reserve(primitives.size());
+        for (const auto &primitive : primitives) {
+            const auto &vertexStream = vertexStreams[primitive.vertex_stream];
+            const auto &indexStream = indexStreams[primitive.index_stream];
+
+            if (indexStream.index_count > 0 && indexStream.max_index >= vertexStream.vertex_count) {
+                throw std::runtime_error(fmt::format("glTF file {} has an index past the vertices of its primitive!", filepath));
+            }
+
+            // a primitive without vertices would still index the buffers of the others
+            const bool empty = vertexStream.vertex_count == 0;
+            const auto range = MeshRange{
+                .vertex_offset = static_cast<std::int32_t>(vertexStream.first_vertex),
+                .vertex_count = vertexStream.vertex_count,
+                .first_index = indexStream.first_index,
+                .index_count = empty ? 0 : indexStream.index_count,
+            };
+
+            model.meshes.emplace_back(device, vertexBuffer, indexBuffer, range, primitive.bounds, *vertexInput, indexType, dequantization);
+            model.mesh_textures.push_back(primitive.texture);
+        }
+    } catch (...) {
+        job_system.wait(decoding);
+        throw;
+    }
+
+    job_system.wait(decoding);
+
+    // uploads go through Device::immediateSubmit which must only be used by one thread
+    for (std::uint32_t i = 0; i < decodedImages.size(); ++i) {
+        if (decodeErrors[i]) {
+            std::rethrow_exception(decodeErrors[i]);
+        }
+        if (decodedImages[i]) {
+            model.textures[i] = std::make_unique<Image>(device, *decodedImages[i]);
+        }
+    }
+
+    return model;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "renderer/graphics/ressources/Image.hpp"
+#include "renderer/graphics/ressources/Mesh.hpp"
+#include "utility.hpp"
+
+class Device;
+class JobSystem;
+
+// Meshes and textures imported from a glTF 2.0 file.
+// Every primitive becomes a Mesh drawing its range of a vertex and an index buffer shared by the whole model, so they are batched together,
+// and a vertex or index accessor used by several primitives is converted and uploaded once.
+class Model final : public NoCopy {
+  public:
+    // the primitives of a glTF mesh, a range of getMeshes()
+    struct MeshGroup {
+        std::string name;
+        std::uint32_t first_mesh = 0;
+        std::uint32_t mesh_count = 0;
+    };
+
+  public:
+    // .gltf with its .bin files or .glb, the buffers are mapped and converted straight into staging memory
+    // images are decoded by jobs while the geometry is uploaded, then uploaded on the calling thread
+    // quantized vertices are relative to the box of the whole model and keep the normals, see Renderer::getQuantizedPipelineDesc()
+    [[nodiscard]] static Model loadGltf(
+        std::shared_ptr<Device> device, JobSystem &job_system, std::string_view filepath, VertexQuantization quantization = VertexQuantization::NONE);
+
+    [[nodiscard]] std::span<const Mesh> getMeshes() const { return meshes; }
+    [[nodiscard]] std::span<const MeshGroup> getGroups() const { return groups; }
+
+    // one per glTF image, nullptr for images no material uses
+    [[nodiscard]] const Image *getTexture(std::uint32_t index) const { return textures[index].get(); }
+    [[nodiscard]] std::uint32_t getTextureCount() const { return static_cast<std::uint32_t>(textures.size()); }
+
+    // base color texture of a mesh, its base color factor and vertex colors are already in its vertices
+    [[nodiscard]] std::optional<std::uint32_t> getMeshTexture(std::uint32_t mesh) const { return mesh_textures[mesh]; }
+
+  private:
+    std::vector<Mesh> meshes;
+    std::vector<std::optional<std::uint32_t>> mesh_textures;
+    std::vector<MeshGroup> groups;
+
+    std::vector<std::unique_ptr<Image>> textures;
+};
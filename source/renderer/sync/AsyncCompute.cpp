@@ -0,0 +1,131 @@
+#include "renderer/sync/AsyncCompute.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "renderer/Device.hpp"
+#include "renderer/graphics/ressources/Buffer.hpp"
+#include "renderer/sync/CommandBuffer.hpp"
+#include "renderer/sync/TimelineSemaphore.hpp"
+
+AsyncCompute::AsyncCompute(std::shared_ptr<Device> _device)
+    : device(std::move(_device)),
+      compute_family(device->getQueueFamilyIndex(QueueFamilyType::COMPUTE)),
+      graphics_family(device->getQueueFamilyIndex(QueueFamilyType::GRAPHICS)),
+      timeline(std::make_unique<TimelineSemaphore>(device)),
+      command_pools(device->getDevice(), compute_family) {}
+
+AsyncCompute::~AsyncCompute() {
+    timeline->wait(timeline->getPendingValue());
+    recycle();
+}
+
+std::uint64_t AsyncCompute::submit(const std::function<void(const CommandBuffer &)> &record, std::span<const Wait> waits) {
+    recycle();
+
+    const auto commands = command_pools.acquire();
+    const auto cmd = CommandBuffer(commands.command_buffer);
+
+    try {
+        cmd.begin();
+        record(cmd);
+        cmd.end();
+    } catch (...) {
+        command_pools.release(commands);
+        throw;
+    }
+
+    std::vector<VkSemaphore> waitSemaphores;
+    std::vector<std::uint64_t> waitValues;
+    std::vector<VkPipelineStageFlags> waitStages;
+    for (const auto &wait : waits) {
+        waitSemaphores.push_back(wait.semaphore);
+        waitValues.push_back(wait.value);
+        waitStages.push_back(wait.dst_stage);
+    }
+
+    const auto signalValue = timeline->nextValue();
+
+    VkTimelineSemaphoreSubmitInfo timelineInfo{};
+    timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+
+    timelineInfo.waitSemaphoreValueCount = static_cast<std::uint32_t>(waitValues.size());
+    timelineInfo.pWaitSemaphoreValues = waitValues.data();
+    timelineInfo.signalSemaphoreValueCount = 1;
+    timelineInfo.pSignalSemaphoreValues = &signalValue;
+
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = &timelineInfo;
+
+    submitInfo.waitSemaphoreCount = static_cast<std::uint32_t>(waitSemaphores.size());
+    submitInfo.pWaitSemaphores = waitSemaphores.data();
+    submitInfo.pWaitDstStageMask = waitStages.data();
+
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &timeline->getSemaphore();
+
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &cmd.getCommandBuffer();
+
+    if (device->submit(QueueFamilyType::COMPUTE, submitInfo, nullptr) != VK_SUCCESS) {
+        command_pools.release(commands);
+        // the value was handed out, signal it so that waiting on the timeline can't hang
+        timeline->signal(signalValue);
+        throw std::runtime_error("failed to submit async compute commands!");
+    }
+
+    in_flight.push_back({commands, signalValue});
+    return signalValue;
+}
+
+void AsyncCompute::recycle() {
+    const auto completed = std::remove_if(in_flight.begin(), in_flight.end(), [&](const InFlight &submission) {
+        if (!timeline->isComplete(submission.value)) {
+            return false;
+        }
+
+        command_pools.release(submission.commands);
+        return true;
+    });
+
+    in_flight.erase(completed, in_flight.end());
+}
+
+void AsyncCompute::releaseToGraphics(const CommandBuffer &cmd, const Buffer &buffer, VkPipelineStageFlags src_stage, VkAccessFlags src_access) const {
+    if (!isDedicated()) {
+        return;
+    }
+
+    // the semaphore makes the writes available, the destination half of a release is ignored
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = src_access;
+    barrier.dstAccessMask = 0;
+    barrier.srcQueueFamilyIndex = compute_family;
+    barrier.dstQueueFamilyIndex = graphics_family;
+    barrier.buffer = buffer.getBuffer();
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+
+    vkCmdPipelineBarrier(cmd.getCommandBuffer(), src_stage, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+}
+
+void AsyncCompute::acquireFromCompute(const CommandBuffer &cmd, const Buffer &buffer, VkPipelineStageFlags dst_stage, VkAccessFlags dst_access) const {
+    if (!isDedicated()) {
+        return;
+    }
+
+    // must match the release, the source half of an acquire is ignored
+    VkBufferMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = dst_access;
+    barrier.srcQueueFamilyIndex = compute_family;
+    barrier.dstQueueFamilyIndex = graphics_family;
+    barrier.buffer = buffer.getBuffer();
+    barrier.offset = 0;
+    barrier.size = VK_WHOLE_SIZE;
+
+    vkCmdPipelineBarrier(cmd.getCommandBuffer(), VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, dst_stage, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+}
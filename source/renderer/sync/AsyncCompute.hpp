@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "renderer/sync/CommandPoolRecycler.hpp"
+#include "utility.hpp"
+
+class Device;
+class Buffer;
+class CommandBuffer;
+class TimelineSemaphore;
+
+// Submits compute work to the compute queue so that it overlaps the graphics queue.
+// Every submission signals the next value of its own timeline, the graphics submission consuming the results waits for that value.
+class AsyncCompute final : public NoCopy, public NoMove {
+  public:
+    // a semaphore value the compute queue waits for before running the stages of dst_stage
+    struct Wait {
+        VkSemaphore semaphore = nullptr;
+        std::uint64_t value = 0;
+        VkPipelineStageFlags dst_stage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+    };
+
+  public:
+    explicit AsyncCompute(std::shared_ptr<Device> _device);
+    // waits for every submission to complete
+    ~AsyncCompute();
+
+    // records and submits to the compute queue with a recycled command buffer, returns the timeline value it signals
+    std::uint64_t submit(const std::function<void(const CommandBuffer &)> &record, std::span<const Wait> waits = {});
+
+    [[nodiscard]] const TimelineSemaphore &getTimeline() const { return *timeline; }
+    // false when compute shares the graphics family, submissions are then serialized with the graphics work
+    [[nodiscard]] bool isDedicated() const { return compute_family != graphics_family; }
+
+    // queue family ownership transfer of a buffer written on the compute queue and read on the graphics queue:
+    // the release is recorded at the end of the compute submission, the acquire in the graphics one waiting for it.
+    // Both are no-ops when compute shares the graphics family, buffers created with concurrent sharing don't need them.
+    void releaseToGraphics(const CommandBuffer &cmd, const Buffer &buffer, VkPipelineStageFlags src_stage, VkAccessFlags src_access) const;
+    void acquireFromCompute(const CommandBuffer &cmd, const Buffer &buffer, VkPipelineStageFlags dst_stage, VkAccessFlags dst_access) const;
+
+  private:
+    void recycle();
+
+  private:
+    std::shared_ptr<Device> device;
+    std::uint32_t compute_family;
+    std::uint32_t graphics_family;
+
+    std::unique_ptr<TimelineSemaphore> timeline;
+    CommandPoolRecycler command_pools;
+
+    struct InFlight {
+        CommandPoolRecycler::Entry commands;
+        std::uint64_t value;
+    };
+    std::vector<InFlight> in_flight;
+};
@@ -3,15 +3,16 @@
 #include <stdexcept>
 
 #include "renderer/Device.hpp"
+#include "renderer/graphics/ressources/Buffer.hpp"
 #include "renderer/sync/CommandPool.hpp"
 
-CommandBuffer::CommandBuffer(const Device &device, const CommandPool &command_pool, uint32_t commandBufferCount) {
+CommandBuffer::CommandBuffer(const Device &device, const CommandPool &command_pool, uint32_t commandBufferCount, VkCommandBufferLevel level) {
     VkCommandBufferAllocateInfo commandBufferInfo{};
     commandBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 
     commandBufferInfo.commandPool = command_pool.getPool();
     commandBufferInfo.commandBufferCount = commandBufferCount;
-    commandBufferInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    commandBufferInfo.level = level;
 
     if (vkAllocateCommandBuffers(device.getDevice(), &commandBufferInfo, &command_buffer) != VK_SUCCESS) {
         throw std::runtime_error("failed to create command buffers!");
@@ -28,3 +29,22 @@ void CommandBuffer::begin() const {
         throw std::runtime_error("failed to record command buffers!");
     }
 }
+
+void CommandBuffer::begin(const VkCommandBufferInheritanceInfo &inheritance) const {
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &inheritance;
+
+    if (vkBeginCommandBuffer(command_buffer, &beginInfo) != VK_SUCCESS) {
+        throw std::runtime_error("failed to record secondary command buffers!");
+    }
+}
+
+void CommandBuffer::execute(std::span<const VkCommandBuffer> secondaryCommandBuffers) const {
+    if (!secondaryCommandBuffers.empty()) {
+        vkCmdExecuteCommands(command_buffer, static_cast<std::uint32_t>(secondaryCommandBuffers.size()), secondaryCommandBuffers.data());
+    }
+}
+
+void CommandBuffer::dispatchIndirect(const Buffer &buffer, VkDeviceSize offset) const { vkCmdDispatchIndirect(command_buffer, buffer.getBuffer(), offset); }
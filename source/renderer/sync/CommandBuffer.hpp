@@ -1,21 +1,41 @@
 #pragma once
 
 #include <vulkan/vulkan_core.h>
+#include <cstdint>
 #include <memory>
+#include <span>
 
 #include "utility.hpp"
 
 class Device;
 class CommandPool;
+class Buffer;
 
 class CommandBuffer final {
   public:
-    explicit CommandBuffer(const Device &device, const CommandPool &command_pool, uint32_t commandBufferCount = 1);
+    explicit CommandBuffer(
+        const Device &device, const CommandPool &command_pool, uint32_t commandBufferCount = 1, VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+    // wraps a command buffer owned by a pool, e.g. one handed out by CommandPool::acquireCommandBuffer()
+    explicit CommandBuffer(VkCommandBuffer _command_buffer) : command_buffer(_command_buffer) {}
 
     void begin() const;
+    // secondary command buffers recorded inside the render pass and subpass described by inheritance
+    void begin(const VkCommandBufferInheritanceInfo &inheritance) const;
     void end() const { vkEndCommandBuffer(command_buffer); }
     void reset() const { vkResetCommandBuffer(command_buffer, 0); }
 
+    void execute(std::span<const VkCommandBuffer> secondaryCommandBuffers) const;
+
+    // the compute pipeline and its descriptor sets are bound by the caller
+    void dispatch(std::uint32_t group_count_x, std::uint32_t group_count_y = 1, std::uint32_t group_count_z = 1) const {
+        vkCmdDispatch(command_buffer, group_count_x, group_count_y, group_count_z);
+    }
+    // reads a VkDispatchIndirectCommand written at offset, e.g. by a previous dispatch
+    void dispatchIndirect(const Buffer &buffer, VkDeviceSize offset = 0) const;
+
+    // number of workgroups of local_size invocations needed to cover count invocations
+    [[nodiscard]] static constexpr std::uint32_t groupCount(std::uint32_t count, std::uint32_t local_size) { return (count + local_size - 1) / local_size; }
+
     const VkCommandBuffer &getCommandBuffer() const { return command_buffer; }
 
   private:
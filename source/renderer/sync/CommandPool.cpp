@@ -8,26 +8,44 @@ CommandPool::CommandPool(std::shared_ptr<Device> _device, QueueFamilyType type)
     VkCommandPoolCreateInfo commandPoolInfo{};
     commandPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
 
-    switch (type) {
-        case QueueFamilyType::GRAPHICS:
-            commandPoolInfo.queueFamilyIndex = device->findQueueFamilies(device->getPhysicalDevice()).graphics_family.value();
-            break;
-
-        case QueueFamilyType::PRESENT:
-            commandPoolInfo.queueFamilyIndex = device->findQueueFamilies(device->getPhysicalDevice()).present_family.value();
-            break;
-
-        default:
-            throw std::runtime_error("command pool got an incorect queue family type!");
-    }
+    commandPoolInfo.queueFamilyIndex = device->getQueueFamilyIndex(type);
 
     commandPoolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 
     if (vkCreateCommandPool(device->getDevice(), &commandPoolInfo, nullptr, &command_pool) != VK_SUCCESS) {
         throw std::runtime_error("failed to create command pool!");
-    } else {
-        DeletionQueue::push_function([dev = device->getDevice(), cp = command_pool]() { vkDestroyCommandPool(dev, cp, nullptr); });
     }
 }
 
+// frees every command buffer allocated from the pool as well
+CommandPool::~CommandPool() { vkDestroyCommandPool(device->getDevice(), command_pool, nullptr); }
+
 void CommandPool::reset(VkCommandPoolResetFlags flags) const { vkResetCommandPool(device->getDevice(), command_pool, flags); }
+
+VkCommandBuffer CommandPool::acquireCommandBuffer(VkCommandBufferLevel level) {
+    auto &freeBuffers = level == VK_COMMAND_BUFFER_LEVEL_PRIMARY ? free_primary_buffers : free_secondary_buffers;
+    if (!freeBuffers.empty()) {
+        const auto commandBuffer = freeBuffers.back();
+        freeBuffers.pop_back();
+        return commandBuffer;
+    }
+
+    VkCommandBufferAllocateInfo commandBufferInfo{};
+    commandBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+
+    commandBufferInfo.commandPool = command_pool;
+    commandBufferInfo.commandBufferCount = 1;
+    commandBufferInfo.level = level;
+
+    VkCommandBuffer commandBuffer = nullptr;
+    if (vkAllocateCommandBuffers(device->getDevice(), &commandBufferInfo, &commandBuffer) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create command buffers!");
+    }
+
+    return commandBuffer;
+}
+
+void CommandPool::releaseCommandBuffer(VkCommandBuffer command_buffer, VkCommandBufferLevel level) {
+    vkResetCommandBuffer(command_buffer, 0);
+    (level == VK_COMMAND_BUFFER_LEVEL_PRIMARY ? free_primary_buffers : free_secondary_buffers).push_back(command_buffer);
+}
@@ -3,6 +3,7 @@
 #include <vulkan/vulkan_core.h>
 
 #include <memory>
+#include <vector>
 
 #include "utility.hpp"
 
@@ -14,11 +15,19 @@ class Swapchain;
 class CommandPool : public NoCopy, public NoMove {
   public:
     CommandPool(std::shared_ptr<Device> _device, QueueFamilyType type);
+    ~CommandPool();
 
     void reset(VkCommandPoolResetFlags flags = 0) const;
     [[nodiscard]] VkCommandPool getPool() const { return command_pool; }
 
+    // released command buffers are reset and handed out again before any new one is allocated
+    [[nodiscard]] VkCommandBuffer acquireCommandBuffer(VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+    void releaseCommandBuffer(VkCommandBuffer command_buffer, VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+
   private:
     std::shared_ptr<Device> device;
     VkCommandPool command_pool = nullptr;
+
+    std::vector<VkCommandBuffer> free_primary_buffers;
+    std::vector<VkCommandBuffer> free_secondary_buffers;
 };
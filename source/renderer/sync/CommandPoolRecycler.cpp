@@ -0,0 +1,64 @@
+#include "renderer/sync/CommandPoolRecycler.hpp"
+
+#include <stdexcept>
+
+CommandPoolRecycler::CommandPoolRecycler(VkDevice _device, std::uint32_t _queue_family_index) : device(_device), queue_family_index(_queue_family_index) {}
+
+CommandPoolRecycler::~CommandPoolRecycler() {
+    for (const auto &entry : entries) {
+        vkDestroyCommandPool(device, entry.pool, nullptr);
+    }
+}
+
+CommandPoolRecycler::Entry CommandPoolRecycler::acquire() {
+    {
+        auto lock = std::scoped_lock(mutex);
+        if (!free_entries.empty()) {
+            const auto entry = free_entries.back();
+            free_entries.pop_back();
+            return entry;
+        }
+    }
+
+    Entry entry{};
+
+    VkCommandPoolCreateInfo commandPoolInfo{};
+    commandPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    commandPoolInfo.queueFamilyIndex = queue_family_index;
+    commandPoolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+    if (vkCreateCommandPool(device, &commandPoolInfo, nullptr, &entry.pool) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create command pool!");
+    }
+
+    VkCommandBufferAllocateInfo commandBufferInfo{};
+    commandBufferInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+
+    commandBufferInfo.commandPool = entry.pool;
+    commandBufferInfo.commandBufferCount = 1;
+    commandBufferInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+
+    if (vkAllocateCommandBuffers(device, &commandBufferInfo, &entry.command_buffer) != VK_SUCCESS) {
+        vkDestroyCommandPool(device, entry.pool, nullptr);
+        throw std::runtime_error("failed to create command buffers!");
+    }
+
+    auto lock = std::scoped_lock(mutex);
+    entries.push_back(entry);
+    // keeps release() from ever allocating
+    free_entries.reserve(entries.size());
+
+    return entry;
+}
+
+void CommandPoolRecycler::release(Entry entry) {
+    vkResetCommandPool(device, entry.pool, 0);
+
+    auto lock = std::scoped_lock(mutex);
+    free_entries.push_back(entry);
+}
+
+std::size_t CommandPoolRecycler::getCreatedCount() const {
+    auto lock = std::scoped_lock(mutex);
+    return entries.size();
+}
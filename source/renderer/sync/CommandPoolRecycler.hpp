@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "utility.hpp"
+
+// Transient command pools for one queue family, each coming with a primary command buffer.
+// Released pools are reset as a whole, which also resets their command buffer, and reused.
+class CommandPoolRecycler final : public NoCopy, public NoMove {
+  public:
+    struct Entry {
+        VkCommandPool pool = nullptr;
+        VkCommandBuffer command_buffer = nullptr;
+    };
+
+  public:
+    CommandPoolRecycler(VkDevice _device, std::uint32_t _queue_family_index);
+    ~CommandPoolRecycler();
+
+    [[nodiscard]] Entry acquire();
+    // the command buffer must have finished executing
+    void release(Entry entry);
+
+    [[nodiscard]] std::size_t getCreatedCount() const;
+
+  private:
+    VkDevice device;
+    std::uint32_t queue_family_index;
+
+    mutable std::mutex mutex;
+    std::vector<Entry> entries;
+    std::vector<Entry> free_entries;
+};
@@ -8,9 +8,11 @@
 
 class Device;
 
+// Takes a signaled fence from the device's fence pool, so a first wait returns before anything was submitted, and gives it back on destruction.
 class Fence final : public NoCopy, public NoMove {
   public:
     explicit Fence(std::shared_ptr<Device> _device);
+    ~Fence();
 
     void reset();
     void wait(uint64_t timeout);
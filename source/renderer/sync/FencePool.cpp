@@ -0,0 +1,62 @@
+#include "renderer/sync/FencePool.hpp"
+
+#include <stdexcept>
+
+FencePool::FencePool(VkDevice _device) : device(_device) {}
+
+FencePool::~FencePool() {
+    for (const auto fence : fences) {
+        vkDestroyFence(device, fence, nullptr);
+    }
+}
+
+VkFence FencePool::acquire(bool signaled) {
+    {
+        auto lock = std::scoped_lock(mutex);
+        if (!signaled && !free_fences.empty()) {
+            const auto fence = free_fences.back();
+            free_fences.pop_back();
+            return fence;
+        }
+
+        if (!free_signaled_fences.empty()) {
+            const auto fence = free_signaled_fences.back();
+            free_signaled_fences.pop_back();
+
+            if (!signaled) {
+                vkResetFences(device, 1, &fence);
+            }
+            return fence;
+        }
+    }
+
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    fenceInfo.flags = signaled ? VK_FENCE_CREATE_SIGNALED_BIT : 0;
+
+    VkFence fence = nullptr;
+    if (vkCreateFence(device, &fenceInfo, nullptr, &fence) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create fence!");
+    }
+
+    auto lock = std::scoped_lock(mutex);
+    fences.push_back(fence);
+    // keeps release() from ever allocating
+    free_fences.reserve(fences.size());
+    free_signaled_fences.reserve(fences.size());
+
+    return fence;
+}
+
+void FencePool::release(VkFence fence) {
+    // nothing is pending on it anymore, so it is either signaled or was reset and never submitted again
+    const bool signaled = vkGetFenceStatus(device, fence) == VK_SUCCESS;
+
+    auto lock = std::scoped_lock(mutex);
+    (signaled ? free_signaled_fences : free_fences).push_back(fence);
+}
+
+std::size_t FencePool::getCreatedCount() const {
+    auto lock = std::scoped_lock(mutex);
+    return fences.size();
+}
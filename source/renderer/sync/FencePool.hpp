@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <mutex>
+#include <vector>
+
+#include "utility.hpp"
+
+// Hands out fences in the requested state, released fences are kept by state and reused instead of being destroyed.
+class FencePool final : public NoCopy, public NoMove {
+  public:
+    explicit FencePool(VkDevice _device);
+    ~FencePool();
+
+    // an unsignaled request may reset a signaled free fence, the host cannot signal one so a signaled request creates it when none is free
+    [[nodiscard]] VkFence acquire(bool signaled = false);
+    // the fence must not be waited on by a pending submission anymore
+    void release(VkFence fence);
+
+    [[nodiscard]] std::size_t getCreatedCount() const;
+
+  private:
+    VkDevice device;
+
+    mutable std::mutex mutex;
+    std::vector<VkFence> fences;
+    std::vector<VkFence> free_fences;
+    std::vector<VkFence> free_signaled_fences;
+};
@@ -1,17 +1,8 @@
 #include "renderer/sync/Semaphore.hpp"
 
-#include <stdexcept>
-
 #include "renderer/Device.hpp"
+#include "renderer/sync/SemaphorePool.hpp"
 
-Semaphore::Semaphore(const Device &device) {
-    VkSemaphoreCreateInfo semaphoreInfo{};
-    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-    semaphoreInfo.flags = 0;
+Semaphore::Semaphore(const Device &_device) : device(_device), semaphore(device.getSemaphorePool().acquire()) {}
 
-    if (vkCreateSemaphore(device.getDevice(), &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
-        throw std::runtime_error("failed to create semaphore!");
-    } else {
-        DeletionQueue::push_function([dev = device.getDevice(), sem = semaphore]() { vkDestroySemaphore(dev, sem, nullptr); });
-    }
-}
+Semaphore::~Semaphore() { device.getSemaphorePool().release(semaphore); }
@@ -6,12 +6,15 @@
 
 class Device;
 
+// Binary semaphore taken from the device's semaphore pool and given back on destruction.
 class Semaphore final : public NoCopy, public NoMove {
   public:
-    explicit Semaphore(const Device &device);
+    explicit Semaphore(const Device &_device);
+    ~Semaphore();
 
     [[nodiscard]] const VkSemaphore &getSemaphore() const { return semaphore; }
 
   private:
+    const Device &device;
     VkSemaphore semaphore = nullptr;
 };
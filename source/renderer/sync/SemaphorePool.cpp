@@ -0,0 +1,48 @@
+#include "renderer/sync/SemaphorePool.hpp"
+
+#include <stdexcept>
+
+SemaphorePool::SemaphorePool(VkDevice _device) : device(_device) {}
+
+SemaphorePool::~SemaphorePool() {
+    for (const auto semaphore : semaphores) {
+        vkDestroySemaphore(device, semaphore, nullptr);
+    }
+}
+
+VkSemaphore SemaphorePool::acquire() {
+    {
+        auto lock = std::scoped_lock(mutex);
+        if (!free_semaphores.empty()) {
+            const auto semaphore = free_semaphores.back();
+            free_semaphores.pop_back();
+            return semaphore;
+        }
+    }
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.flags = 0;
+
+    VkSemaphore semaphore = nullptr;
+    if (vkCreateSemaphore(device, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create semaphore!");
+    }
+
+    auto lock = std::scoped_lock(mutex);
+    semaphores.push_back(semaphore);
+    // keeps release() from ever allocating
+    free_semaphores.reserve(semaphores.size());
+
+    return semaphore;
+}
+
+void SemaphorePool::release(VkSemaphore semaphore) {
+    auto lock = std::scoped_lock(mutex);
+    free_semaphores.push_back(semaphore);
+}
+
+std::size_t SemaphorePool::getCreatedCount() const {
+    auto lock = std::scoped_lock(mutex);
+    return semaphores.size();
+}
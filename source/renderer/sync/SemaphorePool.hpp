@@ -0,0 +1,28 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <mutex>
+#include <vector>
+
+#include "utility.hpp"
+
+// Hands out binary semaphores, released semaphores are reused instead of being destroyed.
+class SemaphorePool final : public NoCopy, public NoMove {
+  public:
+    explicit SemaphorePool(VkDevice _device);
+    ~SemaphorePool();
+
+    [[nodiscard]] VkSemaphore acquire();
+    // the semaphore must be unsignaled, with no pending signal or wait operation left
+    void release(VkSemaphore semaphore);
+
+    [[nodiscard]] std::size_t getCreatedCount() const;
+
+  private:
+    VkDevice device;
+
+    mutable std::mutex mutex;
+    std::vector<VkSemaphore> semaphores;
+    std::vector<VkSemaphore> free_semaphores;
+};
@@ -0,0 +1,79 @@
+#include "renderer/sync/TimelineSemaphore.hpp"
+
+#include <stdexcept>
+
+#include "renderer/Device.hpp"
+
+namespace {
+    std::uint64_t raiseTo(std::atomic<std::uint64_t> &target, std::uint64_t value) {
+        auto current = target.load(std::memory_order_relaxed);
+        while (current < value && !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+        return std::max(current, value);
+    }
+}  // namespace
+
+TimelineSemaphore::TimelineSemaphore(std::shared_ptr<Device> _device, std::uint64_t initial_value)
+    : device(std::move(_device)), pending_value(initial_value), completed_value(initial_value) {
+    VkSemaphoreTypeCreateInfo typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = initial_value;
+
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+    semaphoreInfo.flags = 0;
+
+    if (vkCreateSemaphore(device->getDevice(), &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
+        throw std::runtime_error("failed to create timeline semaphore!");
+    }
+}
+
+TimelineSemaphore::~TimelineSemaphore() { vkDestroySemaphore(device->getDevice(), semaphore, nullptr); }
+
+std::uint64_t TimelineSemaphore::getCompletedValue() const {
+    std::uint64_t value = 0;
+    vkGetSemaphoreCounterValue(device->getDevice(), semaphore, &value);
+
+    // other threads may have observed a greater value in the meantime
+    return raiseTo(completed_value, value);
+}
+
+bool TimelineSemaphore::isComplete(std::uint64_t value) const { return value <= completed_value.load(std::memory_order_relaxed) || value <= getCompletedValue(); }
+
+bool TimelineSemaphore::wait(std::uint64_t value, std::uint64_t timeout) const {
+    if (value <= completed_value.load(std::memory_order_relaxed)) {
+        return true;
+    }
+
+    VkSemaphoreWaitInfo waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &semaphore;
+    waitInfo.pValues = &value;
+
+    const auto result = vkWaitSemaphores(device->getDevice(), &waitInfo, timeout);
+    if (result == VK_TIMEOUT) {
+        return false;
+    }
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("failed to wait for timeline semaphore!");
+    }
+
+    raiseTo(completed_value, value);
+    return true;
+}
+
+void TimelineSemaphore::signal(std::uint64_t value) {
+    VkSemaphoreSignalInfo signalInfo{};
+    signalInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SIGNAL_INFO;
+
+    signalInfo.semaphore = semaphore;
+    signalInfo.value = value;
+
+    if (vkSignalSemaphore(device->getDevice(), &signalInfo) != VK_SUCCESS) {
+        throw std::runtime_error("failed to signal timeline semaphore!");
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+#include "utility.hpp"
+
+class Device;
+
+// Vulkan 1.2 timeline semaphore, every submission signals the next value of a single monotonically increasing counter.
+// The cpu can poll or wait for any value instead of keeping one fence per submission.
+class TimelineSemaphore final : public NoCopy, public NoMove {
+  public:
+    explicit TimelineSemaphore(std::shared_ptr<Device> _device, std::uint64_t initial_value = 0);
+    ~TimelineSemaphore();
+
+    // reserves the value the next submission will signal
+    [[nodiscard]] std::uint64_t nextValue() { return pending_value.fetch_add(1, std::memory_order_relaxed) + 1; }
+
+    // last value handed out by nextValue(), reached once every submission made so far has completed
+    [[nodiscard]] std::uint64_t getPendingValue() const { return pending_value.load(std::memory_order_relaxed); }
+
+    // queries the gpu, prefer isComplete() which skips the query for values already known to be reached
+    [[nodiscard]] std::uint64_t getCompletedValue() const;
+    [[nodiscard]] bool isComplete(std::uint64_t value) const;
+
+    // returns false if the timeout expired before the value was reached
+    bool wait(std::uint64_t value, std::uint64_t timeout = std::numeric_limits<std::uint64_t>::max()) const;
+    void signal(std::uint64_t value);
+
+    [[nodiscard]] const VkSemaphore &getSemaphore() const { return semaphore; }
+
+  private:
+    std::shared_ptr<Device> device;
+    VkSemaphore semaphore = nullptr;
+
+    std::atomic<std::uint64_t> pending_value;
+    mutable std::atomic<std::uint64_t> completed_value;
+};
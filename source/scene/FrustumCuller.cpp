@@ -0,0 +1,136 @@
+#include "scene/FrustumCuller.hpp"
+
+#include <cassert>
+#include <cmath>
+
+#include "jobs/JobSystem.hpp"
+#include "math/MatrixSimd.hpp"
+
+namespace {
+    // below this many spheres scheduling jobs costs more than testing them on the calling thread
+    constexpr std::uint32_t parallel_threshold = 4096;
+    constexpr std::uint32_t batch_size = 1024;
+
+    bool isVisible(const Frustum &frustum, float x, float y, float z, float radius) {
+        for (std::size_t plane = 0; plane < 6; ++plane) {
+            if (frustum.normal_x[plane] * x + frustum.normal_y[plane] * y + frustum.normal_z[plane] * z + frustum.distance[plane] < -radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+}  // namespace
+
+Frustum Frustum::fromViewProjection(const glm::mat4 &view_projection) {
+    // Gribb-Hartmann, every plane is a sum or a difference of two rows of the matrix
+    const auto row = [&](glm::length_t index) { return glm::vec4(view_projection[0][index], view_projection[1][index], view_projection[2][index], view_projection[3][index]); };
+
+    const std::array planes = {
+        row(3) + row(0),  // left
+        row(3) - row(0),  // right
+        row(3) + row(1),  // bottom
+        row(3) - row(1),  // top
+        row(3) + row(2),  // near
+        row(3) - row(2),  // far
+    };
+
+    Frustum frustum;
+    for (std::size_t i = 0; i < planes.size(); ++i) {
+        const auto &plane = planes[i];
+        const float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+
+        frustum.normal_x[i] = plane.x / length;
+        frustum.normal_y[i] = plane.y / length;
+        frustum.normal_z[i] = plane.z / length;
+        frustum.distance[i] = plane.w / length;
+    }
+
+    return frustum;
+}
+
+void BoundingSpheres::resize(std::size_t count) {
+    center_x.resize(count);
+    center_y.resize(count);
+    center_z.resize(count);
+    radius.resize(count);
+}
+
+void BoundingSpheres::set(std::size_t index, const glm::vec3 &center, float sphere_radius) {
+    center_x[index] = center.x;
+    center_y[index] = center.y;
+    center_z[index] = center.z;
+    radius[index] = sphere_radius;
+}
+
+FrustumCuller::FrustumCuller(std::shared_ptr<JobSystem> _job_system) : job_system(std::move(_job_system)) {}
+
+void FrustumCuller::cull(const Frustum &frustum, const BoundingSpheres &spheres, std::span<std::uint8_t> visible) const {
+    assert(visible.size() >= spheres.size());
+
+    const auto count = static_cast<std::uint32_t>(spheres.size());
+    if (count < parallel_threshold || !job_system) {
+        cullRange(frustum, spheres, visible, 0, count);
+        return;
+    }
+
+    // batches write disjoint ranges of visible, nothing is shared but the read-only inputs
+    JobCounter counter;
+    job_system->parallelFor(count, batch_size, [&](std::uint32_t first, std::uint32_t last) { cullRange(frustum, spheres, visible, first, last); }, counter);
+    job_system->wait(counter);
+}
+
+void FrustumCuller::cullRange(const Frustum &frustum, const BoundingSpheres &spheres, std::span<std::uint8_t> visible, std::size_t first, std::size_t last) {
+    std::size_t i = first;
+
+#if defined(MATH_SIMD_AVX)
+    for (; i + 8 <= last; i += 8) {
+        const __m256 x = _mm256_loadu_ps(&spheres.center_x[i]);
+        const __m256 y = _mm256_loadu_ps(&spheres.center_y[i]);
+        const __m256 z = _mm256_loadu_ps(&spheres.center_z[i]);
+        const __m256 negRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(&spheres.radius[i]));
+
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (std::size_t plane = 0; plane < 6; ++plane) {
+            __m256 distance = _mm256_mul_ps(x, _mm256_set1_ps(frustum.normal_x[plane]));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(y, _mm256_set1_ps(frustum.normal_y[plane])));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(z, _mm256_set1_ps(frustum.normal_z[plane])));
+            distance = _mm256_add_ps(distance, _mm256_set1_ps(frustum.distance[plane]));
+
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negRadius, _CMP_GE_OQ));
+        }
+
+        const int mask = _mm256_movemask_ps(inside);
+        for (std::size_t lane = 0; lane < 8; ++lane) {
+            visible[i + lane] = static_cast<std::uint8_t>((mask >> lane) & 1);
+        }
+    }
+#endif
+
+#if defined(MATH_SIMD_SSE)
+    for (; i + 4 <= last; i += 4) {
+        const __m128 x = _mm_loadu_ps(&spheres.center_x[i]);
+        const __m128 y = _mm_loadu_ps(&spheres.center_y[i]);
+        const __m128 z = _mm_loadu_ps(&spheres.center_z[i]);
+        const __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&spheres.radius[i]));
+
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (std::size_t plane = 0; plane < 6; ++plane) {
+            __m128 distance = _mm_mul_ps(x, _mm_set1_ps(frustum.normal_x[plane]));
+            distance = _mm_add_ps(distance, _mm_mul_ps(y, _mm_set1_ps(frustum.normal_y[plane])));
+            distance = _mm_add_ps(distance, _mm_mul_ps(z, _mm_set1_ps(frustum.normal_z[plane])));
+            distance = _mm_add_ps(distance, _mm_set1_ps(frustum.distance[plane]));
+
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+        }
+
+        const int mask = _mm_movemask_ps(inside);
+        for (std::size_t lane = 0; lane < 4; ++lane) {
+            visible[i + lane] = static_cast<std::uint8_t>((mask >> lane) & 1);
+        }
+    }
+#endif
+
+    for (; i < last; ++i) {
+        visible[i] = isVisible(frustum, spheres.center_x[i], spheres.center_y[i], spheres.center_z[i], spheres.radius[i]) ? 1 : 0;
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "utility.hpp"
+
+class JobSystem;
+
+// Six normalized planes with the normals pointing inwards, stored by component so one register holds a component of several spheres.
+struct Frustum {
+    std::array<float, 6> normal_x{};
+    std::array<float, 6> normal_y{};
+    std::array<float, 6> normal_z{};
+    std::array<float, 6> distance{};
+
+    // glm clip space, depth in [-1, 1]
+    [[nodiscard]] static Frustum fromViewProjection(const glm::mat4 &view_projection);
+};
+
+// World-space bounding spheres in structure-of-arrays layout.
+struct BoundingSpheres {
+    std::vector<float> center_x;
+    std::vector<float> center_y;
+    std::vector<float> center_z;
+    std::vector<float> radius;
+
+    void resize(std::size_t count);
+    void set(std::size_t index, const glm::vec3 &center, float sphere_radius);
+
+    [[nodiscard]] std::size_t size() const { return radius.size(); }
+};
+
+// Tests bounding spheres against a frustum, four or eight spheres per iteration depending on the instruction set.
+// Large lists are split across the job system.
+class FrustumCuller final : public NoCopy, public NoMove {
+  public:
+    explicit FrustumCuller(std::shared_ptr<JobSystem> _job_system);
+
+    // visible[i] is set to 1 when sphere i intersects the frustum, 0 otherwise
+    void cull(const Frustum &frustum, const BoundingSpheres &spheres, std::span<std::uint8_t> visible) const;
+
+    static void cullRange(const Frustum &frustum, const BoundingSpheres &spheres, std::span<std::uint8_t> visible, std::size_t first, std::size_t last);
+
+  private:
+    std::shared_ptr<JobSystem> job_system;
+};
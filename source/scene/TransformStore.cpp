@@ -0,0 +1,97 @@
+#include "scene/TransformStore.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace {
+    // translation * rotation * scale, written directly instead of multiplying three matrices
+    math::Matrix4f composeLocal(const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale) {
+        const float xx = rotation.x * rotation.x, yy = rotation.y * rotation.y, zz = rotation.z * rotation.z;
+        const float xy = rotation.x * rotation.y, xz = rotation.x * rotation.z, yz = rotation.y * rotation.z;
+        const float wx = rotation.w * rotation.x, wy = rotation.w * rotation.y, wz = rotation.w * rotation.z;
+
+        return math::Matrix4f({
+            {(1.f - 2.f * (yy + zz)) * scale.x, 2.f * (xy - wz) * scale.y, 2.f * (xz + wy) * scale.z, position.x},
+            {2.f * (xy + wz) * scale.x, (1.f - 2.f * (xx + zz)) * scale.y, 2.f * (yz - wx) * scale.z, position.y},
+            {2.f * (xz - wy) * scale.x, 2.f * (yz + wx) * scale.y, (1.f - 2.f * (xx + yy)) * scale.z, position.z},
+            {0.f, 0.f, 0.f, 1.f},
+        });
+    }
+}  // namespace
+
+TransformId TransformStore::create(TransformId parent) { return create(glm::vec3(0.f), glm::quat(1.f, 0.f, 0.f, 0.f), glm::vec3(1.f), parent); }
+
+TransformId TransformStore::create(const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale, TransformId parent) {
+    if (parent != invalid_transform && parent >= size()) {
+        throw std::runtime_error("parent transform does not exist!");
+    }
+
+    const auto id = static_cast<TransformId>(size());
+
+    positions.push_back(position);
+    rotations.push_back(rotation);
+    scales.push_back(scale);
+    parents.push_back(parent);
+    world_matrices.push_back(math::Matrix4f::identity());
+    dirty.push_back(1);
+
+    any_dirty = true;
+
+    return id;
+}
+
+void TransformStore::setPosition(TransformId id, const glm::vec3 &position) {
+    assert(id < size());
+    positions[id] = position;
+    dirty[id] = 1;
+    any_dirty = true;
+}
+
+void TransformStore::setRotation(TransformId id, const glm::quat &rotation) {
+    assert(id < size());
+    rotations[id] = rotation;
+    dirty[id] = 1;
+    any_dirty = true;
+}
+
+void TransformStore::setScale(TransformId id, const glm::vec3 &scale) {
+    assert(id < size());
+    scales[id] = scale;
+    dirty[id] = 1;
+    any_dirty = true;
+}
+
+void TransformStore::update() {
+    if (!any_dirty) {
+        return;
+    }
+
+    for (std::size_t i = 0; i < size(); ++i) {
+        const auto parent = parents[i];
+
+        // parents come first, their flag is already final when a child reads it
+        if (parent != invalid_transform) {
+            dirty[i] |= dirty[parent];
+        }
+
+        if (!dirty[i]) {
+            continue;
+        }
+
+        const auto local = composeLocal(positions[i], rotations[i], scales[i]);
+        world_matrices[i] = parent != invalid_transform ? world_matrices[parent] * local : local;
+    }
+
+    std::ranges::fill(dirty, 0);
+    any_dirty = false;
+}
+
+void TransformStore::reserve(std::size_t capacity) {
+    positions.reserve(capacity);
+    rotations.reserve(capacity);
+    scales.reserve(capacity);
+    parents.reserve(capacity);
+    world_matrices.reserve(capacity);
+    dirty.reserve(capacity);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/vec3.hpp>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "math/Matrix.hpp"
+
+using TransformId = std::uint32_t;
+inline constexpr TransformId invalid_transform = std::numeric_limits<TransformId>::max();
+
+// Transform components in structure-of-arrays layout, indexed by TransformId.
+// A parent is always created before its children, so one forward pass over the arrays resolves the whole hierarchy.
+class TransformStore final {
+  public:
+    [[nodiscard]] TransformId create(TransformId parent = invalid_transform);
+    [[nodiscard]] TransformId create(const glm::vec3 &position, const glm::quat &rotation = glm::quat(1.f, 0.f, 0.f, 0.f), const glm::vec3 &scale = glm::vec3(1.f),
+                                     TransformId parent = invalid_transform);
+
+    void setPosition(TransformId id, const glm::vec3 &position);
+    void setRotation(TransformId id, const glm::quat &rotation);
+    void setScale(TransformId id, const glm::vec3 &scale);
+
+    [[nodiscard]] const glm::vec3 &getPosition(TransformId id) const { return positions[id]; }
+    [[nodiscard]] const glm::quat &getRotation(TransformId id) const { return rotations[id]; }
+    [[nodiscard]] const glm::vec3 &getScale(TransformId id) const { return scales[id]; }
+    [[nodiscard]] TransformId getParent(TransformId id) const { return parents[id]; }
+
+    // recomputes the world matrix of every dirty transform and of all their descendants
+    void update();
+
+    [[nodiscard]] const math::Matrix4f &getWorldMatrix(TransformId id) const { return world_matrices[id]; }
+    // contiguous, so it can be copied as is into a gpu buffer, only valid after update()
+    [[nodiscard]] std::span<const math::Matrix4f> getWorldMatrices() const { return world_matrices; }
+
+    [[nodiscard]] std::size_t size() const { return positions.size(); }
+    void reserve(std::size_t capacity);
+
+  private:
+    std::vector<glm::vec3> positions;
+    std::vector<glm::quat> rotations;
+    std::vector<glm::vec3> scales;
+    std::vector<TransformId> parents;
+    std::vector<math::Matrix4f> world_matrices;
+
+    // one byte per transform instead of vector<bool> so the update pass reads it without bit twiddling
+    std::vector<std::uint8_t> dirty;
+    bool any_dirty = false;
+};
@@ -4,8 +4,14 @@
 
 #include <algorithm>
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <deque>
 #include <functional>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 struct NoCopy {
@@ -42,6 +48,54 @@ struct DeletionQueue final {
     }
 };
 
+// Holds deletors until the gpu has reached the value at which the object was retired, so objects still referenced by in-flight frames stay alive.
+class DeferredDeletionQueue final {
+  public:
+    void push_function(std::uint64_t retire_value, std::function<void()> &&function) { deletors.emplace_back(retire_value, std::move(function)); }
+
+    void collect(std::uint64_t completed_value) {
+        std::erase_if(deletors, [completed_value](const auto &deletor) {
+            if (deletor.first <= completed_value) {
+                std::invoke(deletor.second);
+                return true;
+            }
+            return false;
+        });
+    }
+
+    void flush() {
+        for (const auto &it : deletors) {
+            std::invoke(it.second);
+        }
+
+        deletors.clear();
+    }
+
+    [[nodiscard]] bool empty() const { return deletors.empty(); }
+
+  private:
+    std::vector<std::pair<std::uint64_t, std::function<void()>>> deletors;
+};
+
+namespace util {
+    inline constexpr std::uint64_t fnv1a_offset_basis = 14695981039346656037ull;
+    inline constexpr std::uint64_t fnv1a_prime = 1099511628211ull;
+
+    [[nodiscard]] constexpr std::uint64_t fnv1a(std::span<const std::byte> bytes, std::uint64_t hash = fnv1a_offset_basis) noexcept {
+        for (auto byte : bytes) {
+            hash ^= static_cast<std::uint64_t>(byte);
+            hash *= fnv1a_prime;
+        }
+        return hash;
+    }
+
+    template <typename T>
+        requires(std::is_trivially_copyable_v<T> && !std::ranges::range<T>)
+    [[nodiscard]] std::uint64_t fnv1a(const T &value, std::uint64_t hash = fnv1a_offset_basis) noexcept {
+        return fnv1a(std::as_bytes(std::span<const T, 1>(&value, 1)), hash);
+    }
+}  // namespace util
+
 namespace nostd {
     template <typename T>
     class observer_ptr {